@@ -9,6 +9,7 @@
 /***********************************************************************************************************************
    I N C L U D E S
  **********************************************************************************************************************/
+#include <Arduino.h>
 
 /***********************************************************************************************************************
    C L A S S E S
@@ -25,6 +26,8 @@ public:
     static const int StaticIpAddress              = 6;   /* EEPROM address static or dynamic IP address */
     static const int ButtonAdcValuesAddressValid  = 8;   /* EEPROM address for valid ADC data indicator. */
     static const int ButtonAdcValuesAddress       = 10;  /* EEPORM address for ADC data of buttons. */
+    static const int ConfigCrcAddress             = 24;  /* EEPROM address of CRC of configuration record. */
+    static const int WifiCacheAddress             = 26;  /* EEPROM address of data of last wifi connection. */
     static const int SelectedLocAddress           = 48;  /* EEPORM address for storage of selected locomotive. */
     static const int SsidNameAddress              = 50;  /* EEPROM Address of Ssid name */
     static const int SsidPasswordAddress          = 100; /* EEPROM Address of Ssid password */
@@ -33,5 +36,97 @@ public:
 	static const int EepIpSubnet                  = 173; /* EEPROM Address of IP subnet of Wmc. */
 	static const int EepIpGateway                 = 177; /* EEPROM Address of gateway ip. */
 	static const int locLibEepromAddressNumOfLocs = 181; /* EEPROM address num of locs. */
-	static const int locLibEepromAddressData      = 185; /* Start in EEPROM address loc data. */};
+	static const int locLibEepromAddressData      = 185; /* Start in EEPROM address loc data. */
+	static const int SpeedRampAddress             = 3776; /* EEPROM address of the speed ramp rates of the locs. */
+	static const int ConsistAddress               = 3832; /* EEPROM address of the consists. */
+	static const int ConfigCopyAddress            = 3904; /* EEPROM address of last known good configuration record. */
+	static const uint8_t SpeedRampLocs            = 8;    /* Locs with speed ramp rates in EEPROM. */
+	static const uint8_t ConsistEntries           = 4;    /* Consists in EEPROM. */
+	static const uint8_t ConsistMembers           = 3;    /* Members of a consist besides the lead loc. */
+
+    /**
+     * Image of the configuration part of the EEPROM, read in one pass at boot. The layout must match the addresses
+     * above, the CRC covers the whole record except the CRC itself.
+     */
+    struct config
+    {
+        uint8_t Reserved0;             /* Not used. */
+        uint8_t EepromVersion;         /* Version of data in EEPROM. */
+        uint8_t AcTypeControl;         /* "AC" type control. */
+        uint8_t Reserved3;             /* Not used. */
+        uint8_t EmergencyStopEnabled;  /* Emergency stop option. */
+        uint8_t Reserved5;             /* Not used. */
+        uint8_t StaticIp;              /* Static (1) or dynamic IP address. */
+        uint8_t Reserved7;             /* Not used. */
+        uint8_t ButtonAdcValuesValid;  /* Valid ADC data indicator. */
+        uint8_t Reserved9;             /* Not used. */
+        uint8_t ButtonAdcValues[14];   /* ADC data of buttons, high byte first. */
+        uint8_t Crc[2];                /* CRC of the record, low byte first. */
+        uint8_t WifiCacheValid;        /* Data of last wifi connection valid (1). */
+        uint8_t WifiChannel;           /* Channel of last wifi connection. */
+        uint8_t WifiBssid[6];          /* BSSID of access point of last wifi connection. */
+        uint8_t WifiIpAddress[4];      /* IP address obtained by DHCP at last wifi connection. */
+        uint8_t WifiGateway[4];        /* Gateway obtained by DHCP at last wifi connection. */
+        uint8_t WifiSubnet[4];         /* Subnet obtained by DHCP at last wifi connection. */
+        uint8_t WifiLeaseUses;         /* Connects done with the DHCP lease of last wifi connection. */
+        uint8_t Reserved47;            /* Not used. */
+        uint8_t SelectedLoc[2];        /* Selected locomotive. */
+        char SsidName[50];             /* Ssid name. */
+        char SsidPassword[65];         /* Ssid password. */
+        uint8_t IpAddressZ21[4];       /* IP address of Z21. */
+        uint8_t IpAddressWmc[4];       /* IP address of Wmc. */
+        uint8_t IpSubnet[4];           /* IP subnet of Wmc. */
+        uint8_t IpGateway[4];          /* Gateway IP. */
+    };
+
+    /**
+     * Speed ramp rates of the locs, rates as 8.8 fixed point speed steps per second.
+     */
+    struct speedRamp
+    {
+        uint8_t Valid;     /* Rates valid (1). */
+        uint8_t Reserved1; /* Not used. */
+        struct
+        {
+            uint16_t Address;    /* Loc address, 0 when not used. */
+            uint16_t Accelerate; /* Speed increase per second. */
+            uint16_t Brake;      /* Speed decrease per second. */
+        } Loc[SpeedRampLocs];
+    };
+
+    /**
+     * Consists, each a lead loc with its members.
+     */
+    struct consist
+    {
+        uint8_t Valid;     /* Consists valid (1). */
+        uint8_t Reserved1; /* Not used. */
+        struct
+        {
+            uint16_t Lead;        /* Lead loc address, 0 when not used. */
+            uint8_t FunctionsAll; /* Functions of the lead loc are applied to all members (1). */
+            uint8_t Members;      /* Number of members. */
+            struct
+            {
+                uint16_t Address; /* Member loc address. */
+                uint8_t Flip;     /* Member runs in the opposite direction (1). */
+                uint8_t Reserved; /* Not used. */
+            } Member[ConsistMembers];
+        } Entry[ConsistEntries];
+    };
+};
+
+static_assert(offsetof(EepCfg::config, EepromVersion) == EepCfg::EepromVersionAddress, "Config layout mismatch");
+static_assert(offsetof(EepCfg::config, StaticIp) == EepCfg::StaticIpAddress, "Config layout mismatch");
+static_assert(offsetof(EepCfg::config, ButtonAdcValues) == EepCfg::ButtonAdcValuesAddress, "Config layout mismatch");
+static_assert(offsetof(EepCfg::config, Crc) == EepCfg::ConfigCrcAddress, "Config layout mismatch");
+static_assert(offsetof(EepCfg::config, WifiCacheValid) == EepCfg::WifiCacheAddress, "Config layout mismatch");
+static_assert(offsetof(EepCfg::config, SelectedLoc) == EepCfg::SelectedLocAddress, "Config layout mismatch");
+static_assert(offsetof(EepCfg::config, SsidPassword) == EepCfg::SsidPasswordAddress, "Config layout mismatch");
+static_assert(offsetof(EepCfg::config, IpAddressZ21) == EepCfg::EepIpAddressZ21, "Config layout mismatch");
+static_assert(offsetof(EepCfg::config, IpGateway) == EepCfg::EepIpGateway, "Config layout mismatch");
+static_assert(sizeof(EepCfg::config) == EepCfg::locLibEepromAddressNumOfLocs, "Config layout mismatch");
+static_assert((EepCfg::ConfigCopyAddress + sizeof(EepCfg::config)) <= 4096, "Config copy outside EEPROM");
+static_assert((EepCfg::SpeedRampAddress + sizeof(EepCfg::speedRamp)) <= EepCfg::ConsistAddress, "Overlap");
+static_assert((EepCfg::ConsistAddress + sizeof(EepCfg::consist)) <= EepCfg::ConfigCopyAddress, "Overlap");
 #endif
@@ -7,7 +7,11 @@
 
 typedef tinyfsm::FsmList<wmcApp, wmcCv> fsm_list;
 
-/* wrapper to fsm_list::dispatch() */
-template <typename E> void send_event(E const& event) { fsm_list::template dispatch<E>(event); }
+/* wrapper to fsm_list::dispatch(), Z21 data queued while handling the event is transmitted afterwards. */
+template <typename E> void send_event(E const& event)
+{
+    fsm_list::template dispatch<E>(event);
+    wmcApp::WmcTxFlush();
+}
 
 #endif
@@ -0,0 +1,249 @@
+/***********************************************************************************************************************
+   @file   host_station.cpp
+   @brief  Z21 command station simulated on the host, answers the WMC through the UDP stand-in.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "host_station.h"
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+namespace host
+{
+station Station;
+}
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Append the XOR byte and the length.
+ */
+static std::vector<uint8_t> HostZ21Seal(std::vector<uint8_t> Record, bool Xor)
+{
+    uint8_t Check = 0;
+    size_t Index;
+
+    if (Xor == true)
+    {
+        for (Index = 4; Index < Record.size(); Index++)
+        {
+            Check ^= Record[Index];
+        }
+        Record.push_back(Check);
+    }
+
+    Record[0] = static_cast<uint8_t>(Record.size());
+    Record[1] = 0;
+
+    return (Record);
+}
+
+std::vector<uint8_t> host::Z21LocInfo(uint16_t Address, const stationLoc& Loc)
+{
+    std::vector<uint8_t> Record = { 0, 0, 0x40, 0x00, 0xEF, static_cast<uint8_t>(((Address >> 8) & 0x3F) | 0xC0),
+        static_cast<uint8_t>(Address), Loc.Steps,
+        static_cast<uint8_t>((Loc.Forward ? 0x80 : 0x00) | (Loc.Speed & 0x7F)),
+        static_cast<uint8_t>(((Loc.Functions & 0x01) << 4) | ((Loc.Functions >> 1) & 0x0F)),
+        static_cast<uint8_t>(Loc.Functions >> 5), static_cast<uint8_t>(Loc.Functions >> 13),
+        static_cast<uint8_t>(Loc.Functions >> 21) };
+
+    return (HostZ21Seal(Record, true));
+}
+
+std::vector<uint8_t> host::Z21Status(uint8_t Status)
+{
+    return (HostZ21Seal(std::vector<uint8_t>{ 0, 0, 0x40, 0x00, 0x62, 0x22, Status }, true));
+}
+
+std::vector<uint8_t> host::Z21PowerBroadcast(uint8_t Status)
+{
+    std::vector<uint8_t> Record;
+
+    if ((Status & 0x01) != 0)
+    {
+        Record = HostZ21Seal(std::vector<uint8_t>{ 0, 0, 0x40, 0x00, 0x81, 0x00 }, true);
+    }
+    else if ((Status & 0x02) != 0)
+    {
+        Record = HostZ21Seal(std::vector<uint8_t>{ 0, 0, 0x40, 0x00, 0x61, 0x00 }, true);
+    }
+    else
+    {
+        Record = HostZ21Seal(std::vector<uint8_t>{ 0, 0, 0x40, 0x00, 0x61, 0x01 }, true);
+    }
+
+    return (Record);
+}
+
+std::vector<uint8_t> host::Z21LocLibData(uint16_t Address, uint8_t Actual, uint8_t Total, const char* NamePtr)
+{
+    std::vector<uint8_t> Record = { 0, 0, 0xA9, 0x00, static_cast<uint8_t>(Address >> 8),
+        static_cast<uint8_t>(Address), Actual, Total };
+    size_t Index;
+
+    for (Index = 0; Index < 10; Index++)
+    {
+        Record.push_back((Index < strlen(NamePtr)) ? static_cast<uint8_t>(NamePtr[Index]) : 0);
+    }
+
+    return (HostZ21Seal(Record, false));
+}
+
+bool host::Z21IsDrive(const std::vector<uint8_t>& Record)
+{
+    return ((Record.size() == 10) && (Record[4] == 0xE4) && ((Record[5] & 0xF0) == 0x10));
+}
+
+bool host::Z21IsFunction(const std::vector<uint8_t>& Record)
+{
+    return ((Record.size() == 10) && (Record[4] == 0xE4) && (Record[5] == 0xF8));
+}
+
+bool host::Z21IsLocInfoGet(const std::vector<uint8_t>& Record)
+{
+    return ((Record.size() == 9) && (Record[4] == 0xE3) && (Record[5] == 0xF0));
+}
+
+bool host::Z21IsStatusGet(const std::vector<uint8_t>& Record)
+{
+    return ((Record.size() == 7) && (Record[4] == 0x21) && (Record[5] == 0x24));
+}
+
+bool host::Z21IsPowerOff(const std::vector<uint8_t>& Record)
+{
+    return ((Record.size() == 7) && (Record[4] == 0x21) && (Record[5] == 0x80));
+}
+
+bool host::Z21IsPowerOn(const std::vector<uint8_t>& Record)
+{
+    return ((Record.size() == 7) && (Record[4] == 0x21) && (Record[5] == 0x81));
+}
+
+bool host::Z21IsStop(const std::vector<uint8_t>& Record) { return ((Record.size() == 6) && (Record[4] == 0x80)); }
+
+bool host::Z21IsLocLibData(const std::vector<uint8_t>& Record) { return ((Record.size() >= 18) && (Record[2] == 0xA9)); }
+
+uint16_t host::Z21Address(const std::vector<uint8_t>& Record)
+{
+    return ((static_cast<uint16_t>(Record[6] & 0x3F) << 8) | Record[7]);
+}
+
+std::vector<std::vector<uint8_t> > host::Z21Records(const std::vector<uint8_t>& Datagram)
+{
+    std::vector<std::vector<uint8_t> > Records;
+    size_t Offset = 0;
+    size_t Length;
+
+    while ((Datagram.size() - Offset) >= 4)
+    {
+        Length = Datagram[Offset] | (Datagram[Offset + 1] << 8);
+        if ((Length < 4) || (Length > (Datagram.size() - Offset)))
+        {
+            break;
+        }
+        Records.push_back(std::vector<uint8_t>(Datagram.begin() + Offset, Datagram.begin() + Offset + Length));
+        Offset += Length;
+    }
+
+    return (Records);
+}
+
+/***********************************************************************************************************************
+ * Queue a reply, delivered after the latency.
+ */
+static void HostStationReply(const std::vector<uint8_t>& Record)
+{
+    host::datagram Datagram;
+
+    if (host::Station.Online == true)
+    {
+        Datagram.TimeUs = host::TimeUs + host::Station.LatencyUs;
+        Datagram.Data   = Record;
+        host::Udp.Rx.push_back(Datagram);
+    }
+}
+
+/***********************************************************************************************************************
+ * Handle a datagram of the WMC.
+ */
+static void HostStationRx(const host::datagram& Datagram)
+{
+    std::vector<std::vector<uint8_t> > Records = host::Z21Records(Datagram.Data);
+    host::stationRecord Received;
+    uint16_t Address;
+    uint8_t Function;
+
+    if ((host::Station.SourceCheck != NULL) && (host::Station.SourceCheck() != 0))
+    {
+        return;
+    }
+
+    for (const std::vector<uint8_t>& Record : Records)
+    {
+        Received.TimeUs   = Datagram.TimeUs;
+        Received.Datagram = static_cast<uint32_t>(host::Udp.Tx.size() - 1);
+        Received.Data     = Record;
+        host::Station.Records.push_back(Received);
+
+        if (host::Z21IsStatusGet(Record) == true)
+        {
+            HostStationReply(host::Z21Status(host::Station.Status));
+        }
+        else if (host::Z21IsLocInfoGet(Record) == true)
+        {
+            Address = host::Z21Address(Record);
+            HostStationReply(host::Z21LocInfo(Address, host::Station.Locs[Address]));
+        }
+        else if ((Record.size() == 7) && (Record[4] == 0x21) && ((Record[5] == 0x80) || (Record[5] == 0x81)))
+        {
+            host::Station.Status = (Record[5] == 0x81) ? 0x00 : 0x02;
+            HostStationReply(host::Z21PowerBroadcast(host::Station.Status));
+        }
+        else if (host::Z21IsStop(Record) == true)
+        {
+            host::Station.Status = 0x01;
+            HostStationReply(host::Z21PowerBroadcast(host::Station.Status));
+        }
+        else if (host::Z21IsDrive(Record) == true)
+        {
+            Address                             = host::Z21Address(Record);
+            host::Station.Locs[Address].Steps   = (Record[5] == 0x10) ? 0 : ((Record[5] == 0x12) ? 2 : 4);
+            host::Station.Locs[Address].Speed   = Record[8] & 0x7F;
+            host::Station.Locs[Address].Forward = ((Record[8] & 0x80) != 0);
+            HostStationReply(host::Z21LocInfo(Address, host::Station.Locs[Address]));
+        }
+        else if (host::Z21IsFunction(Record) == true)
+        {
+            Address  = host::Z21Address(Record);
+            Function = Record[8] & 0x3F;
+            switch (Record[8] & 0xC0)
+            {
+            case 0x00: host::Station.Locs[Address].Functions &= ~(1UL << Function); break;
+            case 0x40: host::Station.Locs[Address].Functions |= (1UL << Function); break;
+            default: host::Station.Locs[Address].Functions ^= (1UL << Function); break;
+            }
+            HostStationReply(host::Z21LocInfo(Address, host::Station.Locs[Address]));
+        }
+        else if (host::Z21IsLocLibData(Record) == true)
+        {
+            /* Loc data is echoed like a Z21 forwarding it to all clients. */
+            HostStationReply(Record);
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ */
+void host::StationStart(uint8_t Status, uint32_t LatencyUs)
+{
+    Station.Online      = true;
+    Station.LatencyUs   = LatencyUs;
+    Station.Status      = Status;
+    Station.Records.clear();
+    Udp.TxHook = HostStationRx;
+}
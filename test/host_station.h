@@ -0,0 +1,92 @@
+/**
+ **********************************************************************************************************************
+ * @file  host_station.h
+ * @brief Z21 command station simulated on the host, answers the WMC through the UDP stand-in.
+ ***********************************************************************************************************************
+ */
+#ifndef HOST_STATION_H
+#define HOST_STATION_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <map>
+#include <vector>
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+namespace host
+{
+/**
+ * Record received by the command station.
+ */
+struct stationRecord
+{
+    uint64_t TimeUs;           /* Time of the datagram. */
+    uint32_t Datagram;         /* Index of the datagram in Udp.Tx. */
+    std::vector<uint8_t> Data; /* The Z21 record. */
+};
+
+/**
+ * State of a loc in the command station.
+ */
+struct stationLoc
+{
+    uint8_t Speed       = 0;
+    bool Forward        = true;
+    uint8_t Steps       = 2; /* 0, 2 or 4 for 14, 28 or 128 speed steps. */
+    uint32_t Functions  = 0;
+};
+
+/**
+ * The command station.
+ */
+struct station
+{
+    bool Online;                            /* Replies are transmitted. */
+    uint32_t LatencyUs;                     /* Time between request and reply. */
+    uint8_t Status;                         /* Central state, 0x00 on, 0x01 stopped, 0x02 track power off. */
+    std::map<uint16_t, stationLoc> Locs;    /* Known locs. */
+    std::vector<stationRecord> Records;     /* All records received. */
+    uint32_t (*SourceCheck)(void);          /* Returns non zero when the datagram must be dropped, e.g. IP conflict. */
+};
+
+extern station Station;
+
+/**
+ * Attach the command station to the UDP stand-in, known locs and the source check are kept.
+ */
+void StationStart(uint8_t Status, uint32_t LatencyUs);
+
+/**
+ * Z21 records as transmitted by a command station.
+ */
+std::vector<uint8_t> Z21LocInfo(uint16_t Address, const stationLoc& Loc);
+std::vector<uint8_t> Z21Status(uint8_t Status);
+std::vector<uint8_t> Z21PowerBroadcast(uint8_t Status);
+std::vector<uint8_t> Z21LocLibData(uint16_t Address, uint8_t Actual, uint8_t Total, const char* NamePtr);
+
+/**
+ * Record type checks on data transmitted by the WMC.
+ */
+bool Z21IsDrive(const std::vector<uint8_t>& Record);
+bool Z21IsFunction(const std::vector<uint8_t>& Record);
+bool Z21IsLocInfoGet(const std::vector<uint8_t>& Record);
+bool Z21IsStatusGet(const std::vector<uint8_t>& Record);
+bool Z21IsPowerOff(const std::vector<uint8_t>& Record);
+bool Z21IsPowerOn(const std::vector<uint8_t>& Record);
+bool Z21IsStop(const std::vector<uint8_t>& Record);
+bool Z21IsLocLibData(const std::vector<uint8_t>& Record);
+uint16_t Z21Address(const std::vector<uint8_t>& Record);
+
+/**
+ * Split a datagram in its Z21 records.
+ */
+std::vector<std::vector<uint8_t> > Z21Records(const std::vector<uint8_t>& Datagram);
+}
+
+#endif
@@ -0,0 +1,256 @@
+/**
+ **********************************************************************************************************************
+ * @file  host_test.h
+ * @brief Checks, the main loop of the sketch and a boot into loc control for the host tests.
+ ***********************************************************************************************************************
+ */
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include "eep_cfg.h"
+#include "fsmlist.hpp"
+#include "host_station.h"
+#include <EEPROM.h>
+#include <chrono>
+#include <stdio.h>
+
+/***********************************************************************************************************************
+ * D E F I N E S
+ **********************************************************************************************************************/
+#define CHECK(Condition)                                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(Condition))                                                                                              \
+        {                                                                                                              \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #Condition);                                       \
+            host::Failures()++;                                                                                        \
+        }                                                                                                              \
+    } while (0)
+
+#define CHECK_EQUAL(Expected, Actual)                                                                                  \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        long long ExpectedValue = static_cast<long long>(Expected);                                                    \
+        long long ActualValue   = static_cast<long long>(Actual);                                                      \
+        if (ExpectedValue != ActualValue)                                                                              \
+        {                                                                                                              \
+            printf("%s:%d: check failed: %s == %s (%lld != %lld)\n", __FILE__, __LINE__, #Expected, #Actual,           \
+                ExpectedValue, ActualValue);                                                                           \
+            host::Failures()++;                                                                                        \
+        }                                                                                                              \
+    } while (0)
+
+/***********************************************************************************************************************
+ * F U N C T I O N S
+ **********************************************************************************************************************/
+
+namespace host
+{
+/**
+ * Number of failed checks.
+ */
+inline uint32_t& Failures(void)
+{
+    static uint32_t Count = 0;
+    return (Count);
+}
+
+/**
+ * Result of the test for main().
+ */
+inline int Result(const char* NamePtr)
+{
+    printf("%s: %s\n", NamePtr, (Failures() == 0) ? "passed" : "FAILED");
+    return ((Failures() == 0) ? 0 : 1);
+}
+
+/**
+ * Wall clock time in nsec for the benchmarks.
+ */
+inline uint64_t WallNs(void)
+{
+    return (static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+                                      .count()));
+}
+
+/**
+ * ADC values of the buttons used by the tests, index 6 is the not pressed reference.
+ */
+static const uint16_t AdcButtonValues[7] = { 10, 180, 350, 520, 690, 860, 1023 };
+
+/**
+ * CRC16-CCITT of the configuration record like the application computes it.
+ */
+inline uint16_t ConfigCrc(const EepCfg::config& Config)
+{
+    EepCfg::config Data = Config;
+    const uint8_t* DataPtr = reinterpret_cast<const uint8_t*>(&Data);
+    uint16_t Crc           = 0xFFFF;
+    size_t Index;
+    uint8_t Bit;
+
+    Data.Crc[0]                                      = 0;
+    Data.Crc[1]                                      = 0;
+    Data.AcTypeControl                               = 0;
+    Data.EmergencyStopEnabled                        = 0;
+    Data.SelectedLoc[0]                              = 0;
+    Data.SelectedLoc[1]                              = 0;
+    Data.SsidName[sizeof(Data.SsidName) - 1]         = '\0';
+    Data.SsidPassword[sizeof(Data.SsidPassword) - 1] = '\0';
+
+    for (Index = 0; Index < sizeof(Data); Index++)
+    {
+        Crc ^= static_cast<uint16_t>(DataPtr[Index]) << 8;
+        for (Bit = 0; Bit < 8; Bit++)
+        {
+            Crc = (Crc & 0x8000) ? ((Crc << 1) ^ 0x1021) : (Crc << 1);
+        }
+    }
+
+    return (Crc);
+}
+
+/**
+ * Valid configuration with learned buttons and DHCP.
+ */
+inline EepCfg::config ConfigDefault(void)
+{
+    EepCfg::config Config;
+    uint8_t Index;
+    uint16_t Crc;
+
+    memset(&Config, 0, sizeof(Config));
+    Config.EepromVersion        = EepCfg::EepromVersion;
+    Config.ButtonAdcValuesValid = 1;
+    for (Index = 0; Index < 7; Index++)
+    {
+        Config.ButtonAdcValues[Index * 2]       = AdcButtonValues[Index] >> 8;
+        Config.ButtonAdcValues[(Index * 2) + 1] = AdcButtonValues[Index] & 0xFF;
+    }
+    strcpy(Config.SsidName, "layout");
+    strcpy(Config.SsidPassword, "secret");
+    Config.IpAddressZ21[0] = 192;
+    Config.IpAddressZ21[1] = 168;
+    Config.IpAddressZ21[2] = 0;
+    Config.IpAddressZ21[3] = 111;
+
+    Crc           = ConfigCrc(Config);
+    Config.Crc[0] = Crc & 0xFF;
+    Config.Crc[1] = Crc >> 8;
+
+    return (Config);
+}
+
+/**
+ * Write a configuration to EEPROM as if it was stored before the boot.
+ */
+inline void ConfigWrite(const EepCfg::config& Config)
+{
+    EEPROM.put(0, Config);
+    EEPROM.commit();
+}
+
+/**
+ * Main loop of the sketch for the given time in msec: the periodic update events, the expired timers and the input
+ * events queued by the interrupts are dispatched by the 5 msec update.
+ */
+inline void Run(uint32_t Ms, void (*EachMsPtr)(void) = NULL)
+{
+    static uint32_t Tick = 0;
+    uint32_t Index;
+
+    for (Index = 0; Index < Ms; Index++)
+    {
+        TimeAdvance(1000);
+        Tick++;
+
+        if (EachMsPtr != NULL)
+        {
+            EachMsPtr();
+        }
+
+        if ((Tick % 5) == 0)
+        {
+            send_event(updateEvent5msec());
+        }
+        if ((Tick % 50) == 0)
+        {
+            send_event(updateEvent50msec());
+        }
+        if ((Tick % 100) == 0)
+        {
+            send_event(updateEvent100msec());
+        }
+        if ((Tick % 500) == 0)
+        {
+            send_event(updateEvent500msec());
+        }
+        if ((Tick % 3000) == 0)
+        {
+            send_event(updateEvent3sec());
+        }
+    }
+}
+
+/**
+ * Boot with a valid configuration and a command station with the given status, returns when loc control is
+ * reached or the time is up.
+ */
+inline bool Boot(uint8_t Status, uint32_t LatencyUs = 2000, uint32_t TimeoutMs = 10000)
+{
+    uint32_t Time = 0;
+
+    if (EEPROM.read(1) != EepCfg::EepromVersion)
+    {
+        ConfigWrite(ConfigDefault());
+    }
+
+    StationStart(Status, LatencyUs);
+    fsm_list::start();
+
+    while ((Time < TimeoutMs) && (tinyfsm::Fsm<wmcApp>::current_state_ptr != NULL))
+    {
+        Run(10);
+        Time += 10;
+        if (wmcApp::BootLogGet(0)->Time[wmcBootLog::drivable] != wmcBootLog::TIME_NOT_SET)
+        {
+            break;
+        }
+    }
+
+    return (Time < TimeoutMs);
+}
+
+/**
+ * Pulse switch event as the interrupt of the sketch queues it.
+ */
+inline void PulseSwitch(pulseSwitchStatus Status, int8_t Delta)
+{
+    wmcApp::EventQueueGet().PushPulseSwitch(Delta, Status);
+}
+
+/**
+ * Count records transmitted by the WMC since the given record index.
+ */
+inline uint32_t Count(bool (*CheckPtr)(const std::vector<uint8_t>&), size_t From = 0)
+{
+    uint32_t Result = 0;
+    size_t Index;
+
+    for (Index = From; Index < Station.Records.size(); Index++)
+    {
+        if (CheckPtr(Station.Records[Index].Data) == true)
+        {
+            Result++;
+        }
+    }
+
+    return (Result);
+}
+}
+
+#endif
@@ -0,0 +1,129 @@
+/**
+ **********************************************************************************************************************
+ * @file  Arduino.h
+ * @brief Host stand-in of the Arduino core, time and inputs are controlled by the test.
+ ***********************************************************************************************************************
+ */
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/***********************************************************************************************************************
+ * T Y P E D  E F S  /  E N U M
+ **********************************************************************************************************************/
+typedef uint8_t byte;
+
+enum
+{
+    D3 = 0,
+    D4 = 2,
+    D2 = 4,
+    D1 = 5,
+    D6 = 12,
+    D7 = 13,
+    D5 = 14,
+    D8 = 15,
+    D0 = 16,
+    A0 = 17,
+    PIN_MAX
+};
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x00
+#define OUTPUT 0x01
+#define INPUT_PULLUP 0x02
+#define HEX 16
+#define DEC 10
+
+#ifndef ICACHE_RAM_ATTR
+#define ICACHE_RAM_ATTR
+#endif
+
+#define noInterrupts()
+#define interrupts()
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+unsigned long millis(void);
+unsigned long micros(void);
+int analogRead(uint8_t Pin);
+int digitalRead(uint8_t Pin);
+void pinMode(uint8_t Pin, uint8_t Mode);
+void delay(unsigned long Ms);
+void yield(void);
+
+/**
+ * Serial output is dropped unless echo is enabled by the test.
+ */
+class HardwareSerial
+{
+public:
+    template <typename T> void print(T, int = DEC) {}
+    template <typename T> void println(T, int = DEC) {}
+    void println(void) {}
+    int printf(const char* FormatPtr, ...);
+};
+
+extern HardwareSerial Serial;
+
+/**
+ * IP address, octet 0 in the lowest byte like the ESP8266 core.
+ */
+class IPAddress
+{
+public:
+    IPAddress() : m_Address(0) {}
+    IPAddress(uint32_t Address) : m_Address(Address) {}
+    IPAddress(uint8_t Octet0, uint8_t Octet1, uint8_t Octet2, uint8_t Octet3)
+        : m_Address(static_cast<uint32_t>(Octet0) | (static_cast<uint32_t>(Octet1) << 8)
+              | (static_cast<uint32_t>(Octet2) << 16) | (static_cast<uint32_t>(Octet3) << 24))
+    {
+    }
+    uint8_t operator[](int Index) const { return ((m_Address >> (Index * 8)) & 0xFF); }
+    operator uint32_t() const { return (m_Address); }
+
+private:
+    uint32_t m_Address;
+};
+
+/**
+ * RTC user memory survives a reset, kept in RAM by the host.
+ */
+class EspClass
+{
+public:
+    bool rtcUserMemoryRead(uint32_t Offset, uint32_t* DataPtr, size_t Size);
+    bool rtcUserMemoryWrite(uint32_t Offset, uint32_t* DataPtr, size_t Size);
+    uint32_t getChipId(void) { return (0x00C0FFEE); }
+};
+
+extern EspClass ESP;
+
+/**
+ * Controls of the host, used by the tests only.
+ */
+namespace host
+{
+extern uint64_t TimeUs;           /* Actual time in usec. */
+extern uint32_t TimeUsPerCall;    /* Time consumed by each micros() call, simulates a busy CPU. */
+extern int AnalogValue;           /* Value returned by analogRead() when no hook is set. */
+extern int (*AnalogHook)(void);   /* Returns the next ADC value, overrides AnalogValue. */
+extern uint32_t AnalogReads;      /* Number of analogRead() calls. */
+extern int DigitalValue[PIN_MAX]; /* Values returned by digitalRead(). */
+extern bool SerialEcho;           /* Print Serial.printf output on stdout. */
+
+void TimeAdvance(uint32_t Us);
+}
+
+#endif
@@ -0,0 +1,55 @@
+/**
+ **********************************************************************************************************************
+ * @file  EEPROM.h
+ * @brief Host stand-in of the ESP8266 EEPROM emulation, a RAM image written to "flash" on commit.
+ ***********************************************************************************************************************
+ */
+#ifndef EEPROM_H
+#define EEPROM_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class EEPROMClass
+{
+public:
+    static const size_t SIZE = 4096;
+
+    EEPROMClass();
+    void begin(size_t Size) { (void)Size; }
+    uint8_t read(int Address);
+    void write(int Address, uint8_t Data);
+    bool commit(void);
+    uint8_t* getDataPtr(void) { return (m_Data); }
+    size_t length(void) { return (SIZE); }
+
+    template <typename T> T& get(int Address, T& Data)
+    {
+        memcpy(&Data, &m_Data[Address], sizeof(T));
+        return (Data);
+    }
+
+    template <typename T> const T& put(int Address, const T& Data)
+    {
+        memcpy(&m_Data[Address], &Data, sizeof(T));
+        return (Data);
+    }
+
+    /* Host only: commits done, bytes changed in flash and the flash image. */
+    uint32_t Commits;
+    uint32_t BytesFlashed;
+    uint8_t Flash[SIZE];
+
+private:
+    uint8_t m_Data[SIZE];
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
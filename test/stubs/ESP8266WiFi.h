@@ -0,0 +1,75 @@
+/**
+ **********************************************************************************************************************
+ * @file  ESP8266WiFi.h
+ * @brief Host stand-in of the ESP8266 wifi station, association time and DHCP lease are set by the test.
+ ***********************************************************************************************************************
+ */
+#ifndef ESP8266WIFI_H
+#define ESP8266WIFI_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * T Y P E D  E F S  /  E N U M
+ **********************************************************************************************************************/
+enum WiFiMode_t
+{
+    WIFI_OFF,
+    WIFI_STA
+};
+
+enum wl_status_t
+{
+    WL_IDLE_STATUS,
+    WL_NO_SSID_AVAIL,
+    WL_CONNECTED,
+    WL_CONNECT_FAILED,
+    WL_DISCONNECTED
+};
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class ESP8266WiFiClass
+{
+public:
+    ESP8266WiFiClass();
+    bool mode(WiFiMode_t Mode);
+    bool config(IPAddress Ip, IPAddress Gateway, IPAddress Subnet, IPAddress Dns = IPAddress());
+    wl_status_t begin(const char* SsidPtr, const char* PasswordPtr = NULL, int32_t Channel = 0,
+        const uint8_t* BssidPtr = NULL, bool Connect = true);
+    wl_status_t status(void);
+    uint8_t* BSSID(void) { return (Bssid); }
+    int32_t channel(void) { return (Channel); }
+    IPAddress localIP(void);
+    IPAddress gatewayIP(void) { return (Gateway); }
+    IPAddress subnetMask(void) { return (Subnet); }
+    IPAddress dnsIP(uint8_t = 0) { return (Gateway); }
+    bool disconnect(bool = false);
+    bool persistent(bool) { return (true); }
+    bool setAutoReconnect(bool) { return (true); }
+
+    /* Host only: network as seen by the station. */
+    uint32_t ScanTime;      /* Association time with scan in msec. */
+    uint32_t FastTime;      /* Association time with channel and BSSID given in msec. */
+    uint8_t Bssid[6];       /* BSSID of the access point. */
+    int32_t Channel;        /* Channel of the access point. */
+    IPAddress DhcpIp;       /* Address handed out by the DHCP server. */
+    IPAddress Gateway;      /* Gateway of the network. */
+    IPAddress Subnet;       /* Subnet of the network. */
+    IPAddress StaticIp;     /* Address set by config(), 0 for DHCP. */
+    uint32_t Begins;        /* Number of begin() calls. */
+    uint32_t FastBegins;    /* Number of begin() calls with channel and BSSID. */
+    uint32_t DhcpRequests;  /* Number of connects done with DHCP. */
+    bool Started;           /* Association started. */
+    bool Fast;              /* Association started with channel and BSSID. */
+    uint32_t BeginTime;     /* Time of begin() in msec. */
+};
+
+extern ESP8266WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,31 @@
+/**
+ **********************************************************************************************************************
+ * @file  LocStorage.h
+ * @brief Host stand-in of the loc storage settings, written to the EEPROM image like the real library.
+ ***********************************************************************************************************************
+ */
+#ifndef LOCSTORAGE_H
+#define LOCSTORAGE_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class LocStorage
+{
+public:
+    void Init(void);
+    bool EmergencyOptionGet(void);
+    void EmergencyOptionSet(uint8_t Option);
+    void NumberOfLocsSet(uint8_t Number);
+    uint8_t NumberOfLocsGet(void);
+    void AcOptionSet(uint8_t Option);
+    void InvalidateAdc(void);
+};
+
+#endif
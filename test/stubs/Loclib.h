@@ -0,0 +1,100 @@
+/**
+ **********************************************************************************************************************
+ * @file  Loclib.h
+ * @brief Host stand-in of the loc library, locs are kept sorted on address in RAM.
+ ***********************************************************************************************************************
+ */
+#ifndef LOCLIB_H
+#define LOCLIB_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include "LocStorage.h"
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * T Y P E D  E F S  /  E N U M
+ **********************************************************************************************************************/
+enum direction
+{
+    directionForward,
+    directionBackWard
+};
+
+enum decoderSteps
+{
+    decoderStep14,
+    decoderStep28,
+    decoderStep128
+};
+
+struct LocLibData
+{
+    uint16_t Addres;
+    uint8_t Steps;
+    direction Dir;
+    uint8_t Speed;
+    uint8_t FunctionAssignment[5];
+    char Name[11];
+};
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class LocLib
+{
+public:
+    static const uint8_t LOCS_MAX = 64;
+
+    enum function
+    {
+        functionOn,
+        functionOff
+    };
+
+    enum action
+    {
+        storeAdd,
+        storeChange,
+        storeAddNoAutoSelect
+    };
+
+    void Init(LocStorage& Storage);
+    uint16_t GetActualLocAddress(void);
+    uint8_t GetActualSelectedLocIndex(void);
+    uint8_t GetNumberOfLocs(void);
+    uint16_t GetNextLoc(int8_t Delta);
+    void UpdateLocData(uint16_t Address);
+    uint16_t SpeedSet(int8_t Delta);
+    void SpeedUpdate(uint8_t Speed);
+    uint8_t SpeedGet(void);
+    void DirectionSet(direction Dir);
+    direction DirectionGet(void);
+    void DirectionToggle(void);
+    void DecoderStepsUpdate(decoderSteps Steps);
+    decoderSteps DecoderStepsGet(void);
+    uint8_t FunctionAssignedGet(uint8_t Index);
+    void FunctionToggle(uint8_t Function);
+    function FunctionStatusGet(uint8_t Function);
+    uint8_t CheckLoc(uint16_t Address);
+    bool StoreLoc(uint16_t Address, uint8_t* FunctionPtr, char* NamePtr, action Action);
+    void LocBubbleSort(void);
+    uint16_t limitLocAddress(uint16_t Address);
+    bool RemoveLoc(uint16_t Address);
+    void InitialLocStore(void);
+    LocLibData* LocGetAllDataByIndex(uint8_t Index);
+    char* GetLocName(void);
+
+    /* Host only: number of bubble sort passes. */
+    uint32_t SortPasses;
+
+private:
+    LocLibData m_Locs[LOCS_MAX];
+    uint8_t m_Number;
+    uint8_t m_Selected;
+    uint32_t m_Functions;
+};
+
+#endif
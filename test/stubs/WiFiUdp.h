@@ -0,0 +1,71 @@
+/**
+ **********************************************************************************************************************
+ * @file  WiFiUdp.h
+ * @brief Host stand-in of the ESP8266 UDP socket. Received datagrams are injected and transmitted datagrams are
+ *        recorded by the test.
+ ***********************************************************************************************************************
+ */
+#ifndef WIFIUDP_H
+#define WIFIUDP_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+#include <deque>
+#include <vector>
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class WiFiUDP
+{
+public:
+    uint8_t begin(uint16_t Port);
+    void stop(void);
+    int parsePacket(void);
+    int read(unsigned char* BufferPtr, size_t Length);
+    int available(void);
+    int beginPacket(IPAddress Ip, uint16_t Port);
+    size_t write(const uint8_t* DataPtr, size_t Length);
+    int endPacket(void);
+    void flush(void) {}
+};
+
+namespace host
+{
+/**
+ * A datagram with the time it was transmitted or must be received.
+ */
+struct datagram
+{
+    uint64_t TimeUs;
+    std::vector<uint8_t> Data;
+};
+
+/**
+ * Both ends of the UDP socket.
+ */
+struct udp
+{
+    std::deque<datagram> Rx;           /* Datagrams waiting to be read, in order of arrival. */
+    std::vector<datagram> Tx;          /* Datagrams transmitted. */
+    std::vector<uint8_t> Current;      /* Datagram returned by the last parsePacket(). */
+    size_t CurrentOffset;              /* Read position in the current datagram. */
+    std::vector<uint8_t> Building;     /* Datagram between beginPacket() and endPacket(). */
+    bool Open;                         /* Socket opened by begin(). */
+    uint32_t ParseCalls;               /* Number of parsePacket() calls. */
+    uint32_t Discarded;                /* Datagrams skipped by parsePacket() before all data was read. */
+    void (*TxHook)(const datagram&);   /* Called for each transmitted datagram, e.g. a command station. */
+};
+
+extern udp Udp;
+
+/**
+ * Make a datagram available for reception now.
+ */
+void UdpReceive(const std::vector<uint8_t>& Data);
+}
+
+#endif
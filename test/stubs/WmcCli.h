@@ -0,0 +1,32 @@
+/**
+ **********************************************************************************************************************
+ * @file  WmcCli.h
+ * @brief Host stand-in of the command line, a test hook replaces the commands typed by the user.
+ ***********************************************************************************************************************
+ */
+#ifndef WMCCLI_H
+#define WMCCLI_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include "Loclib.h"
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class WmcCli
+{
+public:
+    void Init(LocLib& locLib, LocStorage& locStorage);
+    void Update(void);
+    void IpSettingsDefault(void);
+};
+
+namespace host
+{
+extern void (*CliHook)(void); /* Executed once by the next WmcCli::Update(). */
+}
+
+#endif
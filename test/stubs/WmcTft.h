@@ -0,0 +1,109 @@
+/**
+ **********************************************************************************************************************
+ * @file  WmcTft.h
+ * @brief Host stand-in of the display, only the last status text and some counters are kept.
+ ***********************************************************************************************************************
+ */
+#ifndef WMCTFT_H
+#define WMCTFT_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class WmcTft
+{
+public:
+    enum color
+    {
+        color_green,
+        color_red,
+        color_yellow,
+        color_white
+    };
+
+    enum locoDecoderSpeedSteps
+    {
+        locoDecoderSpeedSteps14,
+        locoDecoderSpeedSteps28,
+        locoDecoderSpeedSteps128,
+        locoDecoderSpeedStepsUnknown
+    };
+
+    enum locoDirection
+    {
+        locoDirectionForward,
+        locoDirectionBackward
+    };
+
+    enum locoLight
+    {
+        locoLightOn,
+        locoLightOff
+    };
+
+    struct locoInfo
+    {
+        uint16_t Address;
+        uint8_t Speed;
+        locoDecoderSpeedSteps Steps;
+        locoDirection Direction;
+        locoLight Light;
+        uint32_t Functions;
+        bool Occupied;
+    };
+
+    void Init(void) {}
+    void Clear(void);
+    void ShowName(void) {}
+    void ShowVersion(uint8_t, uint8_t, uint8_t) {}
+    void UpdateStatus(const char* StatusPtr, bool, color);
+    void UpdateRunningWheel(uint16_t) {}
+    void ShowNetworkName(char*) {}
+    void ClearNetworkName(void) {}
+    void WifiConnectFailed(void) {}
+    void UdpConnectFailed(void) {}
+    void ShowIpAddressToConnectTo(char*) {}
+    void ShowButtonToPress(uint8_t) {}
+    void UpdateSelectedAndNumberOfLocs(uint8_t, uint8_t) {}
+    void UpdateLocInfo(locoInfo* LocInfoPtr, locoInfo*, uint8_t*, char*, bool);
+    void ShowTurnoutScreen(void) {}
+    void ShowTurnoutAddress(uint16_t Address);
+    void ShowTurnoutDirection(uint8_t) {}
+    void ShowMenu1(void);
+    void ShowMenu2(bool, bool);
+    void ShowErase(void) {}
+    void CommandLine(void) {}
+    void ShowLocSymbolFw(color) {}
+    void ShowlocAddress(uint16_t Address, color);
+    void FunctionAddSet(void) {}
+    void FunctionAddUpdate(uint8_t) {}
+    void UpdateFunction(uint8_t, uint8_t) {}
+    void UpdateTransmitCount(uint8_t, uint8_t) {}
+};
+
+namespace host
+{
+/**
+ * What the display shows.
+ */
+struct tft
+{
+    char Status[32];          /* Last status text. */
+    uint32_t Clears;          /* Number of screen clears. */
+    uint16_t LocAddress;      /* Last loc address shown in a menu. */
+    uint16_t TurnoutAddress;  /* Last turnout address shown. */
+    WmcTft::locoInfo LocInfo; /* Last loc info shown. */
+    uint32_t LocInfoUpdates;  /* Number of loc info updates. */
+    uint32_t Menus;           /* Number of main menus shown. */
+};
+
+extern tft Tft;
+}
+
+#endif
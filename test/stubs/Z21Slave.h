@@ -0,0 +1,128 @@
+/**
+ **********************************************************************************************************************
+ * @file  Z21Slave.h
+ * @brief Host stand-in of the Z21 protocol library, encodes and decodes the Z21 LAN records used by the WMC.
+ ***********************************************************************************************************************
+ */
+#ifndef Z21SLAVE_H
+#define Z21SLAVE_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class Z21Slave
+{
+public:
+    enum dataType
+    {
+        none = 0,
+        trackPowerOn,
+        trackPowerOff,
+        programmingMode,
+        emergencyStop,
+        locinfo,
+        locLibraryData,
+        programmingCvNackSc,
+        programmingCvResult,
+        unknown
+    };
+
+    enum locDecoderSpeedSteps
+    {
+        locDecoderSpeedSteps14,
+        locDecoderSpeedSteps28,
+        locDecoderSpeedSteps128,
+        locDecoderSpeedStepsUnknown
+    };
+
+    enum locDirection
+    {
+        locDirectionForward,
+        locDirectionBackward
+    };
+
+    enum locLight
+    {
+        locLightOn,
+        locLightOff
+    };
+
+    enum turnout
+    {
+        directionOff,
+        directionForward,
+        directionTurn
+    };
+
+    enum function
+    {
+        on,
+        off,
+        toggle
+    };
+
+    struct locInfo
+    {
+        uint16_t Address;
+        uint8_t Speed;
+        locDecoderSpeedSteps Steps;
+        locDirection Direction;
+        locLight Light;
+        uint32_t Functions;
+        bool Occupied;
+    };
+
+    struct locLibData
+    {
+        uint16_t Address;
+        uint8_t Actual;
+        uint8_t Total;
+        char NameStr[11];
+    };
+
+    struct cvData
+    {
+        uint16_t Number;
+        uint8_t Value;
+    };
+
+    Z21Slave();
+
+    dataType ProcesDataRx(uint8_t* DataRxPtr, uint8_t DataRxLength);
+    bool txDataPresent(void) { return (m_TxPresent); }
+    uint8_t* GetDataTx(void);
+    locInfo* LanXLocoInfo(void) { return (&m_LocInfo); }
+    locLibData* LanXLocLibData(void) { return (&m_LocLibData); }
+    cvData* LanXCvResult(void) { return (&m_CvData); }
+
+    void LanGetStatus(void);
+    void LanSetBroadCastFlags(uint32_t Flags);
+    void LanXGetLocoInfo(uint16_t Address);
+    void LanSetTrackPowerOn(void);
+    void LanSetTrackPowerOff(void);
+    void LanSetStop(void);
+    void LanXSetLocoFunction(uint16_t Address, uint8_t Function, function Mode);
+    void LanXSetLocoDrive(locInfo* LocInfoPtr);
+    void LanXSetTurnout(uint16_t Address, turnout Direction);
+    void LanXLocLibDataTransmit(uint16_t Address, uint8_t Actual, uint8_t Total, char* NamePtr);
+    void LanCvRead(uint16_t Number);
+    void LanCvWrite(uint16_t Number, uint8_t Value);
+    void LanXCvPomWriteByte(uint16_t Address, uint16_t Number, uint8_t Value);
+
+private:
+    void Tx(uint16_t Header, const uint8_t* DataPtr, uint8_t Length, bool Xor);
+
+    bool m_TxPresent;
+    uint8_t m_Tx[32];
+    locInfo m_LocInfo;
+    locLibData m_LocLibData;
+    cvData m_CvData;
+};
+
+#endif
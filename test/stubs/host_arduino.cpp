@@ -0,0 +1,311 @@
+/***********************************************************************************************************************
+   @file   host_arduino.cpp
+   @brief  Host stand-in of the Arduino core, EEPROM, wifi station and UDP socket.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <ESP8266WiFi.h>
+#include <WiFiUdp.h>
+#include <stdarg.h>
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+HardwareSerial Serial;
+EspClass ESP;
+EEPROMClass EEPROM;
+ESP8266WiFiClass WiFi;
+
+namespace host
+{
+uint64_t TimeUs                = 0;
+uint32_t TimeUsPerCall         = 0;
+int AnalogValue                = 1024;
+int (*AnalogHook)(void)        = NULL;
+uint32_t AnalogReads           = 0;
+int DigitalValue[PIN_MAX]      = { HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH,
+    HIGH, HIGH, HIGH, HIGH };
+bool SerialEcho                = false;
+udp Udp                        = {};
+static uint32_t RtcMemory[128] = {};
+}
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Time and inputs.
+ */
+void host::TimeAdvance(uint32_t Us) { TimeUs += Us; }
+
+unsigned long millis(void) { return (static_cast<unsigned long>(host::TimeUs / 1000)); }
+
+unsigned long micros(void)
+{
+    if (host::TimeUsPerCall != 0)
+    {
+        host::TimeUs += host::TimeUsPerCall;
+    }
+    return (static_cast<unsigned long>(host::TimeUs));
+}
+
+int analogRead(uint8_t)
+{
+    host::AnalogReads++;
+    return ((host::AnalogHook != NULL) ? host::AnalogHook() : host::AnalogValue);
+}
+
+int digitalRead(uint8_t Pin) { return ((Pin < PIN_MAX) ? host::DigitalValue[Pin] : LOW); }
+
+void pinMode(uint8_t, uint8_t) {}
+
+void delay(unsigned long Ms) { host::TimeUs += static_cast<uint64_t>(Ms) * 1000; }
+
+void yield(void) {}
+
+int HardwareSerial::printf(const char* FormatPtr, ...)
+{
+    int Result = 0;
+    va_list Args;
+
+    if (host::SerialEcho == true)
+    {
+        va_start(Args, FormatPtr);
+        Result = vprintf(FormatPtr, Args);
+        va_end(Args);
+    }
+
+    return (Result);
+}
+
+bool EspClass::rtcUserMemoryRead(uint32_t Offset, uint32_t* DataPtr, size_t Size)
+{
+    bool Result = ((Offset * 4 + Size) <= sizeof(host::RtcMemory));
+
+    if (Result == true)
+    {
+        memcpy(DataPtr, &host::RtcMemory[Offset], Size);
+    }
+
+    return (Result);
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t Offset, uint32_t* DataPtr, size_t Size)
+{
+    bool Result = ((Offset * 4 + Size) <= sizeof(host::RtcMemory));
+
+    if (Result == true)
+    {
+        memcpy(&host::RtcMemory[Offset], DataPtr, Size);
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * EEPROM, the RAM image is copied to the flash image on commit.
+ */
+EEPROMClass::EEPROMClass()
+{
+    Commits      = 0;
+    BytesFlashed = 0;
+    memset(m_Data, 0xFF, sizeof(m_Data));
+    memset(Flash, 0xFF, sizeof(Flash));
+}
+
+uint8_t EEPROMClass::read(int Address) { return (((Address >= 0) && (Address < (int)SIZE)) ? m_Data[Address] : 0); }
+
+void EEPROMClass::write(int Address, uint8_t Data)
+{
+    if ((Address >= 0) && (Address < (int)SIZE))
+    {
+        m_Data[Address] = Data;
+    }
+}
+
+bool EEPROMClass::commit(void)
+{
+    size_t Index;
+
+    for (Index = 0; Index < SIZE; Index++)
+    {
+        if (Flash[Index] != m_Data[Index])
+        {
+            BytesFlashed++;
+        }
+    }
+
+    memcpy(Flash, m_Data, sizeof(Flash));
+    Commits++;
+
+    return (true);
+}
+
+/***********************************************************************************************************************
+ * Wifi station. A connect succeeds after the association time, a fast connect is faster. The DHCP server hands out
+ * DhcpIp, a static address set by config() is used as is.
+ */
+ESP8266WiFiClass::ESP8266WiFiClass()
+{
+    ScanTime     = 3000;
+    FastTime     = 300;
+    Bssid[0]     = 0x02;
+    Bssid[1]     = 0x11;
+    Bssid[2]     = 0x22;
+    Bssid[3]     = 0x33;
+    Bssid[4]     = 0x44;
+    Bssid[5]     = 0x55;
+    Channel      = 6;
+    DhcpIp       = IPAddress(192, 168, 0, 100);
+    Gateway      = IPAddress(192, 168, 0, 1);
+    Subnet       = IPAddress(255, 255, 255, 0);
+    StaticIp     = IPAddress();
+    Begins       = 0;
+    FastBegins   = 0;
+    DhcpRequests = 0;
+    Started      = false;
+    Fast         = false;
+    BeginTime    = 0;
+}
+
+bool ESP8266WiFiClass::mode(WiFiMode_t) { return (true); }
+
+bool ESP8266WiFiClass::config(IPAddress Ip, IPAddress, IPAddress, IPAddress)
+{
+    StaticIp = Ip;
+    return (true);
+}
+
+wl_status_t ESP8266WiFiClass::begin(const char*, const char*, int32_t ChannelGiven, const uint8_t* BssidPtr, bool)
+{
+    Begins++;
+    Started   = true;
+    Fast      = (ChannelGiven == Channel) && (BssidPtr != NULL) && (memcmp(BssidPtr, Bssid, sizeof(Bssid)) == 0);
+    BeginTime = millis();
+
+    if (Fast == true)
+    {
+        FastBegins++;
+    }
+
+    if (static_cast<uint32_t>(StaticIp) == 0)
+    {
+        DhcpRequests++;
+    }
+
+    return (WL_DISCONNECTED);
+}
+
+wl_status_t ESP8266WiFiClass::status(void)
+{
+    wl_status_t Status = WL_DISCONNECTED;
+
+    if ((Started == true) && ((millis() - BeginTime) >= ((Fast == true) ? FastTime : ScanTime)))
+    {
+        Status = WL_CONNECTED;
+    }
+
+    return (Status);
+}
+
+IPAddress ESP8266WiFiClass::localIP(void) { return ((static_cast<uint32_t>(StaticIp) != 0) ? StaticIp : DhcpIp); }
+
+bool ESP8266WiFiClass::disconnect(bool)
+{
+    Started = false;
+    return (true);
+}
+
+/***********************************************************************************************************************
+ * UDP socket. Like the ESP8266 core parsePacket() drops the rest of the current datagram and moves to the next one.
+ */
+uint8_t WiFiUDP::begin(uint16_t)
+{
+    host::Udp.Open = true;
+    return (1);
+}
+
+void WiFiUDP::stop(void) { host::Udp.Open = false; }
+
+int WiFiUDP::parsePacket(void)
+{
+    int Result = 0;
+
+    host::Udp.ParseCalls++;
+    if (host::Udp.CurrentOffset < host::Udp.Current.size())
+    {
+        host::Udp.Discarded++;
+    }
+
+    host::Udp.Current.clear();
+    host::Udp.CurrentOffset = 0;
+
+    if ((host::Udp.Rx.empty() == false) && (host::Udp.Rx.front().TimeUs <= host::TimeUs))
+    {
+        host::Udp.Current = host::Udp.Rx.front().Data;
+        host::Udp.Rx.pop_front();
+        Result = static_cast<int>(host::Udp.Current.size());
+    }
+
+    return (Result);
+}
+
+int WiFiUDP::read(unsigned char* BufferPtr, size_t Length)
+{
+    size_t Available = host::Udp.Current.size() - host::Udp.CurrentOffset;
+
+    if (Length > Available)
+    {
+        Length = Available;
+    }
+
+    memcpy(BufferPtr, host::Udp.Current.data() + host::Udp.CurrentOffset, Length);
+    host::Udp.CurrentOffset += Length;
+
+    return (static_cast<int>(Length));
+}
+
+int WiFiUDP::available(void) { return (static_cast<int>(host::Udp.Current.size() - host::Udp.CurrentOffset)); }
+
+int WiFiUDP::beginPacket(IPAddress, uint16_t)
+{
+    host::Udp.Building.clear();
+    return (1);
+}
+
+size_t WiFiUDP::write(const uint8_t* DataPtr, size_t Length)
+{
+    host::Udp.Building.insert(host::Udp.Building.end(), DataPtr, DataPtr + Length);
+    return (Length);
+}
+
+int WiFiUDP::endPacket(void)
+{
+    host::datagram Datagram;
+
+    Datagram.TimeUs = host::TimeUs;
+    Datagram.Data   = host::Udp.Building;
+    host::Udp.Tx.push_back(Datagram);
+    host::Udp.Building.clear();
+
+    if (host::Udp.TxHook != NULL)
+    {
+        host::Udp.TxHook(Datagram);
+    }
+
+    return (1);
+}
+
+void host::UdpReceive(const std::vector<uint8_t>& Data)
+{
+    datagram Datagram;
+
+    Datagram.TimeUs = TimeUs;
+    Datagram.Data   = Data;
+    Udp.Rx.push_back(Datagram);
+}
@@ -0,0 +1,22 @@
+/***********************************************************************************************************************
+   @file   host_cv.cpp
+   @brief  Host stand-in of the CV programming state machine.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "wmc_cv.h"
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Only state, ignores all events.
+ */
+class cvIdle : public wmcCv
+{
+};
+
+FSM_INITIAL_STATE(wmcCv, cvIdle)
@@ -0,0 +1,403 @@
+/***********************************************************************************************************************
+   @file   host_loclib.cpp
+   @brief  Host stand-in of the loc library, loc storage and command line. Like the real libraries every store is
+           written to the EEPROM image and committed.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "eep_cfg.h"
+#include <EEPROM.h>
+#include <LocStorage.h>
+#include <Loclib.h>
+#include <WmcCli.h>
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+#define HOST_LOC_RECORD_SIZE 20
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+namespace host
+{
+void (*CliHook)(void) = NULL;
+}
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Loc storage, each setting is committed on its own.
+ */
+void LocStorage::Init(void) {}
+
+bool LocStorage::EmergencyOptionGet(void) { return (EEPROM.read(EepCfg::EmergencyStopEnabledAddress) == 1); }
+
+void LocStorage::EmergencyOptionSet(uint8_t Option)
+{
+    EEPROM.write(EepCfg::EmergencyStopEnabledAddress, Option);
+    EEPROM.commit();
+}
+
+void LocStorage::NumberOfLocsSet(uint8_t Number)
+{
+    EEPROM.write(EepCfg::locLibEepromAddressNumOfLocs, Number);
+    EEPROM.commit();
+}
+
+uint8_t LocStorage::NumberOfLocsGet(void) { return (EEPROM.read(EepCfg::locLibEepromAddressNumOfLocs)); }
+
+void LocStorage::AcOptionSet(uint8_t Option)
+{
+    EEPROM.write(EepCfg::AcTypeControlAddress, Option);
+    EEPROM.commit();
+}
+
+void LocStorage::InvalidateAdc(void)
+{
+    EEPROM.write(EepCfg::ButtonAdcValuesAddressValid, 0);
+    EEPROM.commit();
+}
+
+/***********************************************************************************************************************
+ * Command line, the test hook stands for the commands typed.
+ */
+void WmcCli::Init(LocLib&, LocStorage&) {}
+
+void WmcCli::Update(void)
+{
+    void (*HookPtr)(void) = host::CliHook;
+
+    host::CliHook = NULL;
+    if (HookPtr != NULL)
+    {
+        HookPtr();
+    }
+}
+
+void WmcCli::IpSettingsDefault(void)
+{
+    const uint8_t Z21[4]    = { 192, 168, 0, 111 };
+    const uint8_t Wmc[4]    = { 192, 168, 0, 112 };
+    const uint8_t Subnet[4] = { 255, 255, 255, 0 };
+    const uint8_t Gw[4]     = { 192, 168, 0, 1 };
+    uint8_t Index;
+
+    EEPROM.write(EepCfg::StaticIpAddress, 0);
+    for (Index = 0; Index < 4; Index++)
+    {
+        EEPROM.write(EepCfg::EepIpAddressZ21 + Index, Z21[Index]);
+        EEPROM.write(EepCfg::EepIpAddressWmc + Index, Wmc[Index]);
+        EEPROM.write(EepCfg::EepIpSubnet + Index, Subnet[Index]);
+        EEPROM.write(EepCfg::EepIpGateway + Index, Gw[Index]);
+    }
+    EEPROM.commit();
+}
+
+/***********************************************************************************************************************
+ * Loc library.
+ */
+static void HostLocWrite(uint8_t Index, const LocLibData& Data)
+{
+    int Address = EepCfg::locLibEepromAddressData + (Index * HOST_LOC_RECORD_SIZE);
+    uint8_t Slot;
+
+    EEPROM.write(Address, Data.Addres >> 8);
+    EEPROM.write(Address + 1, Data.Addres & 0xFF);
+    EEPROM.write(Address + 2, Data.Steps);
+    EEPROM.write(Address + 3, static_cast<uint8_t>(Data.Dir));
+    EEPROM.write(Address + 4, Data.Speed);
+    for (Slot = 0; Slot < 5; Slot++)
+    {
+        EEPROM.write(Address + 5 + Slot, Data.FunctionAssignment[Slot]);
+    }
+    for (Slot = 0; Slot < 10; Slot++)
+    {
+        EEPROM.write(Address + 10 + Slot, static_cast<uint8_t>(Data.Name[Slot]));
+    }
+}
+
+void LocLib::Init(LocStorage& Storage)
+{
+    uint8_t Index;
+    uint8_t Slot;
+    int Address;
+
+    SortPasses  = 0;
+    m_Selected  = 0;
+    m_Functions = 0;
+    m_Number    = Storage.NumberOfLocsGet();
+
+    if ((m_Number == 0) || (m_Number > LOCS_MAX))
+    {
+        InitialLocStore();
+    }
+    else
+    {
+        for (Index = 0; Index < m_Number; Index++)
+        {
+            Address                 = EepCfg::locLibEepromAddressData + (Index * HOST_LOC_RECORD_SIZE);
+            m_Locs[Index].Addres    = (static_cast<uint16_t>(EEPROM.read(Address)) << 8) | EEPROM.read(Address + 1);
+            m_Locs[Index].Steps     = EEPROM.read(Address + 2);
+            m_Locs[Index].Dir       = static_cast<direction>(EEPROM.read(Address + 3) & 0x01);
+            m_Locs[Index].Speed     = EEPROM.read(Address + 4);
+            for (Slot = 0; Slot < 5; Slot++)
+            {
+                m_Locs[Index].FunctionAssignment[Slot] = EEPROM.read(Address + 5 + Slot);
+            }
+            for (Slot = 0; Slot < 10; Slot++)
+            {
+                m_Locs[Index].Name[Slot] = static_cast<char>(EEPROM.read(Address + 10 + Slot));
+            }
+            m_Locs[Index].Name[10] = '\0';
+        }
+    }
+}
+
+uint16_t LocLib::GetActualLocAddress(void) { return (m_Locs[m_Selected].Addres); }
+
+uint8_t LocLib::GetActualSelectedLocIndex(void) { return (m_Selected + 1); }
+
+uint8_t LocLib::GetNumberOfLocs(void) { return (m_Number); }
+
+uint16_t LocLib::GetNextLoc(int8_t Delta)
+{
+    int Selected = (static_cast<int>(m_Selected) + Delta) % m_Number;
+
+    if (Selected < 0)
+    {
+        Selected += m_Number;
+    }
+
+    m_Selected  = static_cast<uint8_t>(Selected);
+    m_Functions = 0;
+
+    return (m_Locs[m_Selected].Addres);
+}
+
+void LocLib::UpdateLocData(uint16_t Address)
+{
+    uint8_t Index = CheckLoc(Address);
+
+    if (Index != 255)
+    {
+        m_Selected = Index;
+    }
+}
+
+uint16_t LocLib::SpeedSet(int8_t Delta)
+{
+    uint16_t Result = 0xFFFF;
+    int Max         = 126;
+    int Speed       = m_Locs[m_Selected].Speed;
+
+    switch (m_Locs[m_Selected].Steps)
+    {
+    case decoderStep14: Max = 14; break;
+    case decoderStep28: Max = 28; break;
+    default: break;
+    }
+
+    if (Delta == 0)
+    {
+        /* Stop, or change direction when stopped already. */
+        if (Speed == 0)
+        {
+            DirectionToggle();
+        }
+        m_Locs[m_Selected].Speed = 0;
+        Result                   = 0;
+    }
+    else
+    {
+        Speed += Delta;
+        Speed = (Speed < 0) ? 0 : ((Speed > Max) ? Max : Speed);
+        if (Speed != m_Locs[m_Selected].Speed)
+        {
+            m_Locs[m_Selected].Speed = static_cast<uint8_t>(Speed);
+            Result                   = static_cast<uint16_t>(Speed);
+        }
+    }
+
+    return (Result);
+}
+
+void LocLib::SpeedUpdate(uint8_t Speed) { m_Locs[m_Selected].Speed = Speed; }
+
+uint8_t LocLib::SpeedGet(void) { return (m_Locs[m_Selected].Speed); }
+
+void LocLib::DirectionSet(direction Dir) { m_Locs[m_Selected].Dir = Dir; }
+
+direction LocLib::DirectionGet(void) { return (m_Locs[m_Selected].Dir); }
+
+void LocLib::DirectionToggle(void)
+{
+    m_Locs[m_Selected].Dir = (m_Locs[m_Selected].Dir == directionForward) ? directionBackWard : directionForward;
+}
+
+void LocLib::DecoderStepsUpdate(decoderSteps Steps) { m_Locs[m_Selected].Steps = static_cast<uint8_t>(Steps); }
+
+decoderSteps LocLib::DecoderStepsGet(void) { return (static_cast<decoderSteps>(m_Locs[m_Selected].Steps)); }
+
+uint8_t LocLib::FunctionAssignedGet(uint8_t Index) { return (m_Locs[m_Selected].FunctionAssignment[Index % 5]); }
+
+void LocLib::FunctionToggle(uint8_t Function) { m_Functions ^= (1UL << (Function & 0x1F)); }
+
+LocLib::function LocLib::FunctionStatusGet(uint8_t Function)
+{
+    return (((m_Functions & (1UL << (Function & 0x1F))) != 0) ? functionOn : functionOff);
+}
+
+uint8_t LocLib::CheckLoc(uint16_t Address)
+{
+    uint8_t Result = 255;
+    uint8_t Index;
+
+    for (Index = 0; Index < m_Number; Index++)
+    {
+        if (m_Locs[Index].Addres == Address)
+        {
+            Result = Index;
+            break;
+        }
+    }
+
+    return (Result);
+}
+
+bool LocLib::StoreLoc(uint16_t Address, uint8_t* FunctionPtr, char* NamePtr, action Action)
+{
+    bool Result   = true;
+    uint8_t Index = CheckLoc(Address);
+
+    if (Index == 255)
+    {
+        if (m_Number >= LOCS_MAX)
+        {
+            Result = false;
+        }
+        else
+        {
+            Index = m_Number;
+            m_Number++;
+            memset(&m_Locs[Index], 0, sizeof(m_Locs[Index]));
+            m_Locs[Index].Addres = Address;
+            m_Locs[Index].Steps  = decoderStep28;
+            m_Locs[Index].Dir    = directionForward;
+            EEPROM.write(EepCfg::locLibEepromAddressNumOfLocs, m_Number);
+        }
+    }
+    else if (Action != storeChange)
+    {
+        Result = false;
+    }
+
+    if (Result == true)
+    {
+        if (FunctionPtr != NULL)
+        {
+            memcpy(m_Locs[Index].FunctionAssignment, FunctionPtr, 5);
+        }
+        if (NamePtr != NULL)
+        {
+            strncpy(m_Locs[Index].Name, NamePtr, 10);
+            m_Locs[Index].Name[10] = '\0';
+        }
+        if (Action == storeAdd)
+        {
+            m_Selected = Index;
+        }
+
+        HostLocWrite(Index, m_Locs[Index]);
+        EEPROM.commit();
+    }
+
+    return (Result);
+}
+
+void LocLib::LocBubbleSort(void)
+{
+    uint8_t Index;
+    uint16_t Selected = m_Locs[m_Selected].Addres;
+    bool Swapped      = true;
+    LocLibData Data;
+
+    while (Swapped == true)
+    {
+        Swapped = false;
+        SortPasses++;
+        for (Index = 1; Index < m_Number; Index++)
+        {
+            if (m_Locs[Index - 1].Addres > m_Locs[Index].Addres)
+            {
+                Data              = m_Locs[Index - 1];
+                m_Locs[Index - 1] = m_Locs[Index];
+                m_Locs[Index]     = Data;
+                Swapped           = true;
+            }
+        }
+    }
+
+    for (Index = 0; Index < m_Number; Index++)
+    {
+        HostLocWrite(Index, m_Locs[Index]);
+    }
+    EEPROM.commit();
+
+    m_Selected = CheckLoc(Selected);
+}
+
+uint16_t LocLib::limitLocAddress(uint16_t Address)
+{
+    return ((Address < 1) ? 9999 : ((Address > 9999) ? 1 : Address));
+}
+
+bool LocLib::RemoveLoc(uint16_t Address)
+{
+    bool Result   = false;
+    uint8_t Index = CheckLoc(Address);
+
+    if ((Index != 255) && (m_Number > 1))
+    {
+        memmove(&m_Locs[Index], &m_Locs[Index + 1], (m_Number - Index - 1) * sizeof(LocLibData));
+        m_Number--;
+        m_Selected = 0;
+        for (Index = 0; Index < m_Number; Index++)
+        {
+            HostLocWrite(Index, m_Locs[Index]);
+        }
+        EEPROM.write(EepCfg::locLibEepromAddressNumOfLocs, m_Number);
+        EEPROM.commit();
+        Result = true;
+    }
+
+    return (Result);
+}
+
+void LocLib::InitialLocStore(void)
+{
+    uint8_t Index;
+
+    memset(m_Locs, 0, sizeof(m_Locs));
+    m_Number          = 1;
+    m_Selected        = 0;
+    m_Locs[0].Addres  = 3;
+    m_Locs[0].Steps   = decoderStep28;
+    m_Locs[0].Dir     = directionForward;
+    for (Index = 0; Index < 5; Index++)
+    {
+        m_Locs[0].FunctionAssignment[Index] = Index;
+    }
+
+    HostLocWrite(0, m_Locs[0]);
+    EEPROM.write(EepCfg::locLibEepromAddressNumOfLocs, m_Number);
+    EEPROM.commit();
+}
+
+LocLibData* LocLib::LocGetAllDataByIndex(uint8_t Index) { return ((Index < m_Number) ? &m_Locs[Index] : NULL); }
+
+char* LocLib::GetLocName(void) { return (m_Locs[m_Selected].Name); }
@@ -0,0 +1,42 @@
+/***********************************************************************************************************************
+   @file   host_tft.cpp
+   @brief  Host stand-in of the display.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include <WmcTft.h>
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+namespace host
+{
+tft Tft = {};
+}
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+void WmcTft::Clear(void) { host::Tft.Clears++; }
+
+void WmcTft::UpdateStatus(const char* StatusPtr, bool, color)
+{
+    snprintf(host::Tft.Status, sizeof(host::Tft.Status), "%s", StatusPtr);
+}
+
+void WmcTft::UpdateLocInfo(locoInfo* LocInfoPtr, locoInfo*, uint8_t*, char*, bool)
+{
+    host::Tft.LocInfo = *LocInfoPtr;
+    host::Tft.LocInfoUpdates++;
+}
+
+void WmcTft::ShowlocAddress(uint16_t Address, color) { host::Tft.LocAddress = Address; }
+
+void WmcTft::ShowTurnoutAddress(uint16_t Address) { host::Tft.TurnoutAddress = Address; }
+
+void WmcTft::ShowMenu1(void) { host::Tft.Menus++; }
+
+void WmcTft::ShowMenu2(bool, bool) { host::Tft.Menus++; }
@@ -0,0 +1,251 @@
+/***********************************************************************************************************************
+   @file   host_z21slave.cpp
+   @brief  Host stand-in of the Z21 protocol library. The LAN_X records follow the Z21 LAN protocol, the speed byte
+           holds the speed step as is. Loc library data uses its own header 0xA9.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include <Z21Slave.h>
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+Z21Slave::Z21Slave()
+{
+    m_TxPresent = false;
+    memset(m_Tx, 0, sizeof(m_Tx));
+    memset(&m_LocInfo, 0, sizeof(m_LocInfo));
+    memset(&m_LocLibData, 0, sizeof(m_LocLibData));
+    memset(&m_CvData, 0, sizeof(m_CvData));
+}
+
+/***********************************************************************************************************************
+ */
+Z21Slave::dataType Z21Slave::ProcesDataRx(uint8_t* DataRxPtr, uint8_t DataRxLength)
+{
+    dataType Result = unknown;
+    uint16_t Header = static_cast<uint16_t>(DataRxPtr[2]) | (static_cast<uint16_t>(DataRxPtr[3]) << 8);
+
+    if ((Header == 0x40) && (DataRxLength >= 7))
+    {
+        switch (DataRxPtr[4])
+        {
+        case 0x61:
+            switch (DataRxPtr[5])
+            {
+            case 0x00: Result = trackPowerOff; break;
+            case 0x01: Result = trackPowerOn; break;
+            case 0x02: Result = programmingMode; break;
+            case 0x12: Result = programmingCvNackSc; break;
+            default: break;
+            }
+            break;
+        case 0x62:
+            if (DataRxPtr[5] == 0x22)
+            {
+                if ((DataRxPtr[6] & 0x01) != 0)
+                {
+                    Result = emergencyStop;
+                }
+                else if ((DataRxPtr[6] & 0x02) != 0)
+                {
+                    Result = trackPowerOff;
+                }
+                else if ((DataRxPtr[6] & 0x20) != 0)
+                {
+                    Result = programmingMode;
+                }
+                else
+                {
+                    Result = trackPowerOn;
+                }
+            }
+            break;
+        case 0x64:
+            if (DataRxPtr[5] == 0x14)
+            {
+                m_CvData.Number = (static_cast<uint16_t>(DataRxPtr[6]) << 8) | DataRxPtr[7];
+                m_CvData.Value  = DataRxPtr[8];
+                Result          = programmingCvResult;
+            }
+            break;
+        case 0x81:
+            if (DataRxPtr[5] == 0x00)
+            {
+                Result = emergencyStop;
+            }
+            break;
+        case 0xEF:
+            if (DataRxLength >= 14)
+            {
+                m_LocInfo.Address = (static_cast<uint16_t>(DataRxPtr[5] & 0x3F) << 8) | DataRxPtr[6];
+                switch (DataRxPtr[7] & 0x07)
+                {
+                case 0: m_LocInfo.Steps = locDecoderSpeedSteps14; break;
+                case 2: m_LocInfo.Steps = locDecoderSpeedSteps28; break;
+                case 4: m_LocInfo.Steps = locDecoderSpeedSteps128; break;
+                default: m_LocInfo.Steps = locDecoderSpeedStepsUnknown; break;
+                }
+                m_LocInfo.Occupied  = ((DataRxPtr[7] & 0x08) != 0);
+                m_LocInfo.Direction = ((DataRxPtr[8] & 0x80) != 0) ? locDirectionForward : locDirectionBackward;
+                m_LocInfo.Speed     = DataRxPtr[8] & 0x7F;
+                m_LocInfo.Light     = ((DataRxPtr[9] & 0x10) != 0) ? locLightOn : locLightOff;
+                m_LocInfo.Functions = ((DataRxPtr[9] & 0x10) >> 4) | (static_cast<uint32_t>(DataRxPtr[9] & 0x0F) << 1)
+                    | (static_cast<uint32_t>(DataRxPtr[10]) << 5) | (static_cast<uint32_t>(DataRxPtr[11]) << 13)
+                    | (static_cast<uint32_t>(DataRxPtr[12]) << 21);
+                Result = locinfo;
+            }
+            break;
+        default: break;
+        }
+    }
+    else if ((Header == 0xA9) && (DataRxLength >= 18))
+    {
+        m_LocLibData.Address = (static_cast<uint16_t>(DataRxPtr[4]) << 8) | DataRxPtr[5];
+        m_LocLibData.Actual  = DataRxPtr[6];
+        m_LocLibData.Total   = DataRxPtr[7];
+        memcpy(m_LocLibData.NameStr, &DataRxPtr[8], 10);
+        m_LocLibData.NameStr[10] = '\0';
+        Result                   = locLibraryData;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+uint8_t* Z21Slave::GetDataTx(void)
+{
+    m_TxPresent = false;
+    return (m_Tx);
+}
+
+/***********************************************************************************************************************
+ */
+void Z21Slave::Tx(uint16_t Header, const uint8_t* DataPtr, uint8_t Length, bool Xor)
+{
+    uint8_t Index;
+    uint8_t Check      = 0;
+    uint8_t DataLength = 4 + Length + ((Xor == true) ? 1 : 0);
+
+    m_Tx[0] = DataLength;
+    m_Tx[1] = 0;
+    m_Tx[2] = Header & 0xFF;
+    m_Tx[3] = Header >> 8;
+
+    for (Index = 0; Index < Length; Index++)
+    {
+        m_Tx[4 + Index] = DataPtr[Index];
+        Check ^= DataPtr[Index];
+    }
+
+    if (Xor == true)
+    {
+        m_Tx[4 + Length] = Check;
+    }
+
+    m_TxPresent = true;
+}
+
+void Z21Slave::LanGetStatus(void)
+{
+    const uint8_t Data[] = { 0x21, 0x24 };
+    Tx(0x40, Data, sizeof(Data), true);
+}
+
+void Z21Slave::LanSetBroadCastFlags(uint32_t Flags)
+{
+    const uint8_t Data[] = { static_cast<uint8_t>(Flags), static_cast<uint8_t>(Flags >> 8),
+        static_cast<uint8_t>(Flags >> 16), static_cast<uint8_t>(Flags >> 24) };
+    Tx(0x50, Data, sizeof(Data), false);
+}
+
+void Z21Slave::LanXGetLocoInfo(uint16_t Address)
+{
+    const uint8_t Data[] = { 0xE3, 0xF0, static_cast<uint8_t>(Address >> 8), static_cast<uint8_t>(Address) };
+    Tx(0x40, Data, sizeof(Data), true);
+}
+
+void Z21Slave::LanSetTrackPowerOn(void)
+{
+    const uint8_t Data[] = { 0x21, 0x81 };
+    Tx(0x40, Data, sizeof(Data), true);
+}
+
+void Z21Slave::LanSetTrackPowerOff(void)
+{
+    const uint8_t Data[] = { 0x21, 0x80 };
+    Tx(0x40, Data, sizeof(Data), true);
+}
+
+void Z21Slave::LanSetStop(void)
+{
+    const uint8_t Data[] = { 0x80 };
+    Tx(0x40, Data, sizeof(Data), true);
+}
+
+void Z21Slave::LanXSetLocoFunction(uint16_t Address, uint8_t Function, function Mode)
+{
+    uint8_t Type         = (Mode == on) ? 0x40 : ((Mode == off) ? 0x00 : 0x80);
+    const uint8_t Data[] = { 0xE4, 0xF8, static_cast<uint8_t>(Address >> 8), static_cast<uint8_t>(Address),
+        static_cast<uint8_t>(Type | (Function & 0x3F)) };
+    Tx(0x40, Data, sizeof(Data), true);
+}
+
+void Z21Slave::LanXSetLocoDrive(locInfo* LocInfoPtr)
+{
+    uint8_t Steps = 0x13;
+
+    switch (LocInfoPtr->Steps)
+    {
+    case locDecoderSpeedSteps14: Steps = 0x10; break;
+    case locDecoderSpeedSteps28: Steps = 0x12; break;
+    default: break;
+    }
+
+    const uint8_t Data[] = { 0xE4, Steps, static_cast<uint8_t>(LocInfoPtr->Address >> 8),
+        static_cast<uint8_t>(LocInfoPtr->Address),
+        static_cast<uint8_t>(((LocInfoPtr->Direction == locDirectionForward) ? 0x80 : 0x00) | (LocInfoPtr->Speed & 0x7F)) };
+    Tx(0x40, Data, sizeof(Data), true);
+}
+
+void Z21Slave::LanXSetTurnout(uint16_t Address, turnout Direction)
+{
+    uint8_t Value        = (Direction == directionOff) ? 0x80 : ((Direction == directionForward) ? 0x89 : 0x88);
+    const uint8_t Data[] = { 0x53, static_cast<uint8_t>(Address >> 8), static_cast<uint8_t>(Address), Value };
+    Tx(0x40, Data, sizeof(Data), true);
+}
+
+void Z21Slave::LanXLocLibDataTransmit(uint16_t Address, uint8_t Actual, uint8_t Total, char* NamePtr)
+{
+    uint8_t Data[14] = { static_cast<uint8_t>(Address >> 8), static_cast<uint8_t>(Address), Actual, Total };
+    size_t Length    = (NamePtr != NULL) ? strlen(NamePtr) : 0;
+
+    memcpy(&Data[4], NamePtr, (Length > 10) ? 10 : Length);
+
+    Tx(0xA9, Data, sizeof(Data), false);
+}
+
+void Z21Slave::LanCvRead(uint16_t Number)
+{
+    const uint8_t Data[] = { 0x23, 0x11, static_cast<uint8_t>(Number >> 8), static_cast<uint8_t>(Number) };
+    Tx(0x40, Data, sizeof(Data), true);
+}
+
+void Z21Slave::LanCvWrite(uint16_t Number, uint8_t Value)
+{
+    const uint8_t Data[] = { 0x24, 0x12, static_cast<uint8_t>(Number >> 8), static_cast<uint8_t>(Number), Value };
+    Tx(0x40, Data, sizeof(Data), true);
+}
+
+void Z21Slave::LanXCvPomWriteByte(uint16_t Address, uint16_t Number, uint8_t Value)
+{
+    const uint8_t Data[] = { 0xE6, 0x30, static_cast<uint8_t>(Address >> 8), static_cast<uint8_t>(Address),
+        static_cast<uint8_t>(0xEC | ((Number >> 8) & 0x03)), static_cast<uint8_t>(Number), Value };
+    Tx(0x40, Data, sizeof(Data), true);
+}
@@ -0,0 +1,87 @@
+/**
+ **********************************************************************************************************************
+ * @file  tinyfsm.hpp
+ * @brief Host stand-in of the tinyfsm subset used by the WMC, same dispatch and transition order as tinyfsm.
+ ***********************************************************************************************************************
+ */
+#ifndef TINYFSM_HPP_INCLUDED
+#define TINYFSM_HPP_INCLUDED
+
+namespace tinyfsm
+{
+struct Event
+{
+};
+
+template <typename S> struct _state_instance
+{
+    using value_type = S;
+    static S value;
+};
+
+template <typename S> typename _state_instance<S>::value_type _state_instance<S>::value;
+
+template <typename F> class Fsm
+{
+public:
+    using state_ptr_t = F*;
+
+    static state_ptr_t current_state_ptr;
+
+    template <typename S> static bool is_in_state(void)
+    {
+        return (current_state_ptr == &_state_instance<S>::value);
+    }
+
+    static void set_initial_state(void);
+
+    static void start(void)
+    {
+        set_initial_state();
+        current_state_ptr->entry();
+    }
+
+    template <typename E> static void dispatch(E const& event) { current_state_ptr->react(event); }
+
+protected:
+    template <typename S> void transit(void)
+    {
+        current_state_ptr->exit();
+        current_state_ptr = &_state_instance<S>::value;
+        current_state_ptr->entry();
+    }
+};
+
+template <typename F> typename Fsm<F>::state_ptr_t Fsm<F>::current_state_ptr;
+
+template <typename... FF> struct FsmList;
+
+template <> struct FsmList<>
+{
+    static void start(void) {}
+    template <typename E> static void dispatch(E const&) {}
+};
+
+template <typename F, typename... FF> struct FsmList<F, FF...>
+{
+    static void start(void)
+    {
+        Fsm<F>::start();
+        FsmList<FF...>::start();
+    }
+
+    template <typename E> static void dispatch(E const& event)
+    {
+        Fsm<F>::template dispatch<E>(event);
+        FsmList<FF...>::template dispatch<E>(event);
+    }
+};
+}
+
+#define FSM_INITIAL_STATE(_FSM, _STATE)                                                                               \
+    namespace tinyfsm                                                                                                  \
+    {                                                                                                                  \
+    template <> void Fsm<_FSM>::set_initial_state(void) { current_state_ptr = &_state_instance<_STATE>::value; }      \
+    }
+
+#endif
@@ -0,0 +1,6 @@
+/**
+ **********************************************************************************************************************
+ * @file  user_interface.h
+ * @brief Host stand-in of the ESP8266 SDK interface, nothing of it is used on the host.
+ ***********************************************************************************************************************
+ */
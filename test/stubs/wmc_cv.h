@@ -0,0 +1,57 @@
+/**
+ **********************************************************************************************************************
+ * @file  wmc_cv.h
+ * @brief Host stand-in of the CV programming state machine, all events are ignored.
+ ***********************************************************************************************************************
+ */
+#ifndef WMC_CV_H
+#define WMC_CV_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include "wmc_event.h"
+#include <tinyfsm.hpp>
+
+/***********************************************************************************************************************
+ * T Y P E D  E F S  /  E N U M
+ **********************************************************************************************************************/
+enum cvEventData
+{
+    startCv,
+    startPom,
+    cvNack,
+    cvData,
+    update
+};
+
+struct cvEvent : tinyfsm::Event
+{
+    cvEventData EventData;
+    uint16_t cvNumber;
+    uint8_t cvValue;
+};
+
+struct cvpushButtonEvent : tinyfsm::Event
+{
+    pushButtonsEvent EventData;
+};
+
+struct cvpulseSwitchEvent : tinyfsm::Event
+{
+    pulseSwitchEvent EventData;
+};
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class wmcCv : public tinyfsm::Fsm<wmcCv>
+{
+public:
+    void react(tinyfsm::Event const&) {}
+    virtual void entry(void) {}
+    virtual void exit(void) {}
+};
+
+#endif
@@ -0,0 +1,185 @@
+/***********************************************************************************************************************
+   @file   wmc_adc_buttons_test.cpp
+   @brief  ADC button decoder: synthetic noisy traces with spikes and contact bounce, reports the detection latency
+           and the false press rate. The ADC is not sampled while booting.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "host_test.h"
+#include "wmc_adc_buttons.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+#define ADC_TRACE_PRESSES 600        /* Presses in the trace. */
+#define ADC_TRACE_NOISE 6            /* Maximum deviation of a reading. */
+#define ADC_TRACE_SPIKE 3            /* Percentage of readings replaced by a random value. */
+#define ADC_TRACE_BOUNCE 3           /* Samples of contact bounce on press and release. */
+#define ADC_TRACE_SAMPLE_MS 5        /* Sample interval of the application. */
+#define ADC_TRACE_LATENCY_MAX 8      /* Maximum detection latency in samples with single sample spikes. */
+#define ADC_TRACE_FALSE_PERMILLE 5   /* Allowed false presses per thousand presses with random spikes. */
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+static uint32_t AdcTraceRandom = 4711;
+static uint32_t AdcTraceSpikeGap;
+static uint32_t AdcTraceSinceSpike;
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Random number 0..Range-1 from a fixed sequence.
+ */
+static uint32_t AdcTraceRandomGet(uint32_t Range)
+{
+    AdcTraceRandom = (AdcTraceRandom * 1103515245) + 12345;
+    return (((AdcTraceRandom >> 16) & 0x7FFF) % Range);
+}
+
+/***********************************************************************************************************************
+ * Reading of a level with noise and an occasional spike. Spikes are at least AdcTraceSpikeGap samples apart.
+ */
+static uint16_t AdcTraceReading(uint16_t Level)
+{
+    int32_t Reading = Level + static_cast<int32_t>(AdcTraceRandomGet((2 * ADC_TRACE_NOISE) + 1)) - ADC_TRACE_NOISE;
+
+    AdcTraceSinceSpike++;
+    if ((AdcTraceRandomGet(100) < ADC_TRACE_SPIKE) && (AdcTraceSinceSpike > AdcTraceSpikeGap))
+    {
+        Reading            = static_cast<int32_t>(AdcTraceRandomGet(1024));
+        AdcTraceSinceSpike = 0;
+    }
+
+    return (static_cast<uint16_t>((Reading < 0) ? 0 : ((Reading > 1023) ? 1023 : Reading)));
+}
+
+/***********************************************************************************************************************
+ * Feed the trace, each press is bounced, held and released with bounce. Counts the detections per press. A spike
+ * gap of 0 gives random spikes, a gap of the median size gives single sample spikes only. Returns the false presses.
+ */
+static uint32_t AdcTrace(uint32_t SpikeGap)
+{
+    wmcAdcButtons AdcButtons;
+    uint32_t LatencySum  = 0;
+    uint32_t LatencyMax  = 0;
+    uint32_t Missed      = 0;
+    uint32_t FalsePress  = 0;
+    uint32_t Samples     = 0;
+    uint16_t Reference   = host::AdcButtonValues[6] - 10;
+    uint32_t Press;
+    uint32_t Index;
+    uint32_t Hold;
+    uint32_t Detected;
+    uint8_t Button;
+    uint8_t Result;
+
+    AdcTraceSpikeGap   = SpikeGap;
+    AdcTraceSinceSpike = SpikeGap;
+    AdcButtons.Build(host::AdcButtonValues, 6, host::AdcButtonValues[6]);
+
+    for (Press = 0; Press < ADC_TRACE_PRESSES; Press++)
+    {
+        Button   = static_cast<uint8_t>(AdcTraceRandomGet(6));
+        Hold     = 10 + AdcTraceRandomGet(30);
+        Detected = 0;
+
+        /* Idle, nothing must be detected. */
+        for (Index = 0; Index < (20 + AdcTraceRandomGet(40)); Index++)
+        {
+            if (AdcButtons.Sample(AdcTraceReading(Reference)) != wmcAdcButtons::BUTTON_NONE)
+            {
+                FalsePress++;
+            }
+            Samples++;
+        }
+
+        /* Press with bounce, hold and release with bounce. */
+        for (Index = 0; Index < (Hold + (2 * ADC_TRACE_BOUNCE)); Index++)
+        {
+            if ((Index < ADC_TRACE_BOUNCE) || (Index >= (Hold + ADC_TRACE_BOUNCE)))
+            {
+                Result = AdcButtons.Sample(
+                    AdcTraceReading(((Index & 1) == 0) ? host::AdcButtonValues[Button] : Reference));
+            }
+            else
+            {
+                Result = AdcButtons.Sample(AdcTraceReading(host::AdcButtonValues[Button]));
+            }
+            Samples++;
+
+            if (Result == Button)
+            {
+                Detected++;
+                if (Detected == 1)
+                {
+                    LatencySum += Index + 1;
+                    LatencyMax = ((Index + 1) > LatencyMax) ? (Index + 1) : LatencyMax;
+                }
+            }
+            else if (Result != wmcAdcButtons::BUTTON_NONE)
+            {
+                FalsePress++;
+            }
+        }
+
+        if (Detected == 0)
+        {
+            Missed++;
+        }
+        else if (Detected > 1)
+        {
+            FalsePress += Detected - 1;
+        }
+    }
+
+    printf("adc buttons: %u presses in %u noisy samples with %u%% %s spikes, latency average %.1f ms max %u ms, "
+           "%u missed, %u false presses (%.3f%%), previous scan up to 100 ms\n",
+        ADC_TRACE_PRESSES, Samples, ADC_TRACE_SPIKE, (SpikeGap == 0) ? "random" : "single sample",
+        (static_cast<double>(LatencySum) * ADC_TRACE_SAMPLE_MS) / (ADC_TRACE_PRESSES - Missed),
+        LatencyMax * ADC_TRACE_SAMPLE_MS, Missed, FalsePress, (100.0 * FalsePress) / ADC_TRACE_PRESSES);
+
+    CHECK_EQUAL(0, Missed);
+    if (SpikeGap != 0)
+    {
+        CHECK(LatencyMax <= ADC_TRACE_LATENCY_MAX);
+    }
+
+    return (FalsePress);
+}
+
+/***********************************************************************************************************************
+ * The states while booting have no buttons, the ADC is only sampled once loc control is reached.
+ */
+static void AdcBoot(void)
+{
+    const wmcBootLog::boot* BootPtr;
+    uint32_t Reads;
+
+    host::AnalogReads = 0;
+    CHECK(host::Boot(0x02) == true);
+    BootPtr = wmcApp::BootLogGet(0);
+    Reads   = host::AnalogReads;
+
+    host::Run(1000);
+
+    printf("adc buttons: %u reads in %u ms boot, %u reads in 1 sec of loc control\n", Reads,
+        BootPtr->Time[wmcBootLog::drivable] - BootPtr->Time[wmcBootLog::configLoaded], host::AnalogReads - Reads);
+
+    CHECK(Reads <= 2);
+    CHECK_EQUAL(1000 / ADC_TRACE_SAMPLE_MS, host::AnalogReads - Reads);
+}
+
+int main(void)
+{
+    /* The median filter removes single sample spikes completely, random spikes may occasionally line up. */
+    CHECK_EQUAL(0, AdcTrace(3));
+    CHECK(AdcTrace(0) <= ((ADC_TRACE_PRESSES * ADC_TRACE_FALSE_PERMILLE) / 1000));
+    AdcBoot();
+
+    return (host::Result("wmc_adc_buttons_test"));
+}
@@ -0,0 +1,142 @@
+/***********************************************************************************************************************
+   @file   wmc_config_test.cpp
+   @brief  Configuration record: settings written by the CLI are sealed with a new CRC, a corrupt record is replaced
+           by the last known good copy or by defaults.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "host_test.h"
+#include <WmcCli.h>
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Configuration record in flash, primary or copy.
+ */
+static EepCfg::config ConfigFlash(int Address)
+{
+    EepCfg::config Config;
+
+    memcpy(&Config, &EEPROM.Flash[Address], sizeof(Config));
+
+    return (Config);
+}
+
+/***********************************************************************************************************************
+ * Check the CRC of a configuration record.
+ */
+static bool ConfigCrcValid(const EepCfg::config& Config)
+{
+    uint16_t Crc = host::ConfigCrc(Config);
+
+    return ((Config.Crc[0] == (Crc & 0xFF)) && (Config.Crc[1] == (Crc >> 8)));
+}
+
+/***********************************************************************************************************************
+ * CLI command setting another Z21 IP address, written to EEPROM without CRC like the CLI does.
+ */
+static void ConfigCliIpZ21(void)
+{
+    EEPROM.write(EepCfg::EepIpAddressZ21 + 3, 120);
+    EEPROM.commit();
+}
+
+/***********************************************************************************************************************
+ * Damage a byte of the record in flash as a power loss during a write would do, and boot again.
+ */
+static void ConfigCorruptAndBoot(int Address, int Offset)
+{
+    EEPROM.write(Address + Offset, EEPROM.read(Address + Offset) ^ 0x5A);
+    EEPROM.commit();
+
+    fsm_list::start();
+    host::Run(200);
+}
+
+/***********************************************************************************************************************
+ * The CLI write is taken over and sealed, both the record and the copy are valid with the new setting.
+ */
+static void ConfigCliSeal(void)
+{
+    wmcApp::configStatistics Statistics = wmcApp::ConfigStatisticsGet();
+    EepCfg::config Config;
+
+    host::CliHook = ConfigCliIpZ21;
+    host::Run(3000);
+
+    CHECK_EQUAL(Statistics.Seals + 1, wmcApp::ConfigStatisticsGet().Seals);
+
+    Config = ConfigFlash(0);
+    CHECK(ConfigCrcValid(Config) == true);
+    CHECK_EQUAL(120, Config.IpAddressZ21[3]);
+
+    Config = ConfigFlash(EepCfg::ConfigCopyAddress);
+    CHECK(ConfigCrcValid(Config) == true);
+    CHECK_EQUAL(120, Config.IpAddressZ21[3]);
+
+    /* Nothing more to seal. */
+    host::Run(1000);
+    CHECK_EQUAL(Statistics.Seals + 1, wmcApp::ConfigStatisticsGet().Seals);
+}
+
+/***********************************************************************************************************************
+ * A corrupt record is rejected and replaced by the last known good copy.
+ */
+static void ConfigRestore(void)
+{
+    wmcApp::configStatistics Statistics = wmcApp::ConfigStatisticsGet();
+    EepCfg::config Config;
+
+    ConfigCorruptAndBoot(0, offsetof(EepCfg::config, SsidName) + 2);
+
+    CHECK_EQUAL(Statistics.CrcErrors + 1, wmcApp::ConfigStatisticsGet().CrcErrors);
+    CHECK_EQUAL(Statistics.Restores + 1, wmcApp::ConfigStatisticsGet().Restores);
+    CHECK_EQUAL(Statistics.Defaults, wmcApp::ConfigStatisticsGet().Defaults);
+    CHECK_EQUAL(Statistics.Seals, wmcApp::ConfigStatisticsGet().Seals);
+
+    Config = ConfigFlash(0);
+    CHECK(ConfigCrcValid(Config) == true);
+    CHECK(strcmp(Config.SsidName, "layout") == 0);
+    CHECK_EQUAL(120, Config.IpAddressZ21[3]);
+    CHECK_EQUAL(1, Config.ButtonAdcValuesValid);
+}
+
+/***********************************************************************************************************************
+ * A corrupt record without a valid copy is replaced by defaults, the buttons must be learned again.
+ */
+static void ConfigDefaults(void)
+{
+    wmcApp::configStatistics Statistics = wmcApp::ConfigStatisticsGet();
+    EepCfg::config Config;
+
+    EEPROM.write(EepCfg::ConfigCopyAddress + offsetof(EepCfg::config, IpAddressZ21), 0);
+    ConfigCorruptAndBoot(0, offsetof(EepCfg::config, ButtonAdcValues) + 3);
+
+    CHECK_EQUAL(Statistics.CrcErrors + 1, wmcApp::ConfigStatisticsGet().CrcErrors);
+    CHECK_EQUAL(Statistics.Restores, wmcApp::ConfigStatisticsGet().Restores);
+    CHECK_EQUAL(Statistics.Defaults + 1, wmcApp::ConfigStatisticsGet().Defaults);
+
+    Config = ConfigFlash(0);
+    CHECK(ConfigCrcValid(Config) == true);
+    CHECK_EQUAL(EepCfg::EepromVersion, Config.EepromVersion);
+    CHECK_EQUAL(0, Config.ButtonAdcValuesValid);
+    CHECK_EQUAL(0, Config.WifiCacheValid);
+    CHECK_EQUAL(0, strlen(Config.SsidName));
+    CHECK(memcmp(&Config, &EEPROM.Flash[EepCfg::ConfigCopyAddress], sizeof(Config)) == 0);
+}
+
+int main(void)
+{
+    CHECK(host::Boot(0x02) == true);
+    CHECK_EQUAL(0, wmcApp::ConfigStatisticsGet().CrcErrors);
+
+    ConfigCliSeal();
+    ConfigRestore();
+    ConfigDefaults();
+
+    return (host::Result("wmc_config_test"));
+}
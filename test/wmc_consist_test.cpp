@@ -0,0 +1,268 @@
+/***********************************************************************************************************************
+   @file   wmc_consist_test.cpp
+   @brief  Consists: members are set in the consist menu and survive a power cycle. Drives a lead loc with 128 speed
+           steps and members with 28 and 14 speed steps, all member commands must leave in the datagram of the lead.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "host_test.h"
+#include <sys/wait.h>
+#include <unistd.h>
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+#define CONSIST_LEAD 3        /* Selected loc after boot, 128 speed steps. */
+#define CONSIST_MEMBER_28 10  /* Member with 28 speed steps, same direction. */
+#define CONSIST_MEMBER_14 11  /* Member with 14 speed steps, opposite direction. */
+#define CONSIST_DETENTS 8     /* Detents of the knob turn. */
+#define CONSIST_DETENT_MS 20  /* Time between detents. */
+#define CONSIST_SLOW_MS 150   /* Time between detents in the menu, one address per detent. */
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Enter the consist menu of the selected loc, the menu is entered with the track power off.
+ */
+static void ConsistMenuEnter(void)
+{
+    wmcApp::EventQueueGet().PushButton(button_power);
+    host::Run(100);
+    host::PulseSwitch(pushedlong, 0);
+    host::Run(100);
+    host::PulseSwitch(turn, 1);
+    host::Run(100);
+    wmcApp::EventQueueGet().PushButton(button_0);
+    host::Run(100);
+}
+
+/***********************************************************************************************************************
+ * Back to loc control with the track power on.
+ */
+static void ConsistMenuLeave(void)
+{
+    host::PulseSwitch(pushedNormal, 0);
+    host::Run(100);
+    wmcApp::EventQueueGet().PushButton(button_power);
+    host::Run(500);
+    host::PulseSwitch(pushedShort, 0);
+    host::Run(500);
+}
+
+/***********************************************************************************************************************
+ * Add both members in the consist menu and apply the functions of the lead to them.
+ */
+static void ConsistMenu(void)
+{
+    uint8_t Index;
+
+    ConsistMenuEnter();
+    CHECK(strcmp(host::Tft.Status, "MEMBER 3 FWD") == 0);
+
+    for (Index = CONSIST_LEAD; Index < CONSIST_MEMBER_28; Index++)
+    {
+        host::PulseSwitch(turn, 1);
+        host::Run(CONSIST_SLOW_MS);
+    }
+    wmcApp::EventQueueGet().PushButton(button_0);
+    host::Run(100);
+    CHECK(strcmp(host::Tft.Status, "MEMBER 10 FWD") == 0);
+
+    host::PulseSwitch(turn, 1);
+    host::Run(CONSIST_SLOW_MS);
+    host::PulseSwitch(pushedShort, 0);
+    host::Run(100);
+    wmcApp::EventQueueGet().PushButton(button_0);
+    host::Run(100);
+    CHECK(strcmp(host::Tft.Status, "MEMBER 11 REV") == 0);
+
+    wmcApp::EventQueueGet().PushButton(button_2);
+    host::Run(100);
+    CHECK(strcmp(host::Tft.Status, "MEMBER 11 REV F") == 0);
+
+    /* The lead itself can not be a member. */
+    for (Index = CONSIST_LEAD; Index < CONSIST_MEMBER_14; Index++)
+    {
+        host::PulseSwitch(turn, -1);
+        host::Run(CONSIST_SLOW_MS);
+    }
+    wmcApp::EventQueueGet().PushButton(button_0);
+    host::Run(100);
+    CHECK(strcmp(host::Tft.Status, "MEMBER NOT ADDED") == 0);
+
+    ConsistMenuLeave();
+}
+
+/***********************************************************************************************************************
+ * Power cycle: set the consist in a child process, only the flash content survives and is taken over by the parent.
+ */
+static void ConsistPowerCycle(void)
+{
+    const EepCfg::consist* ConsistsPtr;
+    int Pipe[2];
+    int Status;
+    pid_t Pid;
+
+    CHECK(pipe(Pipe) == 0);
+    fflush(stdout);
+
+    Pid = fork();
+    if (Pid == 0)
+    {
+        close(Pipe[0]);
+        if (host::Boot(0x00) == true)
+        {
+            ConsistMenu();
+        }
+
+        if ((host::Failures() != 0) || (write(Pipe[1], EEPROM.Flash, sizeof(EEPROM.Flash)) != sizeof(EEPROM.Flash)))
+        {
+            _exit(1);
+        }
+        _exit(0);
+    }
+
+    close(Pipe[1]);
+    CHECK(read(Pipe[0], EEPROM.Flash, sizeof(EEPROM.Flash)) == sizeof(EEPROM.Flash));
+    memcpy(EEPROM.getDataPtr(), EEPROM.Flash, sizeof(EEPROM.Flash));
+    close(Pipe[0]);
+    waitpid(Pid, &Status, 0);
+    CHECK(WIFEXITED(Status) && (WEXITSTATUS(Status) == 0));
+
+    ConsistsPtr = reinterpret_cast<const EepCfg::consist*>(&EEPROM.Flash[EepCfg::ConsistAddress]);
+    CHECK_EQUAL(1, ConsistsPtr->Valid);
+    CHECK_EQUAL(CONSIST_LEAD, ConsistsPtr->Entry[0].Lead);
+    CHECK_EQUAL(1, ConsistsPtr->Entry[0].FunctionsAll);
+    CHECK_EQUAL(2, ConsistsPtr->Entry[0].Members);
+    CHECK_EQUAL(CONSIST_MEMBER_28, ConsistsPtr->Entry[0].Member[0].Address);
+    CHECK_EQUAL(0, ConsistsPtr->Entry[0].Member[0].Flip);
+    CHECK_EQUAL(CONSIST_MEMBER_14, ConsistsPtr->Entry[0].Member[1].Address);
+    CHECK_EQUAL(1, ConsistsPtr->Entry[0].Member[1].Flip);
+}
+
+/***********************************************************************************************************************
+ * Count the loc info requests of a loc since the given record index.
+ */
+static uint32_t ConsistInfoRequests(uint16_t Address, size_t From)
+{
+    uint32_t Result = 0;
+    size_t Index;
+
+    for (Index = From; Index < host::Station.Records.size(); Index++)
+    {
+        if ((host::Z21IsLocInfoGet(host::Station.Records[Index].Data) == true)
+            && (host::Z21Address(host::Station.Records[Index].Data) == Address))
+        {
+            Result++;
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Check the records of a type since the given record index: each datagram with a record of the lead must hold the
+ * records of both members and no member record may leave in another datagram. Returns the records of the lead.
+ */
+static uint32_t ConsistTicks(bool (*CheckPtr)(const std::vector<uint8_t>&), size_t From)
+{
+    std::map<uint32_t, uint32_t> Leads;
+    std::map<uint32_t, uint32_t> Members;
+    std::map<uint32_t, uint32_t>::const_iterator It;
+    uint32_t Result = 0;
+    size_t Index;
+
+    for (Index = From; Index < host::Station.Records.size(); Index++)
+    {
+        if (CheckPtr(host::Station.Records[Index].Data) == true)
+        {
+            if (host::Z21Address(host::Station.Records[Index].Data) == CONSIST_LEAD)
+            {
+                Leads[host::Station.Records[Index].Datagram]++;
+                Result++;
+            }
+            else
+            {
+                Members[host::Station.Records[Index].Datagram]++;
+            }
+        }
+    }
+
+    for (It = Members.begin(); It != Members.end(); ++It)
+    {
+        CHECK_EQUAL(2 * Leads[It->first], It->second);
+    }
+    CHECK_EQUAL(Leads.size(), Members.size());
+
+    return (Result);
+}
+
+int main(void)
+{
+    const host::stationLoc* LeadPtr;
+    size_t From;
+    uint32_t Drives;
+    uint32_t Functions;
+    uint32_t Index;
+
+    host::Station.Locs[CONSIST_LEAD].Steps      = 4;
+    host::Station.Locs[CONSIST_MEMBER_28].Steps = 2;
+    host::Station.Locs[CONSIST_MEMBER_14].Steps = 0;
+
+    ConsistPowerCycle();
+
+    /* The speed steps of the members are requested with the loc info of the lead, the boot clears the records. */
+    CHECK(host::Boot(0x00) == true);
+    host::Run(100);
+    CHECK_EQUAL(1, ConsistInfoRequests(CONSIST_MEMBER_28, 0));
+    CHECK_EQUAL(1, ConsistInfoRequests(CONSIST_MEMBER_14, 0));
+
+    From = host::Station.Records.size();
+    for (Index = 0; Index < CONSIST_DETENTS; Index++)
+    {
+        host::PulseSwitch(turn, 1);
+        host::Run(CONSIST_DETENT_MS);
+    }
+    host::Run(500);
+    wmcApp::EventQueueGet().PushButton(button_1);
+    host::Run(100);
+
+    Drives    = ConsistTicks(host::Z21IsDrive, From);
+    Functions = ConsistTicks(host::Z21IsFunction, From);
+    LeadPtr   = &host::Station.Locs[CONSIST_LEAD];
+
+    printf("consist: %u drive and %u function commands of the lead, members in the same datagram, speed %u of 126: "
+           "member %u at %u of 28, member %u at %u of 14 reverse\n",
+        Drives, Functions, LeadPtr->Speed, CONSIST_MEMBER_28, host::Station.Locs[CONSIST_MEMBER_28].Speed,
+        CONSIST_MEMBER_14, host::Station.Locs[CONSIST_MEMBER_14].Speed);
+
+    CHECK(Drives > 0);
+    CHECK_EQUAL(1, Functions);
+    CHECK_EQUAL(Drives, wmcApp::ConsistStatisticsGet().Drives);
+    CHECK_EQUAL(2 * Drives, wmcApp::ConsistStatisticsGet().Commands);
+    CHECK(LeadPtr->Speed > 14);
+
+    /* Scaled to the speed steps of the member, rounded. */
+    CHECK_EQUAL(2, host::Station.Locs[CONSIST_MEMBER_28].Steps);
+    CHECK_EQUAL(((LeadPtr->Speed * 28) + 63) / 126, host::Station.Locs[CONSIST_MEMBER_28].Speed);
+    CHECK_EQUAL(LeadPtr->Forward, host::Station.Locs[CONSIST_MEMBER_28].Forward);
+    CHECK_EQUAL(0, host::Station.Locs[CONSIST_MEMBER_14].Steps);
+    CHECK_EQUAL(((LeadPtr->Speed * 14) + 63) / 126, host::Station.Locs[CONSIST_MEMBER_14].Speed);
+    CHECK(LeadPtr->Forward != host::Station.Locs[CONSIST_MEMBER_14].Forward);
+    CHECK_EQUAL(LeadPtr->Functions, host::Station.Locs[CONSIST_MEMBER_28].Functions);
+    CHECK_EQUAL(LeadPtr->Functions, host::Station.Locs[CONSIST_MEMBER_14].Functions);
+
+    /* Removing the first member is stored. */
+    ConsistMenuEnter();
+    CHECK(strcmp(host::Tft.Status, "MEMBER 10 FWD F") == 0);
+    wmcApp::EventQueueGet().PushButton(button_1);
+    host::Run(100);
+    CHECK_EQUAL(1, reinterpret_cast<const EepCfg::consist*>(&EEPROM.Flash[EepCfg::ConsistAddress])->Entry[0].Members);
+    ConsistMenuLeave();
+
+    return (host::Result("wmc_consist_test"));
+}
@@ -0,0 +1,114 @@
+/***********************************************************************************************************************
+   @file   wmc_eep_test.cpp
+   @brief  EEPROM write back layer: writes of a transaction end in one commit, unchanged data is not committed and
+           dirty data is committed after the idle time.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "host_test.h"
+#include "wmc_eep.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+#define EEP_TEST_ADDRESS 3000 /* Unused by the application. */
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * A transaction of scattered writes is one commit, the dirty range covers the first up to the last address.
+ */
+static void EepTransaction(void)
+{
+    wmcEep Eep;
+    uint32_t Commits = EEPROM.Commits;
+    uint32_t Value   = 0x12345678;
+
+    Eep.Write(EEP_TEST_ADDRESS + 10, 1);
+    Eep.Write(EEP_TEST_ADDRESS, 2);
+    Eep.Put(EEP_TEST_ADDRESS + 20, Value);
+    CHECK(Eep.Dirty() == true);
+    CHECK_EQUAL(Commits, EEPROM.Commits);
+
+    Eep.Commit();
+    CHECK(Eep.Dirty() == false);
+    CHECK_EQUAL(Commits + 1, EEPROM.Commits);
+    CHECK_EQUAL(1, Eep.StatisticsGet().Commits);
+    CHECK_EQUAL(6, Eep.StatisticsGet().BytesWritten);
+    CHECK_EQUAL(24, Eep.StatisticsGet().BytesCommitted);
+    CHECK_EQUAL(2, EEPROM.Flash[EEP_TEST_ADDRESS]);
+    CHECK_EQUAL(0x78, EEPROM.Flash[EEP_TEST_ADDRESS + 20]);
+
+    /* Nothing dirty, no commit. */
+    Eep.Commit();
+    CHECK_EQUAL(Commits + 1, EEPROM.Commits);
+}
+
+/***********************************************************************************************************************
+ * Writing the present content does not make the EEPROM dirty.
+ */
+static void EepUnchanged(void)
+{
+    wmcEep Eep;
+    uint32_t Commits = EEPROM.Commits;
+    uint8_t Index;
+
+    for (Index = 0; Index < 100; Index++)
+    {
+        Eep.Write(EEP_TEST_ADDRESS, 2);
+        Eep.Write(EEP_TEST_ADDRESS + 10, 1);
+        Eep.Update();
+        Eep.Commit();
+    }
+
+    CHECK(Eep.Dirty() == false);
+    CHECK_EQUAL(Commits, EEPROM.Commits);
+    CHECK_EQUAL(200, Eep.StatisticsGet().BytesUnchanged);
+    CHECK_EQUAL(0, Eep.StatisticsGet().BytesWritten);
+}
+
+/***********************************************************************************************************************
+ * Repeated writes, e.g. a selected loc changing with each pulse switch detent, are committed once after the idle
+ * time.
+ */
+static void EepIdleCommit(void)
+{
+    wmcEep Eep;
+    uint32_t Commits = EEPROM.Commits;
+    uint8_t Index;
+
+    for (Index = 0; Index < 50; Index++)
+    {
+        Eep.Write(EEP_TEST_ADDRESS + 30, Index);
+        Eep.Write(EEP_TEST_ADDRESS + 31, Index + 1);
+        host::TimeAdvance(100000);
+        Eep.Update();
+    }
+    CHECK_EQUAL(Commits, EEPROM.Commits);
+
+    host::TimeAdvance(1800000);
+    Eep.Update();
+    CHECK_EQUAL(Commits, EEPROM.Commits);
+
+    host::TimeAdvance(100000);
+    Eep.Update();
+    CHECK_EQUAL(Commits + 1, EEPROM.Commits);
+    CHECK_EQUAL(2, Eep.StatisticsGet().BytesCommitted);
+    CHECK_EQUAL(49, EEPROM.Flash[EEP_TEST_ADDRESS + 30]);
+
+    printf("eep: 100 writes in 5 sec, %u commit, previous path with a commit per write %u commits\n",
+        Eep.StatisticsGet().Commits, Eep.StatisticsGet().BytesWritten);
+}
+
+int main(void)
+{
+    EepTransaction();
+    EepUnchanged();
+    EepIdleCommit();
+
+    return (host::Result("wmc_eep_test"));
+}
@@ -0,0 +1,176 @@
+/***********************************************************************************************************************
+   @file   wmc_event_queue_test.cpp
+   @brief  Input event queue: a producer and a consumer thread exchange events without loss or reordering, and a
+           sampled button and the pulse switch are queued and dispatched by the 5 msec update of the application.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "host_test.h"
+#include "wmc_event_queue.h"
+#include <thread>
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+#define EVENT_QUEUE_EVENTS 200000  /* Events exchanged by the threads. */
+#define EVENT_QUEUE_POWER_EACH 64  /* Each so many events a power button press is queued. */
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+static wmcEventQueue EventQueue;
+static uint32_t EventQueueFull;
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Producer, stands for the interrupts. A full lane is retried like a user turning the knob again.
+ */
+static void EventQueueProducer(void)
+{
+    uint32_t Index;
+
+    for (Index = 0; Index < EVENT_QUEUE_EVENTS; Index++)
+    {
+        while (EventQueue.PushPulseSwitch(static_cast<int8_t>(Index & 0x7F), turn) == false)
+        {
+            EventQueueFull++;
+            std::this_thread::yield();
+        }
+
+        if ((Index % EVENT_QUEUE_POWER_EACH) == 0)
+        {
+            while (EventQueue.PushPowerButton() == false)
+            {
+                EventQueueFull++;
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ * Threaded producer and consumer: every event arrives once and in order.
+ */
+static void EventQueueStress(void)
+{
+    wmcEventQueue::entry Entry;
+    uint32_t PulseSwitch = 0;
+    uint32_t Power       = 0;
+    uint32_t Errors      = 0;
+    uint64_t StartNs     = host::WallNs();
+
+    std::thread Producer(EventQueueProducer);
+
+    while ((PulseSwitch < EVENT_QUEUE_EVENTS) || (Power < (EVENT_QUEUE_EVENTS / EVENT_QUEUE_POWER_EACH)))
+    {
+        if (EventQueue.Pop(Entry) == true)
+        {
+            if (Entry.Type == wmcEventQueue::pulseSwitch)
+            {
+                if (Entry.Delta != static_cast<int8_t>(PulseSwitch & 0x7F))
+                {
+                    Errors++;
+                }
+                PulseSwitch++;
+            }
+            else if (Entry.Type == wmcEventQueue::powerButton)
+            {
+                Power++;
+            }
+            else
+            {
+                Errors++;
+            }
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    Producer.join();
+
+    printf("event queue: %u pulse switch and %u power events in %.1f ms, %u pushes on a full lane\n", PulseSwitch,
+        Power, (host::WallNs() - StartNs) / 1e6, EventQueueFull);
+
+    CHECK_EQUAL(0, Errors);
+    CHECK(EventQueue.Pop(Entry) == false);
+    CHECK_EQUAL(EVENT_QUEUE_EVENTS + (EVENT_QUEUE_EVENTS / EVENT_QUEUE_POWER_EACH), EventQueue.StatisticsGet().Queued);
+    CHECK_EQUAL(EventQueueFull, EventQueue.StatisticsGet().Overflow);
+}
+
+/***********************************************************************************************************************
+ * Only the 5 msec update event of the sketch, no other main loop work.
+ */
+static void EventQueueTicks(uint32_t Ms)
+{
+    uint32_t Index;
+
+    for (Index = 0; Index < Ms; Index += 5)
+    {
+        host::TimeAdvance(5000);
+        send_event(updateEvent5msec());
+    }
+}
+
+/***********************************************************************************************************************
+ * A sampled button is queued and handled once by the 5 msec update.
+ */
+static void EventQueueButton(void)
+{
+    uint32_t Queued = wmcApp::EventQueueStatisticsGet().Queued;
+    size_t Records;
+
+    CHECK(host::Boot(0x00) == true);
+    Records = host::Station.Records.size();
+
+    host::AnalogValue = host::AdcButtonValues[1];
+    host::Run(100);
+    host::AnalogValue = host::AdcButtonValues[6];
+    host::Run(100);
+
+    CHECK_EQUAL(Queued + 1, wmcApp::EventQueueStatisticsGet().Queued);
+    CHECK_EQUAL(1, host::Count(host::Z21IsFunction, Records));
+}
+
+/***********************************************************************************************************************
+ * The firmware path without the host main loop: a sampled button and a pulse switch turn are handled once, their
+ * commands leave with the transmit of the update which dispatched them.
+ */
+static void EventQueueUpdate(void)
+{
+    size_t Records;
+    size_t Datagrams;
+
+    host::Run(500);
+    Records = host::Station.Records.size();
+
+    host::AnalogValue = host::AdcButtonValues[1];
+    EventQueueTicks(100);
+    host::AnalogValue = host::AdcButtonValues[6];
+    EventQueueTicks(100);
+    CHECK_EQUAL(1, host::Count(host::Z21IsFunction, Records));
+
+    Records   = host::Station.Records.size();
+    Datagrams = host::Udp.Tx.size();
+    host::PulseSwitch(turn, 1);
+    EventQueueTicks(5);
+    CHECK_EQUAL(1, host::Count(host::Z21IsDrive, Records));
+    CHECK_EQUAL(Datagrams + 1, host::Udp.Tx.size());
+    EventQueueTicks(100);
+    CHECK_EQUAL(1, host::Count(host::Z21IsDrive, Records));
+}
+
+int main(void)
+{
+    EventQueueStress();
+    EventQueueButton();
+    EventQueueUpdate();
+
+    return (host::Result("wmc_event_queue_test"));
+}
@@ -0,0 +1,129 @@
+/***********************************************************************************************************************
+   @file   wmc_handshake_test.cpp
+   @brief  Connection handshake: broadcast flags, status request and loc info request leave in one datagram and loc
+           control is reached one round trip after the UDP connection, compared with the previous sequential states.
+           A status request without reply is repeated.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "host_test.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+#define HANDSHAKE_RX_INTERVAL 50 /* Receive poll interval during the handshake in msec. */
+#define HANDSHAKE_RETRY_MS 1200  /* Time without replies, status retried each 500 msec. */
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Time of the previous sequential states: broadcast flags and a fixed step, then status and loc info each waiting for
+ * their reply, which is seen at the next receive poll.
+ */
+static uint32_t HandshakePreviousMs(uint32_t LatencyMs)
+{
+    uint32_t RoundTripMs = ((LatencyMs + HANDSHAKE_RX_INTERVAL - 1) / HANDSHAKE_RX_INTERVAL) * HANDSHAKE_RX_INTERVAL;
+
+    return (HANDSHAKE_RX_INTERVAL + (2 * RoundTripMs));
+}
+
+/***********************************************************************************************************************
+ * Boot with the given latency of the command station and measure the time from the first reply to loc control.
+ */
+static void Handshake(uint32_t LatencyMs)
+{
+    const wmcBootLog::boot* BootPtr;
+    uint32_t HandshakeMs;
+    uint32_t Datagram = 0xFFFFFFFF;
+    bool Packed       = true;
+    bool StatusGet    = false;
+    size_t Index;
+
+    CHECK(host::Boot(0x02, LatencyMs * 1000) == true);
+
+    BootPtr     = wmcApp::BootLogGet(0);
+    HandshakeMs = BootPtr->Time[wmcBootLog::drivable] - BootPtr->Time[wmcBootLog::udpReply];
+
+    /* Broadcast flags, status and loc info requests of the handshake in the same datagram. */
+    for (Index = 0; Index < host::Station.Records.size(); Index++)
+    {
+        if (host::Z21IsLocInfoGet(host::Station.Records[Index].Data) == true)
+        {
+            Datagram = host::Station.Records[Index].Datagram;
+            break;
+        }
+    }
+    for (Index = 0; Index < host::Station.Records.size(); Index++)
+    {
+        if (host::Station.Records[Index].Datagram == Datagram)
+        {
+            if (host::Z21IsStatusGet(host::Station.Records[Index].Data) == true)
+            {
+                StatusGet = true;
+            }
+            else if ((host::Z21IsLocInfoGet(host::Station.Records[Index].Data) == false)
+                && (host::Station.Records[Index].Data[2] != 0x50))
+            {
+                Packed = false;
+            }
+        }
+    }
+    CHECK(StatusGet == true);
+    CHECK(Packed == true);
+
+    printf("handshake latency %u ms: %u ms from first reply to loc control, previous states %u ms\n", LatencyMs,
+        HandshakeMs, HandshakePreviousMs(LatencyMs));
+
+    CHECK(HandshakeMs < HandshakePreviousMs(LatencyMs));
+    CHECK(HandshakeMs <= (LatencyMs + HANDSHAKE_RX_INTERVAL + 10));
+}
+
+/***********************************************************************************************************************
+ * Back to loc control from the main menu while the command station does not reply: the status request is repeated
+ * until the reply is received.
+ */
+static void HandshakeRetry(void)
+{
+    uint32_t StatusGets = 0;
+    size_t From;
+    size_t Index;
+
+    CHECK(host::Boot(0x02) == true);
+    host::PulseSwitch(pushedlong, 0);
+    host::Run(100);
+
+    host::Station.Online = false;
+    From                 = host::Station.Records.size();
+    host::PulseSwitch(pushedNormal, 0);
+    host::Run(HANDSHAKE_RETRY_MS);
+
+    for (Index = From; Index < host::Station.Records.size(); Index++)
+    {
+        if (host::Z21IsStatusGet(host::Station.Records[Index].Data) == true)
+        {
+            StatusGets++;
+        }
+    }
+
+    host::Station.Online = true;
+    host::Run(600);
+
+    printf("handshake without reply: %u status requests in %u ms\n", StatusGets, HANDSHAKE_RETRY_MS);
+
+    CHECK(StatusGets >= (1 + (HANDSHAKE_RETRY_MS / 500)));
+    CHECK(strcmp(host::Tft.Status, "POWER OFF") == 0);
+}
+
+int main(void)
+{
+    Handshake(5);
+    Handshake(20);
+    Handshake(80);
+    HandshakeRetry();
+
+    return (host::Result("wmc_handshake_test"));
+}
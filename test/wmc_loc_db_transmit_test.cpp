@@ -0,0 +1,87 @@
+/***********************************************************************************************************************
+   @file   wmc_loc_db_transmit_test.cpp
+   @brief  Loc database transmit: each loc is transmitted once when the command station echoes it and the transfer
+           ends with the last echo, without the repeat delay.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "host_test.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+#define LOC_DB_LOCS 20           /* Locs imported, loc 3 is present in the WMC already. */
+#define LOC_DB_WINDOW 4          /* Locs transmitted each pacing interval by the application. */
+#define LOC_DB_INTERVAL_MS 50    /* Pacing interval of the application. */
+#define LOC_DB_REPEAT_DELAY 300  /* Delay before a repeat of the application. */
+#define LOC_DB_TIMEOUT_MS 3000   /* Maximum time of the transfer. */
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Import the locs with the track power off.
+ */
+static void LocDbImport(void)
+{
+    uint8_t Index;
+
+    for (Index = 0; Index < LOC_DB_LOCS; Index++)
+    {
+        host::UdpReceive(host::Z21LocLibData(static_cast<uint16_t>(100 + Index), Index, LOC_DB_LOCS, "LOC"));
+        host::Run(2);
+    }
+    host::Run(100);
+}
+
+int main(void)
+{
+    uint32_t NumberOfLocs = LOC_DB_LOCS + 1;
+    uint32_t PassMs       = ((NumberOfLocs + LOC_DB_WINDOW - 1) / LOC_DB_WINDOW - 1) * LOC_DB_INTERVAL_MS;
+    uint32_t Transmitted  = 0;
+    uint32_t TransferMs   = 0;
+    uint32_t Menus;
+    size_t From;
+    size_t Index;
+
+    CHECK(host::Boot(0x02) == true);
+    LocDbImport();
+
+    /* Main menu 2 and its loc data transmit key. */
+    host::PulseSwitch(pushedlong, 0);
+    host::Run(100);
+    host::PulseSwitch(turn, 1);
+    host::Run(100);
+
+    From  = host::Station.Records.size();
+    Menus = host::Tft.Menus;
+    wmcApp::EventQueueGet().PushButton(button_3);
+    host::Run(5);
+    CHECK(strcmp(host::Tft.Status, "SEND LOC DATA") == 0);
+
+    while ((TransferMs < LOC_DB_TIMEOUT_MS) && (host::Tft.Menus == Menus))
+    {
+        host::Run(1);
+        TransferMs++;
+    }
+
+    for (Index = From; Index < host::Station.Records.size(); Index++)
+    {
+        if (host::Z21IsLocLibData(host::Station.Records[Index].Data) == true)
+        {
+            Transmitted++;
+        }
+    }
+
+    printf("loc database transmit of %u locs: %u records, back in the menu after %u msec, pass of %u msec\n",
+        NumberOfLocs, Transmitted, TransferMs, PassMs);
+
+    CHECK_EQUAL(Menus + 1, host::Tft.Menus);
+    CHECK_EQUAL(NumberOfLocs, Transmitted);
+    CHECK(TransferMs < (PassMs + LOC_DB_REPEAT_DELAY));
+
+    return (host::Result("wmc_loc_db_transmit_test"));
+}
@@ -0,0 +1,191 @@
+/***********************************************************************************************************************
+   @file   wmc_loc_import_test.cpp
+   @brief  Loc library import: staged locs are stored with one sort and few commits, the commit timer is stopped
+           when all locs are received and stores the staged locs when the reception is interrupted.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "host_test.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+#define LOC_IMPORT_LOCS 50         /* Locs in the loc library of the command station. */
+#define LOC_IMPORT_INTERVAL 2      /* Time between loc library records in msec. */
+#define LOC_IMPORT_INTERRUPTED 10  /* Records received before the reception is interrupted. */
+#define LOC_IMPORT_TIMEOUT_MS 3000 /* More than the commit timeout of the application. */
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+static uint16_t LocImportAddress[LOC_IMPORT_LOCS];
+static LocLib LocImportPrevious; /* Library of the previous path, stored and sorted for each record. */
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Addresses of the loc library in a mixed order, loc 3 is present in the WMC already.
+ */
+static void LocImportAddressesCreate(void)
+{
+    uint8_t Index;
+
+    for (Index = 0; Index < LOC_IMPORT_LOCS; Index++)
+    {
+        LocImportAddress[Index] = static_cast<uint16_t>(((Index * 37) % LOC_IMPORT_LOCS) * 10 + 10);
+    }
+}
+
+/***********************************************************************************************************************
+ * Number of locs and sorted addresses in the flash image.
+ */
+static uint8_t LocImportStored(bool& Sorted)
+{
+    uint8_t Number           = EEPROM.Flash[EepCfg::locLibEepromAddressNumOfLocs];
+    uint16_t AddressPrevious = 0;
+    uint16_t Address;
+    uint8_t Index;
+
+    Sorted = true;
+    for (Index = 0; Index < Number; Index++)
+    {
+        Address = (EEPROM.Flash[EepCfg::locLibEepromAddressData + (Index * 20)] << 8)
+            | EEPROM.Flash[EepCfg::locLibEepromAddressData + (Index * 20) + 1];
+        if (Address <= AddressPrevious)
+        {
+            Sorted = false;
+        }
+        AddressPrevious = Address;
+    }
+
+    return (Number);
+}
+
+/***********************************************************************************************************************
+ * Send the loc library records from First up to Last.
+ */
+static void LocImportSend(uint8_t First, uint8_t Last, uint8_t Total)
+{
+    uint8_t Index;
+
+    for (Index = First; Index < Last; Index++)
+    {
+        host::UdpReceive(host::Z21LocLibData(LocImportAddress[Index], Index, Total, "LOC"));
+        host::Run(LOC_IMPORT_INTERVAL);
+    }
+}
+
+/***********************************************************************************************************************
+ * Complete loc library: all locs stored sorted at once, the commit timer does not expire afterwards.
+ */
+static void LocImportComplete(uint32_t& Commits, uint32_t& BytesFlashed)
+{
+    uint32_t CommitsStart      = EEPROM.Commits;
+    uint32_t BytesFlashedStart = EEPROM.BytesFlashed;
+    uint32_t Expired;
+    bool Sorted;
+
+    LocImportSend(0, LOC_IMPORT_LOCS, LOC_IMPORT_LOCS);
+    host::Run(100);
+
+    Commits      = EEPROM.Commits - CommitsStart;
+    BytesFlashed = EEPROM.BytesFlashed - BytesFlashedStart;
+
+    CHECK_EQUAL(LOC_IMPORT_LOCS + 1, LocImportStored(Sorted));
+    CHECK(Sorted == true);
+    CHECK(strcmp(host::Tft.Status, "POWER OFF") == 0);
+
+    Expired = wmcApp::TimerStatisticsGet().Expired;
+    host::Run(LOC_IMPORT_TIMEOUT_MS);
+    CHECK_EQUAL(Expired, wmcApp::TimerStatisticsGet().Expired);
+}
+
+/***********************************************************************************************************************
+ * Interrupted loc library: the received locs are stored when the commit timer expires.
+ */
+static void LocImportInterrupted(void)
+{
+    uint32_t Expired = wmcApp::TimerStatisticsGet().Expired;
+    uint8_t Index;
+    bool Sorted;
+
+    /* New addresses, the complete import stored the others. */
+    for (Index = 0; Index < LOC_IMPORT_LOCS; Index++)
+    {
+        LocImportAddress[Index] += 5;
+    }
+
+    LocImportSend(0, LOC_IMPORT_INTERRUPTED, LOC_IMPORT_LOCS);
+    CHECK_EQUAL(LOC_IMPORT_LOCS + 1, LocImportStored(Sorted));
+
+    host::Run(LOC_IMPORT_TIMEOUT_MS);
+    CHECK_EQUAL(Expired + 1, wmcApp::TimerStatisticsGet().Expired);
+    CHECK_EQUAL(LOC_IMPORT_LOCS + 1 + LOC_IMPORT_INTERRUPTED, LocImportStored(Sorted));
+    CHECK(Sorted == true);
+    CHECK(strcmp(host::Tft.Status, "POWER OFF") == 0);
+}
+
+/***********************************************************************************************************************
+ * Previous path: each record stored and the library sorted at once.
+ */
+static void LocImportPreviousPath(uint32_t& Commits, uint32_t& BytesFlashed, uint32_t& SortPasses)
+{
+    uint8_t Functions[5]       = { 0, 1, 2, 3, 4 };
+    char Name[]                = "LOC";
+    uint32_t CommitsStart;
+    uint32_t BytesFlashedStart;
+    int Address;
+    uint8_t Index;
+
+    /* Erased loc data like before the import of the application. */
+    for (Address = EepCfg::locLibEepromAddressData;
+         Address < (EepCfg::locLibEepromAddressData + (LocLib::LOCS_MAX * 20)); Address++)
+    {
+        EEPROM.write(Address, 0xFF);
+    }
+    LocImportAddressesCreate();
+    LocImportPrevious.InitialLocStore();
+    CommitsStart      = EEPROM.Commits;
+    BytesFlashedStart = EEPROM.BytesFlashed;
+
+    for (Index = 0; Index < LOC_IMPORT_LOCS; Index++)
+    {
+        LocImportPrevious.StoreLoc(LocImportAddress[Index], Functions, Name, LocLib::storeAddNoAutoSelect);
+        LocImportPrevious.LocBubbleSort();
+    }
+
+    Commits      = EEPROM.Commits - CommitsStart;
+    BytesFlashed = EEPROM.BytesFlashed - BytesFlashedStart;
+    SortPasses   = LocImportPrevious.SortPasses;
+}
+
+int main(void)
+{
+    uint32_t Commits;
+    uint32_t BytesFlashed;
+    uint32_t PreviousCommits;
+    uint32_t PreviousBytesFlashed;
+    uint32_t PreviousSortPasses;
+
+    CHECK(host::Boot(0x02) == true);
+
+    LocImportAddressesCreate();
+    LocImportComplete(Commits, BytesFlashed);
+    LocImportInterrupted();
+
+    /* Last, the previous path overwrites the loc data of the application. */
+    LocImportPreviousPath(PreviousCommits, PreviousBytesFlashed, PreviousSortPasses);
+
+    printf("loc import of %u locs: %u commits and %u bytes flashed, previous path %u commits, %u bytes flashed and %u "
+           "sort passes\n",
+        LOC_IMPORT_LOCS, Commits, BytesFlashed, PreviousCommits, PreviousBytesFlashed, PreviousSortPasses);
+
+    CHECK(Commits < PreviousCommits);
+    CHECK(BytesFlashed < PreviousBytesFlashed);
+
+    return (host::Result("wmc_loc_import_test"));
+}
@@ -0,0 +1,186 @@
+/***********************************************************************************************************************
+   @file   wmc_loc_index_test.cpp
+   @brief  Loc address index: sorted binary insertion and binary search, with a benchmark against the previous path
+           of a linear search and a bubble sort after each add.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "host_test.h"
+#include "wmc_loc_index.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+#define LOC_INDEX_ROUNDS 200    /* Libraries filled by the benchmark. */
+#define LOC_INDEX_LOCS 128      /* Locs added to each library, the size of the index. */
+#define LOC_INDEX_LOOKUPS 10000 /* Lookups done in each library. */
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+static uint16_t LocIndexPrevious[LOC_INDEX_LOCS]; /* Library of the previous path. */
+static uint8_t LocIndexPreviousCount;
+static uint32_t LocIndexRandom = 12345;
+static LocLib LocIndexLibrary; /* Empty library, makes the index valid before the locs are inserted. */
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Loc address 1..9999 from a fixed pseudo random sequence, so all runs are equal.
+ */
+static uint16_t LocIndexAddress(void)
+{
+    LocIndexRandom = (LocIndexRandom * 1103515245) + 12345;
+    return (static_cast<uint16_t>(((LocIndexRandom >> 16) % 9999) + 1));
+}
+
+/***********************************************************************************************************************
+ * Previous path: linear search like LocLib::CheckLoc.
+ */
+static uint8_t LocIndexPreviousCheck(uint16_t Address)
+{
+    uint8_t Result = 255;
+    uint8_t Index;
+
+    for (Index = 0; Index < LocIndexPreviousCount; Index++)
+    {
+        if (LocIndexPrevious[Index] == Address)
+        {
+            Result = Index;
+            break;
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Previous path: append and bubble sort like LocLib::StoreLoc followed by LocLib::LocBubbleSort.
+ */
+static void LocIndexPreviousAdd(uint16_t Address)
+{
+    bool Swapped = true;
+    uint16_t Data;
+    uint8_t Index;
+
+    if (LocIndexPreviousCheck(Address) == 255)
+    {
+        LocIndexPrevious[LocIndexPreviousCount] = Address;
+        LocIndexPreviousCount++;
+
+        while (Swapped == true)
+        {
+            Swapped = false;
+            for (Index = 1; Index < LocIndexPreviousCount; Index++)
+            {
+                if (LocIndexPrevious[Index - 1] > LocIndexPrevious[Index])
+                {
+                    Data                        = LocIndexPrevious[Index - 1];
+                    LocIndexPrevious[Index - 1] = LocIndexPrevious[Index];
+                    LocIndexPrevious[Index]     = Data;
+                    Swapped                     = true;
+                }
+            }
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ * Both paths give the same result for a library filled in random order.
+ */
+static void LocIndexEqual(void)
+{
+    wmcLocIndex LocIndex;
+    uint16_t Address;
+    uint32_t Index;
+
+    LocIndex.Build(LocIndexLibrary);
+    LocIndexPreviousCount = 0;
+    while (LocIndexPreviousCount < LOC_INDEX_LOCS)
+    {
+        Address = LocIndexAddress();
+        LocIndexPreviousAdd(Address);
+        LocIndex.Insert(Address);
+    }
+
+    CHECK_EQUAL(LOC_INDEX_LOCS, LocIndex.Count());
+    CHECK(LocIndex.Valid() == true);
+
+    for (Index = 1; Index <= 9999; Index++)
+    {
+        CHECK_EQUAL(LocIndexPreviousCheck(Index), LocIndex.Find(Index));
+    }
+
+    /* One more loc does not fit, the index is no longer valid and the library must be searched. */
+    do
+    {
+        Address = LocIndexAddress();
+    } while (LocIndex.Find(Address) != wmcLocIndex::NOT_FOUND);
+    CHECK_EQUAL(wmcLocIndex::NOT_FOUND, LocIndex.Insert(Address));
+    CHECK(LocIndex.Valid() == false);
+}
+
+/***********************************************************************************************************************
+ * Fill libraries and look up random addresses with both paths.
+ */
+static void LocIndexBenchmark(void)
+{
+    uint64_t StartNs;
+    uint64_t PreviousNs = 0;
+    uint64_t IndexNs    = 0;
+    uint32_t FoundPrevious = 0;
+    uint32_t FoundIndex    = 0;
+    uint32_t Round;
+    uint32_t Index;
+    uint32_t Seed;
+
+    for (Round = 0; Round < LOC_INDEX_ROUNDS; Round++)
+    {
+        wmcLocIndex LocIndex;
+        LocIndex.Build(LocIndexLibrary);
+        Seed = LocIndexRandom;
+
+        StartNs               = host::WallNs();
+        LocIndexPreviousCount = 0;
+        for (Index = 0; Index < LOC_INDEX_LOCS; Index++)
+        {
+            LocIndexPreviousAdd(LocIndexAddress());
+        }
+        for (Index = 0; Index < LOC_INDEX_LOOKUPS; Index++)
+        {
+            FoundPrevious += (LocIndexPreviousCheck(LocIndexAddress()) != 255) ? 1 : 0;
+        }
+        PreviousNs += host::WallNs() - StartNs;
+
+        LocIndexRandom = Seed;
+        StartNs        = host::WallNs();
+        for (Index = 0; Index < LOC_INDEX_LOCS; Index++)
+        {
+            LocIndex.Insert(LocIndexAddress());
+        }
+        for (Index = 0; Index < LOC_INDEX_LOOKUPS; Index++)
+        {
+            FoundIndex += (LocIndex.Find(LocIndexAddress()) != wmcLocIndex::NOT_FOUND) ? 1 : 0;
+        }
+        IndexNs += host::WallNs() - StartNs;
+    }
+
+    printf("loc index benchmark: %u inserts and %u lookups, previous path %.2f ms, index %.2f ms, %.1f times faster\n",
+        LOC_INDEX_ROUNDS * LOC_INDEX_LOCS, LOC_INDEX_ROUNDS * LOC_INDEX_LOOKUPS, PreviousNs / 1e6, IndexNs / 1e6,
+        static_cast<double>(PreviousNs) / IndexNs);
+
+    CHECK_EQUAL(FoundPrevious, FoundIndex);
+    CHECK(IndexNs < PreviousNs);
+}
+
+int main(void)
+{
+    LocIndexEqual();
+    LocIndexBenchmark();
+
+    return (host::Result("wmc_loc_index_test"));
+}
@@ -0,0 +1,112 @@
+/***********************************************************************************************************************
+   @file   wmc_power_button_test.cpp
+   @brief  Power button: the button_power event of the sketch and a press queued in the priority lane take the same
+           fast path, the power off command leaves ahead of the transmit queue once per press and the track stays
+           off. Measures the press to packet latency.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "host_test.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+#define POWER_BUTTON_PRESSES 25      /* Presses measured. */
+#define POWER_BUTTON_SETTLE 300      /* Time after the press, the control unit reports the track power off. */
+#define POWER_BUTTON_LATENCY_MAX 6   /* Maximum press to packet latency, a queued press waits for the 5 msec update. */
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Press the power button, by the sketch or queued, at an offset in usec within a msec. Returns the time from press to
+ * the power off record.
+ */
+static uint32_t PowerButtonPress(uint32_t OffsetUs, bool Queued)
+{
+    pushButtonsEvent ButtonEvent;
+    uint32_t LatencyUs = 0xFFFFFFFF;
+    uint32_t PowerOffs = 0;
+    uint32_t PowerOns  = 0;
+    size_t From        = host::Station.Records.size();
+    uint64_t PressUs;
+    size_t Index;
+
+    /* Knob turned while pressing, the transmit queue holds speed commands. */
+    host::PulseSwitch(turn, 1);
+    host::TimeAdvance(OffsetUs);
+    PressUs = host::TimeUs;
+    if (Queued == true)
+    {
+        CHECK(wmcApp::EventQueueGet().PushPowerButton() == true);
+    }
+    else
+    {
+        ButtonEvent.Button = button_power;
+        send_event(ButtonEvent);
+    }
+    host::TimeAdvance(1000 - OffsetUs);
+    host::Run(POWER_BUTTON_SETTLE);
+
+    for (Index = From; Index < host::Station.Records.size(); Index++)
+    {
+        if (host::Z21IsPowerOff(host::Station.Records[Index].Data) == true)
+        {
+            PowerOffs++;
+            LatencyUs = static_cast<uint32_t>(host::Station.Records[Index].TimeUs - PressUs);
+
+            /* Ahead of the queue: the command has a datagram of its own. */
+            CHECK_EQUAL(1, host::Z21Records(host::Udp.Tx[host::Station.Records[Index].Datagram].Data).size());
+        }
+        else if (host::Z21IsPowerOn(host::Station.Records[Index].Data) == true)
+        {
+            PowerOns++;
+        }
+    }
+
+    /* Handled once, the track is not switched on again by the same press. */
+    CHECK_EQUAL(1, PowerOffs);
+    CHECK_EQUAL(0, PowerOns);
+    CHECK_EQUAL(0x02, host::Station.Status);
+    CHECK(strcmp(host::Tft.Status, "POWER OFF") == 0);
+
+    return (LatencyUs);
+}
+
+int main(void)
+{
+    uint32_t Presses    = wmcApp::PowerButtonStatisticsGet().Presses;
+    uint32_t LatencyMax = 0;
+    uint32_t Latency;
+    uint32_t Index;
+
+    CHECK(host::Boot(0x00) == true);
+
+    for (Index = 0; Index < POWER_BUTTON_PRESSES; Index++)
+    {
+        /* Power on again by the control unit. */
+        host::Station.Status = 0x00;
+        host::UdpReceive(host::Z21PowerBroadcast(0x00));
+        host::Run(100 + (Index * 7));
+        CHECK(strcmp(host::Tft.Status, "POWER ON") == 0);
+
+        Latency = PowerButtonPress((Index * 137) % 1000, (Index % 2) != 0);
+        CHECK(Latency != 0xFFFFFFFF);
+        if (Latency > LatencyMax)
+        {
+            LatencyMax = Latency;
+        }
+    }
+
+    printf("power button: %u presses by the sketch and queued, each handled once, press to packet latency max %.1f "
+           "ms, queued press max %.1f ms\n",
+        POWER_BUTTON_PRESSES, LatencyMax / 1000.0, wmcApp::PowerButtonStatisticsGet().LatencyMax / 1000.0);
+
+    CHECK_EQUAL(Presses + POWER_BUTTON_PRESSES, wmcApp::PowerButtonStatisticsGet().Presses);
+    CHECK(LatencyMax <= (POWER_BUTTON_LATENCY_MAX * 1000));
+
+    return (host::Result("wmc_power_button_test"));
+}
@@ -0,0 +1,150 @@
+/***********************************************************************************************************************
+   @file   wmc_pulse_accel_test.cpp
+   @brief  Pulse switch acceleration: replays a knob trace of a user turning fast towards a target and slowing down
+           near it, with and without acceleration. Counts the events and drive commands saved for the same end value.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "host_test.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+#define KNOB_LOC 3             /* Selected loc after boot. */
+#define KNOB_FAST_MS 12        /* Time between detents when turning fast. */
+#define KNOB_SLOW_MS 150       /* Time between detents near the target. */
+#define KNOB_NEAR 10           /* Distance to the target from which the user turns slow. */
+#define KNOB_EVENTS_MAX 10000  /* Give up, the target is not reached. */
+#define KNOB_SPEED 120         /* Speed target, 128 speed steps. */
+#define KNOB_TURNOUT 2500      /* Turnout address target. */
+#define KNOB_LOC_ADDRESS 1234  /* Loc address target. */
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+
+/**
+ * Result of a replay.
+ */
+struct knobReplay
+{
+    uint32_t Events;   /* Pulse switch events. */
+    uint32_t Commands; /* Drive commands transmitted. */
+    uint16_t Value;    /* End value. */
+};
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Value shown on the display in each context.
+ */
+static uint16_t KnobSpeed(void) { return (host::Tft.LocInfo.Speed); }
+static uint16_t KnobTurnout(void) { return (host::Tft.TurnoutAddress); }
+static uint16_t KnobLocAddress(void) { return (host::Tft.LocAddress); }
+
+/***********************************************************************************************************************
+ * Turn like a user watching the display: fast while far from the target, one detent at a time near it.
+ */
+static knobReplay KnobReplay(uint16_t (*ValuePtr)(void), uint16_t Target)
+{
+    knobReplay Result = { 0, 0, 0 };
+    size_t From       = host::Station.Records.size();
+    uint16_t Distance;
+
+    while ((ValuePtr() != Target) && (Result.Events < KNOB_EVENTS_MAX))
+    {
+        Distance = (ValuePtr() > Target) ? (ValuePtr() - Target) : (Target - ValuePtr());
+        host::PulseSwitch(turn, (Target > ValuePtr()) ? 1 : -1);
+        host::Run((Distance > KNOB_NEAR) ? KNOB_FAST_MS : KNOB_SLOW_MS);
+        Result.Events++;
+    }
+
+    /* Let the last drive command leave. */
+    host::Run(500);
+    Result.Commands = host::Count(host::Z21IsDrive, From);
+    Result.Value    = ValuePtr();
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Replay all contexts with the given profiles, each context starts at the same value.
+ */
+static void KnobContexts(knobReplay* ResultPtr, bool Accelerate)
+{
+    /* One step per detent, and the default profiles of wmcPulseAccel. */
+    static const wmcPulseAccel::config Flat                               = { 80, 20, 1 };
+    static const wmcPulseAccel::config Profile[wmcPulseAccel::profileMax] = {
+        { 80, 20, 4 },
+        { 100, 15, 100 },
+        { 100, 15, 100 },
+    };
+    uint8_t Index;
+
+    for (Index = 0; Index < wmcPulseAccel::profileMax; Index++)
+    {
+        wmcApp::PulseAccelProfileSet(
+            static_cast<wmcPulseAccel::profile>(Index), (Accelerate == true) ? Profile[Index] : Flat);
+    }
+
+    /* Loc speed from stop. */
+    KnobReplay(KnobSpeed, 0);
+    ResultPtr[wmcPulseAccel::profileSpeed] = KnobReplay(KnobSpeed, KNOB_SPEED);
+    CHECK_EQUAL(KNOB_SPEED, host::Station.Locs[KNOB_LOC].Speed);
+
+    /* Turnout address from the first address, back to loc control afterwards. */
+    wmcApp::EventQueueGet().PushButton(button_5);
+    host::PulseSwitch(pushedShort, 0);
+    host::Run(100);
+    ResultPtr[wmcPulseAccel::profileTurnoutAddress] = KnobReplay(KnobTurnout, KNOB_TURNOUT);
+    host::PulseSwitch(pushedNormal, 0);
+    host::Run(500);
+
+    /* Loc address from the selected loc, the menu is entered with the track power off. Power on again afterwards. */
+    wmcApp::EventQueueGet().PushButton(button_power);
+    host::Run(100);
+    host::PulseSwitch(pushedlong, 0);
+    host::Run(100);
+    wmcApp::EventQueueGet().PushButton(button_1);
+    host::Run(100);
+    ResultPtr[wmcPulseAccel::profileLocAddress] = KnobReplay(KnobLocAddress, KNOB_LOC_ADDRESS);
+    wmcApp::EventQueueGet().PushButton(button_power);
+    host::Run(100);
+    wmcApp::EventQueueGet().PushButton(button_power);
+    host::Run(500);
+    host::PulseSwitch(pushedShort, 0);
+    host::Run(500);
+}
+
+int main(void)
+{
+    static const char* Names[wmcPulseAccel::profileMax] = { "speed", "turnout address", "loc address" };
+    knobReplay Flat[wmcPulseAccel::profileMax];
+    knobReplay Accelerated[wmcPulseAccel::profileMax];
+    uint8_t Index;
+
+    host::Station.Locs[KNOB_LOC].Steps = 4;
+    CHECK(host::Boot(0x00) == true);
+
+    KnobContexts(Flat, false);
+    KnobContexts(Accelerated, true);
+
+    for (Index = 0; Index < wmcPulseAccel::profileMax; Index++)
+    {
+        printf("knob %s: to %u with %u events %u drive commands, accelerated to %u with %u events %u drive "
+               "commands\n",
+            Names[Index], Flat[Index].Value, Flat[Index].Events, Flat[Index].Commands, Accelerated[Index].Value,
+            Accelerated[Index].Events, Accelerated[Index].Commands);
+
+        CHECK_EQUAL(Flat[Index].Value, Accelerated[Index].Value);
+        CHECK((Accelerated[Index].Events * 2) < Flat[Index].Events);
+    }
+
+    CHECK(Accelerated[wmcPulseAccel::profileSpeed].Commands < Flat[wmcPulseAccel::profileSpeed].Commands);
+
+    return (host::Result("wmc_pulse_accel_test"));
+}
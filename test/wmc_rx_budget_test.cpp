@@ -0,0 +1,91 @@
+/***********************************************************************************************************************
+   @file   wmc_rx_budget_test.cpp
+   @brief  Receive pump: the packet budget per tick, counted as exceeded only when data is left, and no datagram is
+           lost when the budget runs out.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "host_test.h"
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Queue datagrams with one loc info record each.
+ */
+static void RxBudgetQueue(uint8_t Datagrams)
+{
+    host::stationLoc Loc;
+    uint8_t Index;
+
+    for (Index = 0; Index < Datagrams; Index++)
+    {
+        host::UdpReceive(host::Z21LocInfo(500 + Index, Loc));
+    }
+}
+
+/***********************************************************************************************************************
+ * Exactly the packet budget pending: all handled in one tick and the budget is not exceeded.
+ */
+static void RxBudgetExact(void)
+{
+    wmcApp::rxStatistics Before = wmcApp::RxStatisticsGet();
+
+    RxBudgetQueue(16);
+    send_event(updateEvent50msec());
+
+    CHECK_EQUAL(16, wmcApp::RxStatisticsGet().PacketsTick);
+    CHECK_EQUAL(Before.Records + 16, wmcApp::RxStatisticsGet().Records);
+    CHECK_EQUAL(Before.BudgetExceeded, wmcApp::RxStatisticsGet().BudgetExceeded);
+    CHECK(host::Udp.Rx.empty() == true);
+}
+
+/***********************************************************************************************************************
+ * One datagram more than the budget: the budget is exceeded once and the remaining datagram is handled by the next
+ * tick, nothing is skipped.
+ */
+static void RxBudgetExceeded(void)
+{
+    wmcApp::rxStatistics Before = wmcApp::RxStatisticsGet();
+    uint32_t Discarded          = host::Udp.Discarded;
+
+    RxBudgetQueue(17);
+    send_event(updateEvent50msec());
+
+    CHECK_EQUAL(16, wmcApp::RxStatisticsGet().PacketsTick);
+    CHECK_EQUAL(Before.BudgetExceeded + 1, wmcApp::RxStatisticsGet().BudgetExceeded);
+
+    send_event(updateEvent50msec());
+
+    CHECK_EQUAL(1, wmcApp::RxStatisticsGet().PacketsTick);
+    CHECK_EQUAL(Before.Records + 17, wmcApp::RxStatisticsGet().Records);
+    CHECK_EQUAL(Before.BudgetExceeded + 1, wmcApp::RxStatisticsGet().BudgetExceeded);
+    CHECK_EQUAL(Discarded, host::Udp.Discarded);
+}
+
+/***********************************************************************************************************************
+ * Empty socket: no budget is used.
+ */
+static void RxBudgetIdle(void)
+{
+    wmcApp::rxStatistics Before = wmcApp::RxStatisticsGet();
+
+    send_event(updateEvent50msec());
+
+    CHECK_EQUAL(0, wmcApp::RxStatisticsGet().PacketsTick);
+    CHECK_EQUAL(Before.BudgetExceeded, wmcApp::RxStatisticsGet().BudgetExceeded);
+}
+
+int main(void)
+{
+    CHECK(host::Boot(0x02) == true);
+
+    RxBudgetExact();
+    RxBudgetExceeded();
+    RxBudgetIdle();
+
+    return (host::Result("wmc_rx_budget_test"));
+}
@@ -0,0 +1,128 @@
+/***********************************************************************************************************************
+   @file   wmc_rx_records_test.cpp
+   @brief  Receive path: every record of a packed datagram is dispatched, truncated data is dropped, and a
+           throughput benchmark of the record walk with packed datagrams.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "host_test.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+#define RX_RECORDS_DATAGRAMS 20000 /* Datagrams fed through the receive path by the benchmark. */
+#define RX_RECORDS_PER_DATAGRAM 10 /* Loc info records packed in each datagram. */
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Datagram with loc info records of consecutive addresses.
+ */
+static std::vector<uint8_t> RxRecordsDatagram(uint16_t Address, uint8_t Records)
+{
+    std::vector<uint8_t> Datagram;
+    std::vector<uint8_t> Record;
+    host::stationLoc Loc;
+    uint8_t Index;
+
+    for (Index = 0; Index < Records; Index++)
+    {
+        Loc.Speed = Index;
+        Record    = host::Z21LocInfo(Address + Index, Loc);
+        Datagram.insert(Datagram.end(), Record.begin(), Record.end());
+    }
+
+    return (Datagram);
+}
+
+/***********************************************************************************************************************
+ * A datagram with the loc info of the selected loc behind other records updates the screen, so all records are
+ * handled and not only the first one.
+ */
+static void RxRecordsPacked(void)
+{
+    wmcApp::rxStatistics Before   = wmcApp::RxStatisticsGet();
+    std::vector<uint8_t> Datagram = RxRecordsDatagram(100, 3);
+    std::vector<uint8_t> Record;
+    host::stationLoc Loc;
+
+    Loc.Speed = 42;
+    Record    = host::Z21LocInfo(3, Loc);
+    Datagram.insert(Datagram.end(), Record.begin(), Record.end());
+    Record = host::Z21Status(0x02);
+    Datagram.insert(Datagram.end(), Record.begin(), Record.end());
+
+    host::UdpReceive(Datagram);
+    host::Run(50);
+
+    CHECK_EQUAL(Before.Records + 5, wmcApp::RxStatisticsGet().Records);
+    CHECK_EQUAL(Before.Dropped, wmcApp::RxStatisticsGet().Dropped);
+    CHECK_EQUAL(42, host::Tft.LocInfo.Speed);
+}
+
+/***********************************************************************************************************************
+ * A record longer than the rest of the datagram ends the walk, the records in front of it are handled.
+ */
+static void RxRecordsTruncated(void)
+{
+    wmcApp::rxStatistics Before   = wmcApp::RxStatisticsGet();
+    std::vector<uint8_t> Datagram = RxRecordsDatagram(200, 2);
+
+    Datagram.push_back(0x20);
+    Datagram.push_back(0x00);
+    Datagram.push_back(0x40);
+    Datagram.push_back(0x00);
+    host::UdpReceive(Datagram);
+    host::Run(50);
+
+    CHECK_EQUAL(Before.Records + 2, wmcApp::RxStatisticsGet().Records);
+    CHECK_EQUAL(Before.Dropped + 1, wmcApp::RxStatisticsGet().Dropped);
+}
+
+/***********************************************************************************************************************
+ * Throughput of the receive path with packed datagrams, the time includes decoding and dispatching the records.
+ */
+static void RxRecordsBenchmark(void)
+{
+    wmcApp::rxStatistics Before   = wmcApp::RxStatisticsGet();
+    std::vector<uint8_t> Datagram = RxRecordsDatagram(300, RX_RECORDS_PER_DATAGRAM);
+    uint32_t Index;
+    uint64_t StartNs;
+    uint64_t DurationNs;
+    uint32_t Records;
+
+    for (Index = 0; Index < RX_RECORDS_DATAGRAMS; Index++)
+    {
+        host::UdpReceive(Datagram);
+    }
+
+    StartNs = host::WallNs();
+    while (host::Udp.Rx.empty() == false)
+    {
+        send_event(updateEvent50msec());
+    }
+    DurationNs = host::WallNs() - StartNs;
+
+    Records = wmcApp::RxStatisticsGet().Records - Before.Records;
+    CHECK_EQUAL(RX_RECORDS_DATAGRAMS * RX_RECORDS_PER_DATAGRAM, Records);
+    CHECK_EQUAL(Before.Dropped, wmcApp::RxStatisticsGet().Dropped);
+
+    printf("rx benchmark: %u datagrams of %u bytes, %u records in %.1f ms, %.0f records/s, %.0f ns/record\n",
+        RX_RECORDS_DATAGRAMS, static_cast<unsigned>(Datagram.size()), Records, DurationNs / 1e6,
+        Records / (DurationNs / 1e9), static_cast<double>(DurationNs) / Records);
+}
+
+int main(void)
+{
+    CHECK(host::Boot(0x02) == true);
+
+    RxRecordsPacked();
+    RxRecordsTruncated();
+    RxRecordsBenchmark();
+
+    return (host::Result("wmc_rx_records_test"));
+}
@@ -0,0 +1,100 @@
+/***********************************************************************************************************************
+   @file   wmc_session_resume_test.cpp
+   @brief  Session resume: an outage of the command station is detected, the session is resumed in the background
+           without a screen clear and the loc keeps speed, direction and functions.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "host_test.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+#define SESSION_LOC 3                /* Selected loc after the first boot. */
+#define SESSION_LINK_LOST_TIME 2500  /* Copy of the application link lost time in msec. */
+#define SESSION_RESUME_MAX 600       /* Maximum time from the return of the station to loc control in msec. */
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+static uint32_t SessionLosses;
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Outage of the given time, returns the time from the return of the station to loc control in msec.
+ */
+static uint32_t SessionOutage(uint32_t OutageMs)
+{
+    uint32_t Clears   = host::Tft.Clears;
+    uint32_t DetectMs = 0;
+    uint32_t ResumeMs = 0;
+    uint32_t Time;
+
+    host::Station.Online = false;
+    for (Time = 0; Time < OutageMs; Time++)
+    {
+        host::Run(1);
+        if ((DetectMs == 0) && (wmcApp::LinkStatisticsGet().Losses != SessionLosses))
+        {
+            DetectMs = Time + 1;
+        }
+    }
+
+    /* Station replies again, wait for loc control. */
+    host::Station.Online = true;
+    while ((ResumeMs < 5000) && (strcmp(host::Tft.Status, "POWER ON") != 0))
+    {
+        host::Run(1);
+        ResumeMs++;
+    }
+
+    printf("session outage of %u ms: detected after %u ms, loc control %u ms after the station returned\n", OutageMs,
+        DetectMs, ResumeMs);
+
+    SessionLosses++;
+    CHECK_EQUAL(SessionLosses, wmcApp::LinkStatisticsGet().Losses);
+    CHECK((DetectMs > 0) && (DetectMs <= (SESSION_LINK_LOST_TIME + 100)));
+    CHECK_EQUAL(Clears, host::Tft.Clears);
+
+    return (ResumeMs);
+}
+
+int main(void)
+{
+    uint8_t Speed;
+    uint32_t ResumeMs;
+
+    CHECK(host::Boot(0x00) == true);
+    CHECK(strcmp(host::Tft.Status, "POWER ON") == 0);
+    SessionLosses = wmcApp::LinkStatisticsGet().Losses;
+
+    /* Drive the loc. */
+    host::PulseSwitch(turn, 10);
+    host::Run(500);
+    Speed = host::Station.Locs[SESSION_LOC].Speed;
+    CHECK(Speed > 0);
+
+    ResumeMs = SessionOutage(4000);
+    CHECK(ResumeMs <= SESSION_RESUME_MAX);
+
+    ResumeMs = SessionOutage(20000);
+    CHECK(ResumeMs <= SESSION_RESUME_MAX);
+
+    /* The loc is controlled with the speed it had, the next detent continues from it. */
+    CHECK_EQUAL(Speed, host::Tft.LocInfo.Speed);
+    CHECK_EQUAL(SESSION_LOC, host::Tft.LocInfo.Address);
+    host::PulseSwitch(turn, 1);
+    host::Run(500);
+    CHECK_EQUAL(Speed + 1, host::Station.Locs[SESSION_LOC].Speed);
+
+    printf("session recovery statistics: last %u ms, max %u ms, probes %u\n",
+        wmcApp::LinkStatisticsGet().RecoveryTimeLast, wmcApp::LinkStatisticsGet().RecoveryTimeMax,
+        wmcApp::LinkStatisticsGet().Probes);
+
+    return (host::Result("wmc_session_resume_test"));
+}
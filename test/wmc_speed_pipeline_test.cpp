@@ -0,0 +1,119 @@
+/***********************************************************************************************************************
+   @file   wmc_speed_pipeline_test.cpp
+   @brief  Speed pipeline: knob to wire latency and dropped deltas for slow and fast turning with a slow command
+           station.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "host_test.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+#define SPEED_PIPELINE_LOC 3             /* Selected loc after boot. */
+#define SPEED_PIPELINE_LATENCY 40000     /* Reply latency of the command station in usec. */
+#define SPEED_PIPELINE_TX_INTERVAL 50    /* Minimum time between drive commands of the application in msec. */
+#define SPEED_PIPELINE_LATENCY_MAX 56000 /* Transmit interval, one tick and one loop in usec. */
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+static uint32_t SpeedPipelineInterval = 0; /* Time between detents in msec. */
+static uint32_t SpeedPipelineDetents  = 0; /* Detents still to turn. */
+static uint32_t SpeedPipelineElapsed  = 0;
+static std::vector<uint64_t> SpeedPipelineTimes;
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Turn the knob one detent each interval.
+ */
+static void SpeedPipelineTurn(void)
+{
+    SpeedPipelineElapsed++;
+    if ((SpeedPipelineDetents > 0) && (SpeedPipelineElapsed >= SpeedPipelineInterval))
+    {
+        SpeedPipelineElapsed = 0;
+        SpeedPipelineDetents--;
+        SpeedPipelineTimes.push_back(host::TimeUs);
+        host::PulseSwitch(turn, 1);
+    }
+}
+
+/***********************************************************************************************************************
+ * Turn the knob, then measure for each detent the time until a drive command leaves and check that the speed on
+ * the wire is the speed requested by all detents.
+ */
+static void SpeedPipelineRun(const char* NamePtr, uint32_t Interval, uint32_t Detents)
+{
+    size_t Records                 = host::Station.Records.size();
+    wmcApp::speedStatistics Before = wmcApp::SpeedStatisticsGet();
+    uint32_t StepsBefore           = wmcApp::PulseAccelStatisticsGet().Steps;
+    uint64_t LatencySum            = 0;
+    uint64_t LatencyMax            = 0;
+    uint64_t Latency;
+    uint32_t Expected;
+    uint32_t Commands;
+    size_t Index;
+
+    SpeedPipelineInterval = Interval;
+    SpeedPipelineDetents  = Detents;
+    SpeedPipelineElapsed  = Interval;
+    SpeedPipelineTimes.clear();
+    host::Run(Interval * Detents + 1000, SpeedPipelineTurn);
+
+    for (uint64_t Time : SpeedPipelineTimes)
+    {
+        for (Index = Records; Index < host::Station.Records.size(); Index++)
+        {
+            if ((host::Z21IsDrive(host::Station.Records[Index].Data) == true)
+                && (host::Station.Records[Index].TimeUs >= Time))
+            {
+                break;
+            }
+        }
+
+        CHECK(Index < host::Station.Records.size());
+        Latency = (Index < host::Station.Records.size()) ? (host::Station.Records[Index].TimeUs - Time) : 0;
+        LatencySum += Latency;
+        LatencyMax = (Latency > LatencyMax) ? Latency : LatencyMax;
+    }
+
+    Expected = wmcApp::PulseAccelStatisticsGet().Steps - StepsBefore;
+    Commands = host::Count(host::Z21IsDrive, Records);
+
+    printf("%s: %u detents every %u ms, %u steps, %u drive commands, latency mean %.1f ms max %.1f ms, "
+           "%u deltas dropped, speed %u on wire %u shown\n",
+        NamePtr, Detents, Interval, Expected, Commands, LatencySum / 1000.0 / Detents, LatencyMax / 1000.0,
+        wmcApp::SpeedStatisticsGet().Dropped - Before.Dropped, host::Station.Locs[SPEED_PIPELINE_LOC].Speed,
+        host::Tft.LocInfo.Speed);
+
+    CHECK(LatencyMax <= SPEED_PIPELINE_LATENCY_MAX);
+    CHECK_EQUAL(Before.Dropped, wmcApp::SpeedStatisticsGet().Dropped);
+    CHECK(Commands <= ((Interval * Detents) / SPEED_PIPELINE_TX_INTERVAL) + 2);
+}
+
+int main(void)
+{
+    uint8_t SpeedStart;
+
+    host::Station.Locs[SPEED_PIPELINE_LOC].Steps = 4;
+    CHECK(host::Boot(0x00, SPEED_PIPELINE_LATENCY) == true);
+
+    /* Slow turning, no acceleration: every detent is one step. */
+    SpeedPipelineRun("slow", 100, 20);
+    CHECK_EQUAL(20, host::Station.Locs[SPEED_PIPELINE_LOC].Speed);
+    CHECK_EQUAL(20, host::Tft.LocInfo.Speed);
+
+    /* Fast turning, faster than the ticks and the command station: nothing gets lost. */
+    SpeedStart = host::Station.Locs[SPEED_PIPELINE_LOC].Speed;
+    SpeedPipelineRun("fast", 4, 20);
+    CHECK(host::Station.Locs[SPEED_PIPELINE_LOC].Speed > SpeedStart + 20);
+    CHECK_EQUAL(host::Tft.LocInfo.Speed, host::Station.Locs[SPEED_PIPELINE_LOC].Speed);
+
+    return (host::Result("wmc_speed_pipeline_test"));
+}
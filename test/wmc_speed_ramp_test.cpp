@@ -0,0 +1,207 @@
+/***********************************************************************************************************************
+   @file   wmc_speed_ramp_test.cpp
+   @brief  Speed ramps: the rates are set in the speed ramp menu and survive a power cycle. Simulates a fast knob turn
+           of a loc with rates and checks the speed curve on the command station and the drive command rate.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "host_test.h"
+#include <sys/wait.h>
+#include <unistd.h>
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+#define RAMP_LOC 3               /* Selected loc after boot. */
+#define RAMP_ACCELERATE 10       /* Acceleration set in the menu in speed steps per second. */
+#define RAMP_BRAKE 20            /* Braking rate set in the menu in speed steps per second. */
+#define RAMP_DETENTS 30          /* Detents of the fast knob turn. */
+#define RAMP_DETENT_MS 12        /* Time between detents of the fast knob turn. */
+#define RAMP_SAMPLE_MS 100       /* Speed curve sample interval. */
+#define RAMP_INTERVAL_MS 100     /* Copy of the application drive command interval of ramps. */
+#define RAMP_LATENCY_US 2000     /* Command station latency. */
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Set the rates of the selected loc in the speed ramp menu: turning slow gives one speed step per second per detent.
+ */
+static void RampMenu(void)
+{
+    uint8_t Index;
+
+    /* The menu is entered with the track power off. */
+    wmcApp::EventQueueGet().PushButton(button_power);
+    host::Run(100);
+    host::PulseSwitch(pushedlong, 0);
+    host::Run(100);
+    wmcApp::EventQueueGet().PushButton(button_0);
+    host::Run(100);
+    CHECK(strcmp(host::Tft.Status, "ACCELERATE 0/S") == 0);
+    CHECK_EQUAL(RAMP_LOC, host::Tft.LocAddress);
+
+    for (Index = 0; Index < RAMP_ACCELERATE; Index++)
+    {
+        host::PulseSwitch(turn, 1);
+        host::Run(150);
+    }
+    CHECK(strcmp(host::Tft.Status, "ACCELERATE 10/S") == 0);
+
+    wmcApp::EventQueueGet().PushButton(button_1);
+    host::Run(100);
+    for (Index = 0; Index < RAMP_BRAKE; Index++)
+    {
+        host::PulseSwitch(turn, 1);
+        host::Run(150);
+    }
+    CHECK(strcmp(host::Tft.Status, "BRAKE 20/S") == 0);
+
+    host::PulseSwitch(pushedNormal, 0);
+    host::Run(100);
+}
+
+/***********************************************************************************************************************
+ * Power cycle: set the rates in a child process, only the flash content survives and is taken over by the parent.
+ */
+static void RampPowerCycle(void)
+{
+    const EepCfg::speedRamp* RampsPtr;
+    int Pipe[2];
+    int Status;
+    pid_t Pid;
+
+    CHECK(pipe(Pipe) == 0);
+    fflush(stdout);
+
+    Pid = fork();
+    if (Pid == 0)
+    {
+        close(Pipe[0]);
+        if (host::Boot(0x00) == true)
+        {
+            RampMenu();
+        }
+
+        if ((host::Failures() != 0) || (write(Pipe[1], EEPROM.Flash, sizeof(EEPROM.Flash)) != sizeof(EEPROM.Flash)))
+        {
+            _exit(1);
+        }
+        _exit(0);
+    }
+
+    close(Pipe[1]);
+    CHECK(read(Pipe[0], EEPROM.Flash, sizeof(EEPROM.Flash)) == sizeof(EEPROM.Flash));
+    memcpy(EEPROM.getDataPtr(), EEPROM.Flash, sizeof(EEPROM.Flash));
+    close(Pipe[0]);
+    waitpid(Pid, &Status, 0);
+    CHECK(WIFEXITED(Status) && (WEXITSTATUS(Status) == 0));
+
+    RampsPtr = reinterpret_cast<const EepCfg::speedRamp*>(&EEPROM.Flash[EepCfg::SpeedRampAddress]);
+    CHECK_EQUAL(1, RampsPtr->Valid);
+    CHECK_EQUAL(RAMP_LOC, RampsPtr->Loc[0].Address);
+    CHECK_EQUAL(RAMP_ACCELERATE * wmcSpeedRamp::SPEED_RAMP_ONE, RampsPtr->Loc[0].Accelerate);
+    CHECK_EQUAL(RAMP_BRAKE * wmcSpeedRamp::SPEED_RAMP_ONE, RampsPtr->Loc[0].Brake);
+}
+
+/***********************************************************************************************************************
+ * Turn the knob fast, then follow the speed on the command station. The speed must follow the rate within one
+ * command interval and the drive commands must not come faster than the interval. Returns the end speed.
+ */
+static uint8_t RampRun(const char* NamePtr, int8_t Direction, uint32_t Rate, uint32_t DurationMs)
+{
+    size_t From         = host::Station.Records.size();
+    uint64_t StartUs    = host::TimeUs;
+    uint8_t StartSpeed  = host::Station.Locs[RAMP_LOC].Speed;
+    uint64_t GapMinUs   = 0xFFFFFFFF;
+    uint64_t PreviousUs = 0;
+    uint32_t Deviation  = 0;
+    uint32_t Commands   = 0;
+    std::vector<uint32_t> Samples;
+    uint32_t Expected;
+    uint32_t Elapsed;
+    uint32_t Speed;
+    uint8_t EndSpeed;
+    size_t Index;
+
+    for (Index = 0; Index < RAMP_DETENTS; Index++)
+    {
+        host::PulseSwitch(turn, Direction);
+        host::Run(RAMP_DETENT_MS);
+    }
+
+    while ((host::TimeUs - StartUs) < (static_cast<uint64_t>(DurationMs) * 1000))
+    {
+        host::Run(RAMP_SAMPLE_MS);
+        Samples.push_back(host::Station.Locs[RAMP_LOC].Speed);
+    }
+    EndSpeed = host::Station.Locs[RAMP_LOC].Speed;
+
+    /* Expected speed moves at the rate from the first detent on, towards the end speed. */
+    for (Index = 0; Index < Samples.size(); Index++)
+    {
+        Elapsed  = (RAMP_DETENTS * RAMP_DETENT_MS) + ((Index + 1) * RAMP_SAMPLE_MS);
+        Expected = (Rate * Elapsed) / 1000;
+        if (Direction > 0)
+        {
+            Expected = ((StartSpeed + Expected) < EndSpeed) ? (StartSpeed + Expected) : EndSpeed;
+        }
+        else
+        {
+            Expected = (StartSpeed > (EndSpeed + Expected)) ? (StartSpeed - Expected) : EndSpeed;
+        }
+
+        Speed     = Samples[Index];
+        Deviation = (Speed > Expected) ? ((Speed - Expected > Deviation) ? (Speed - Expected) : Deviation)
+                                       : ((Expected - Speed > Deviation) ? (Expected - Speed) : Deviation);
+    }
+
+    for (Index = From; Index < host::Station.Records.size(); Index++)
+    {
+        if (host::Z21IsDrive(host::Station.Records[Index].Data) == true)
+        {
+            if (Commands > 0)
+            {
+                GapMinUs = ((host::Station.Records[Index].TimeUs - PreviousUs) < GapMinUs)
+                    ? (host::Station.Records[Index].TimeUs - PreviousUs)
+                    : GapMinUs;
+            }
+            PreviousUs = host::Station.Records[Index].TimeUs;
+            Commands++;
+        }
+    }
+
+    printf("speed ramp %s: %u to %u at %u steps/s, %u drive commands, minimum gap %.1f ms, curve deviation max %u "
+           "steps\n",
+        NamePtr, StartSpeed, EndSpeed, Rate, Commands, GapMinUs / 1000.0, Deviation);
+
+    /* One interval behind plus the rounding of the fixed point. */
+    CHECK(Deviation <= (((Rate * RAMP_INTERVAL_MS) / 1000) + 1));
+    CHECK(GapMinUs >= ((RAMP_INTERVAL_MS - 1) * 1000));
+    CHECK(Commands <= ((DurationMs / RAMP_INTERVAL_MS) + 1));
+
+    return (EndSpeed);
+}
+
+int main(void)
+{
+    uint8_t Speed;
+
+    RampPowerCycle();
+
+    host::Station.Locs[RAMP_LOC].Steps = 4;
+    CHECK(host::Boot(0x00, RAMP_LATENCY_US) == true);
+
+    Speed = RampRun("accelerate", 1, RAMP_ACCELERATE, 12000);
+    CHECK(Speed > 50);
+    CHECK_EQUAL(1, wmcApp::SpeedRampStatisticsGet().Ramps);
+
+    Speed = RampRun("brake", -1, RAMP_BRAKE, 8000);
+    CHECK_EQUAL(0, Speed);
+    CHECK_EQUAL(2, wmcApp::SpeedRampStatisticsGet().Ramps);
+
+    return (host::Result("wmc_speed_ramp_test"));
+}
@@ -0,0 +1,74 @@
+/***********************************************************************************************************************
+   @file   wmc_timer_test.cpp
+   @brief  Timer service: timers are dispatched by the 5 msec update of each state, the sketch only sends the update
+           events. Measures the expiry lateness.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "host_test.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+#define TIMER_SELECTIONS 40 /* Loc selections, each arms the loc selection timer. */
+#define TIMER_SELECT_MS 300 /* Loc selection timer of the application. */
+#define TIMER_TICK_MS 5     /* Interval of the update which checks the timers. */
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Select another loc at varying offsets to the 5 msec update, the loc info is requested when the selection timer
+ * expires. The timers are checked by the 5 msec update, so they never expire early and at most one update late.
+ */
+static void TimerLateness(void)
+{
+    uint32_t Expired = wmcApp::TimerStatisticsGet().Expired;
+    uint32_t LateMax = 0;
+    size_t From;
+    uint32_t Index;
+
+    for (Index = 0; Index < TIMER_SELECTIONS; Index++)
+    {
+        host::Run(Index % TIMER_TICK_MS);
+        host::PulseSwitch(pushturn, ((Index & 1) == 0) ? 1 : -1);
+        host::Run(1);
+
+        From = host::Station.Records.size();
+        host::Run(TIMER_SELECT_MS - 1);
+        CHECK_EQUAL(0, host::Count(host::Z21IsLocInfoGet, From));
+        host::Run(TIMER_TICK_MS);
+        CHECK_EQUAL(1, host::Count(host::Z21IsLocInfoGet, From));
+        LateMax = (wmcApp::TimerStatisticsGet().LateLast > LateMax) ? wmcApp::TimerStatisticsGet().LateLast : LateMax;
+        host::Run(200);
+    }
+
+    printf("timer: %u loc selections, %u timers expired, lateness max %u ms\n", TIMER_SELECTIONS,
+        wmcApp::TimerStatisticsGet().Expired - Expired, LateMax);
+
+    CHECK(wmcApp::TimerStatisticsGet().Expired - Expired >= TIMER_SELECTIONS);
+    CHECK(LateMax < TIMER_TICK_MS);
+}
+
+/***********************************************************************************************************************
+ * Timers run from the 5 msec update only, a state that does not sample the buttons still gets its timers. The wifi
+ * status poll of the boot is a timer, loc control is reached through it.
+ */
+static void TimerBoot(void)
+{
+    uint32_t Expired = wmcApp::TimerStatisticsGet().Expired;
+
+    CHECK(host::Boot(0x00) == true);
+    CHECK(wmcApp::TimerStatisticsGet().Expired > Expired);
+}
+
+int main(void)
+{
+    TimerBoot();
+    TimerLateness();
+
+    return (host::Result("wmc_timer_test"));
+}
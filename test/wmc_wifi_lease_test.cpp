@@ -0,0 +1,162 @@
+/***********************************************************************************************************************
+   @file   wmc_wifi_lease_test.cpp
+   @brief  Cached DHCP lease: reused for a limited number of boots, then DHCP is done again, and dropped with a
+           fallback to a full scan and DHCP when the address is in use by another device.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "host_test.h"
+#include <ESP8266WiFi.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+#define WIFI_LEASE_USES_MAX 8 /* Copy of the application limit. */
+
+/***********************************************************************************************************************
+   T Y P E D  E F S  /  E N U M
+ **********************************************************************************************************************/
+
+/**
+ * Result of a boot.
+ */
+struct wifiLeaseBoot
+{
+    bool Drivable;         /* Loc control reached. */
+    uint32_t BootMs;       /* Time from start of wifi to loc control. */
+    uint32_t DhcpRequests; /* Connects done with DHCP. */
+    uint32_t FastBegins;   /* Connects done with channel and BSSID. */
+    uint32_t Ip;           /* Address used. */
+};
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * The command station only receives datagrams of the WMC when its address is not in use by another device.
+ */
+static uint32_t WifiLeaseConflict(void)
+{
+    return ((static_cast<uint32_t>(WiFi.localIP()) != static_cast<uint32_t>(WiFi.DhcpIp)) ? 1 : 0);
+}
+
+/***********************************************************************************************************************
+ * Power cycle: boot in a child process, only the flash content survives and is taken over by the parent.
+ */
+static wifiLeaseBoot WifiLeaseBoot(void)
+{
+    wifiLeaseBoot Result;
+    const wmcBootLog::boot* BootPtr;
+    int Pipe[2];
+    int Status;
+    pid_t Pid;
+
+    memset(&Result, 0, sizeof(Result));
+    CHECK(pipe(Pipe) == 0);
+    fflush(stdout);
+
+    Pid = fork();
+    if (Pid == 0)
+    {
+        close(Pipe[0]);
+        host::Station.SourceCheck = WifiLeaseConflict;
+        Result.Drivable           = host::Boot(0x02, 2000, 20000);
+        BootPtr                   = wmcApp::BootLogGet(0);
+        Result.BootMs             = BootPtr->Time[wmcBootLog::drivable] - BootPtr->Time[wmcBootLog::wifiStart];
+        Result.DhcpRequests       = WiFi.DhcpRequests;
+        Result.FastBegins         = WiFi.FastBegins;
+        Result.Ip                 = WiFi.localIP();
+
+        /* Pending writes are committed before the power is switched off. */
+        host::Run(3000);
+        if ((write(Pipe[1], &Result, sizeof(Result)) != sizeof(Result))
+            || (write(Pipe[1], EEPROM.Flash, sizeof(EEPROM.Flash)) != sizeof(EEPROM.Flash)))
+        {
+            _exit(1);
+        }
+        _exit(0);
+    }
+
+    close(Pipe[1]);
+    CHECK(read(Pipe[0], &Result, sizeof(Result)) == sizeof(Result));
+    CHECK(read(Pipe[0], EEPROM.Flash, sizeof(EEPROM.Flash)) == sizeof(EEPROM.Flash));
+    memcpy(EEPROM.getDataPtr(), EEPROM.Flash, sizeof(EEPROM.Flash));
+    close(Pipe[0]);
+    waitpid(Pid, &Status, 0);
+    CHECK(WIFEXITED(Status) && (WEXITSTATUS(Status) == 0));
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * The lease is reused for the maximum number of boots, then DHCP is done again and the new lease is reused.
+ */
+static void WifiLeaseUses(void)
+{
+    wifiLeaseBoot Boot;
+    uint8_t Index;
+
+    Boot = WifiLeaseBoot();
+    CHECK(Boot.Drivable == true);
+    CHECK_EQUAL(1, Boot.DhcpRequests);
+    CHECK_EQUAL(0, Boot.FastBegins);
+    printf("wifi lease: first boot %u ms\n", Boot.BootMs);
+
+    for (Index = 0; Index < WIFI_LEASE_USES_MAX; Index++)
+    {
+        Boot = WifiLeaseBoot();
+        CHECK(Boot.Drivable == true);
+        CHECK_EQUAL(0, Boot.DhcpRequests);
+        CHECK_EQUAL(1, Boot.FastBegins);
+        CHECK_EQUAL(static_cast<uint32_t>(IPAddress(192, 168, 0, 100)), Boot.Ip);
+    }
+    printf("wifi lease: boot with reused lease %u ms\n", Boot.BootMs);
+
+    /* Lease used too often, DHCP again on the fast connect. */
+    Boot = WifiLeaseBoot();
+    CHECK(Boot.Drivable == true);
+    CHECK_EQUAL(1, Boot.DhcpRequests);
+    CHECK_EQUAL(1, Boot.FastBegins);
+    printf("wifi lease: boot with DHCP after %u uses %u ms\n", WIFI_LEASE_USES_MAX, Boot.BootMs);
+
+    Boot = WifiLeaseBoot();
+    CHECK_EQUAL(0, Boot.DhcpRequests);
+}
+
+/***********************************************************************************************************************
+ * The address of the lease is handed out to another device, no replies are received. The lease is dropped and the
+ * connection is made with a full scan and DHCP, the new lease is reused at the next boot.
+ */
+static void WifiLeaseConflictFallback(void)
+{
+    wifiLeaseBoot Boot;
+
+    WiFi.DhcpIp = IPAddress(192, 168, 0, 101);
+
+    Boot = WifiLeaseBoot();
+    CHECK(Boot.Drivable == true);
+    CHECK_EQUAL(1, Boot.DhcpRequests);
+    CHECK_EQUAL(static_cast<uint32_t>(IPAddress(192, 168, 0, 101)), Boot.Ip);
+    printf("wifi lease: boot with address conflict %u ms\n", Boot.BootMs);
+
+    Boot = WifiLeaseBoot();
+    CHECK(Boot.Drivable == true);
+    CHECK_EQUAL(0, Boot.DhcpRequests);
+    CHECK_EQUAL(1, Boot.FastBegins);
+    CHECK_EQUAL(static_cast<uint32_t>(IPAddress(192, 168, 0, 101)), Boot.Ip);
+}
+
+int main(void)
+{
+    host::ConfigWrite(host::ConfigDefault());
+
+    WifiLeaseUses();
+    WifiLeaseConflictFallback();
+
+    return (host::Result("wmc_wifi_lease_test"));
+}
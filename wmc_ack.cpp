@@ -0,0 +1,188 @@
+/***********************************************************************************************************************
+   @file   wmc_ack.cpp
+   @brief  Tracking of safety critical commands until they are confirmed by a broadcast of the control unit.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "wmc_ack.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   F O R W A R D  D E C L A R A T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+wmcAck::wmcAck()
+{
+    memset(m_Entries, 0, sizeof(m_Entries));
+    memset(&m_Statistics, 0, sizeof(m_Statistics));
+}
+
+/***********************************************************************************************************************
+ */
+void wmcAck::Track(command Command, const Z21Slave::locInfo* LocInfoPtr)
+{
+    uint8_t Index;
+    uint8_t Slot = ACK_ENTRIES;
+
+    /* A repeated command restarts tracking, otherwise use a free entry or the oldest. */
+    for (Index = 0; Index < ACK_ENTRIES; Index++)
+    {
+        if ((m_Entries[Index].Active == true) && (m_Entries[Index].Command == Command)
+            && ((Command != locStop) || (m_Entries[Index].LocInfo.Address == LocInfoPtr->Address)))
+        {
+            Slot = Index;
+            break;
+        }
+        else if ((m_Entries[Index].Active == false) && (Slot == ACK_ENTRIES))
+        {
+            Slot = Index;
+        }
+    }
+
+    if (Slot == ACK_ENTRIES)
+    {
+        Slot = 0;
+        for (Index = 1; Index < ACK_ENTRIES; Index++)
+        {
+            if ((m_Entries[Index].FirstTime - m_Entries[Slot].FirstTime) > 0x80000000)
+            {
+                Slot = Index;
+            }
+        }
+
+        m_Statistics.Failed++;
+    }
+
+    m_Entries[Slot].Active    = true;
+    m_Entries[Slot].Command   = Command;
+    m_Entries[Slot].Retries   = 0;
+    m_Entries[Slot].FirstTime = millis();
+    m_Entries[Slot].LastTime  = m_Entries[Slot].FirstTime;
+
+    if (LocInfoPtr != NULL)
+    {
+        m_Entries[Slot].LocInfo = *LocInfoPtr;
+    }
+
+    m_Statistics.Tracked++;
+}
+
+/***********************************************************************************************************************
+ */
+void wmcAck::Cancel(command Command, uint16_t Address)
+{
+    uint8_t Index;
+
+    for (Index = 0; Index < ACK_ENTRIES; Index++)
+    {
+        if ((m_Entries[Index].Active == true) && (m_Entries[Index].Command == Command)
+            && ((Command != locStop) || (m_Entries[Index].LocInfo.Address == Address)))
+        {
+            m_Entries[Index].Active = false;
+            m_Statistics.Cancelled++;
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ */
+void wmcAck::Confirm(Z21Slave::dataType Type, const Z21Slave::locInfo* LocInfoPtr)
+{
+    uint8_t Index;
+    entry* EntryPtr;
+
+    for (Index = 0; Index < ACK_ENTRIES; Index++)
+    {
+        EntryPtr = &m_Entries[Index];
+        if (EntryPtr->Active == true)
+        {
+            switch (EntryPtr->Command)
+            {
+            case powerOff:
+                if (Type == Z21Slave::trackPowerOff)
+                {
+                    Confirmed(EntryPtr);
+                }
+                break;
+            case stop:
+                if ((Type == Z21Slave::emergencyStop) || (Type == Z21Slave::trackPowerOff))
+                {
+                    Confirmed(EntryPtr);
+                }
+                break;
+            case locStop:
+                if ((Type == Z21Slave::locinfo) && (LocInfoPtr->Address == EntryPtr->LocInfo.Address)
+                    && (LocInfoPtr->Speed == 0))
+                {
+                    Confirmed(EntryPtr);
+                }
+                break;
+            }
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ */
+bool wmcAck::RetransmitGet(command& Command, Z21Slave::locInfo& LocInfo)
+{
+    bool Result  = false;
+    uint32_t Now = millis();
+    uint8_t Index;
+    entry* EntryPtr;
+
+    for (Index = 0; (Index < ACK_ENTRIES) && (Result == false); Index++)
+    {
+        EntryPtr = &m_Entries[Index];
+        if ((EntryPtr->Active == true) && ((Now - EntryPtr->LastTime) >= ACK_RETRY_INTERVAL))
+        {
+            if (EntryPtr->Retries >= ACK_RETRY_MAX)
+            {
+                EntryPtr->Active = false;
+                m_Statistics.Failed++;
+            }
+            else
+            {
+                EntryPtr->Retries++;
+                EntryPtr->LastTime = Now;
+                m_Statistics.Retries++;
+
+                Command = EntryPtr->Command;
+                LocInfo = EntryPtr->LocInfo;
+                Result  = true;
+            }
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Administration of a confirmed command.
+ */
+void wmcAck::Confirmed(entry* EntryPtr)
+{
+    EntryPtr->Active = false;
+
+    m_Statistics.Confirmed++;
+    m_Statistics.ConfirmTimeLast = millis() - EntryPtr->FirstTime;
+    if (m_Statistics.ConfirmTimeLast > m_Statistics.ConfirmTimeMax)
+    {
+        m_Statistics.ConfirmTimeMax = m_Statistics.ConfirmTimeLast;
+    }
+}
@@ -0,0 +1,105 @@
+/**
+ **********************************************************************************************************************
+ * @file  wmc_ack.h
+ * @brief Tracking of safety critical commands until they are confirmed by a broadcast of the control unit.
+ ***********************************************************************************************************************
+ */
+#ifndef WMC_ACK_H
+#define WMC_ACK_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include "Z21Slave.h"
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * T Y P E D  E F S  /  E N U M
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class wmcAck
+{
+public:
+    /**
+     * Tracked commands.
+     */
+    enum command
+    {
+        powerOff = 0, /* Track power off, confirmed by track power off broadcast. */
+        stop,         /* Emergency stop, confirmed by emergency stop or track power off broadcast. */
+        locStop       /* Drive command with speed zero, confirmed by loc info with speed zero. */
+    };
+
+    /**
+     * Statistics of the tracked commands.
+     */
+    struct statistics
+    {
+        uint32_t Tracked;         /* Commands tracked. */
+        uint32_t Confirmed;       /* Commands confirmed by the control unit. */
+        uint32_t Retries;         /* Retransmissions. */
+        uint32_t Failed;          /* Commands not confirmed after the maximum number of retries. */
+        uint32_t Cancelled;       /* Commands replaced by a newer command before confirmation. */
+        uint32_t ConfirmTimeLast; /* Time between first transmit and confirmation of last command in msec. */
+        uint32_t ConfirmTimeMax;  /* Maximum time between first transmit and confirmation in msec. */
+    };
+
+    /**
+     * Constructor.
+     */
+    wmcAck();
+
+    /**
+     * Start tracking a transmitted command. For locStop the transmitted drive data is needed for the retransmit.
+     */
+    void Track(command Command, const Z21Slave::locInfo* LocInfoPtr);
+
+    /**
+     * Stop tracking commands made obsolete by a newer command, e.g. a drive command with speed for the loc address.
+     */
+    void Cancel(command Command, uint16_t Address);
+
+    /**
+     * Check received data against the tracked commands.
+     */
+    void Confirm(Z21Slave::dataType Type, const Z21Slave::locInfo* LocInfoPtr);
+
+    /**
+     * Get a command for which the retransmit interval expired. Returns false when no retransmit is needed.
+     */
+    bool RetransmitGet(command& Command, Z21Slave::locInfo& LocInfo);
+
+    /**
+     * Get the statistics.
+     */
+    const statistics& StatisticsGet(void) { return (m_Statistics); }
+
+private:
+    static const uint8_t ACK_ENTRIES         = 6;   /* Number of commands tracked at the same time. */
+    static const uint8_t ACK_RETRY_MAX       = 10;  /* Retransmits before giving up. */
+    static const uint32_t ACK_RETRY_INTERVAL = 100; /* Time between retransmits in msec. */
+
+    /**
+     * Tracked command.
+     */
+    struct entry
+    {
+        bool Active;
+        command Command;
+        Z21Slave::locInfo LocInfo; /* Drive data of locStop. */
+        uint8_t Retries;
+        uint32_t FirstTime;
+        uint32_t LastTime;
+    };
+
+    void Confirmed(entry* EntryPtr);
+
+    entry m_Entries[ACK_ENTRIES];
+    statistics m_Statistics;
+};
+
+#endif
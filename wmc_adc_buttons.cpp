@@ -0,0 +1,129 @@
+/***********************************************************************************************************************
+   @file   wmc_adc_buttons.cpp
+   @brief  Decoding of the buttons on the ADC input with a lookup table, median filter and debounce.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "wmc_adc_buttons.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   F O R W A R D  D E C L A R A T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+wmcAdcButtons::wmcAdcButtons()
+{
+    uint8_t Index;
+
+    memset(m_Table, BUTTON_NONE, sizeof(m_Table));
+    for (Index = 0; Index < MEDIAN_SIZE; Index++)
+    {
+        m_Samples[Index] = ADC_RANGE - 1;
+    }
+
+    m_SampleIndex    = 0;
+    m_Candidate      = BUTTON_NONE;
+    m_CandidateCount = 0;
+    m_Button         = BUTTON_NONE;
+    memset(&m_Statistics, 0, sizeof(m_Statistics));
+}
+
+/***********************************************************************************************************************
+ */
+void wmcAdcButtons::Build(const uint16_t* AdcValuePtr, uint8_t Buttons, uint16_t Reference)
+{
+    uint16_t Reading;
+    uint8_t Index;
+
+    memset(m_Table, BUTTON_NONE, sizeof(m_Table));
+
+    /* First matching button wins, a button read near zero matches all readings up to its learned value plus the
+     * window, so noise above its learned value is not decoded as a release. */
+    for (Reading = 0; (Reading < ADC_RANGE) && (Reading < Reference); Reading++)
+    {
+        for (Index = 0; (Index < Buttons) && (m_Table[Reading] == BUTTON_NONE); Index++)
+        {
+            if (AdcValuePtr[Index] < ADC_WINDOW)
+            {
+                if (Reading < (AdcValuePtr[Index] + ADC_WINDOW))
+                {
+                    m_Table[Reading] = Index;
+                }
+            }
+            else if ((Reading > (AdcValuePtr[Index] - ADC_WINDOW)) && (Reading < (AdcValuePtr[Index] + ADC_WINDOW)))
+            {
+                m_Table[Reading] = Index;
+            }
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ */
+uint8_t wmcAdcButtons::Sample(uint16_t Reading)
+{
+    uint8_t Result = BUTTON_NONE;
+    uint16_t Median;
+    uint16_t A;
+    uint16_t B;
+    uint16_t C;
+    uint8_t Button;
+
+    m_Statistics.Samples++;
+
+    /* Median of the last three samples removes single sample spikes. */
+    m_Samples[m_SampleIndex] = (Reading < ADC_RANGE) ? Reading : (ADC_RANGE - 1);
+    m_SampleIndex            = (m_SampleIndex + 1) % MEDIAN_SIZE;
+
+    A      = m_Samples[0];
+    B      = m_Samples[1];
+    C      = m_Samples[2];
+    Median = (A < B) ? ((B < C) ? B : ((A < C) ? C : A)) : ((A < C) ? A : ((B < C) ? C : B));
+    Button = m_Table[Median];
+
+    /* Debounce, a change is accepted when the filtered button is equal for several samples. */
+    if (Button == m_Candidate)
+    {
+        if (m_CandidateCount < DEBOUNCE_SAMPLES)
+        {
+            m_CandidateCount++;
+        }
+    }
+    else
+    {
+        if ((m_Candidate != m_Button) && (m_CandidateCount > 0))
+        {
+            m_Statistics.Rejected++;
+        }
+
+        m_Candidate      = Button;
+        m_CandidateCount = 1;
+    }
+
+    if ((m_CandidateCount >= DEBOUNCE_SAMPLES) && (m_Candidate != m_Button))
+    {
+        m_Button = m_Candidate;
+        if (m_Button != BUTTON_NONE)
+        {
+            m_Statistics.Presses++;
+            Result = m_Button;
+        }
+    }
+
+    return (Result);
+}
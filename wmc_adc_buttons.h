@@ -0,0 +1,74 @@
+/**
+ **********************************************************************************************************************
+ * @file  wmc_adc_buttons.h
+ * @brief Decoding of the buttons on the ADC input with a lookup table, median filter and debounce.
+ ***********************************************************************************************************************
+ */
+#ifndef WMC_ADC_BUTTONS_H
+#define WMC_ADC_BUTTONS_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * T Y P E D  E F S  /  E N U M
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class wmcAdcButtons
+{
+public:
+    static const uint8_t BUTTON_NONE = 0xFF; /* No button pressed. */
+
+    /**
+     * Statistics of the button decoding.
+     */
+    struct statistics
+    {
+        uint32_t Samples;  /* ADC samples processed. */
+        uint32_t Presses;  /* Debounced button presses. */
+        uint32_t Rejected; /* Button changes not stable long enough to be accepted. */
+    };
+
+    /**
+     * Constructor.
+     */
+    wmcAdcButtons();
+
+    /**
+     * Compile the learned ADC values of the buttons into the decode table. Readings at or above the reference (no
+     * button pressed) value are not decoded.
+     */
+    void Build(const uint16_t* AdcValuePtr, uint8_t Buttons, uint16_t Reference);
+
+    /**
+     * Process an ADC sample. Returns the index of a button when its press is detected, else BUTTON_NONE.
+     */
+    uint8_t Sample(uint16_t Reading);
+
+    /**
+     * Get the statistics.
+     */
+    const statistics& StatisticsGet(void) { return (m_Statistics); }
+
+private:
+    static const uint16_t ADC_RANGE       = 1024; /* 10 bit ADC. */
+    static const uint8_t MEDIAN_SIZE      = 3;    /* Samples in the median filter. */
+    static const uint8_t DEBOUNCE_SAMPLES = 3;    /* Equal filtered samples needed for a button change. */
+    static const uint16_t ADC_WINDOW      = 20;   /* Allowed deviation of a reading from the learned value. */
+
+    uint8_t m_Table[ADC_RANGE];
+    uint16_t m_Samples[MEDIAN_SIZE];
+    uint8_t m_SampleIndex;
+    uint8_t m_Candidate;
+    uint8_t m_CandidateCount;
+    uint8_t m_Button;
+    statistics m_Statistics;
+};
+
+#endif
@@ -30,7 +30,8 @@ class stateInitUdpConnect;
 class stateInitUdpConnectFail;
 class stateAdcButtons;
 class stateSetUpWifiFail;
-class stateInitBroadcast;
+class stateInitHandshake;
+class stateSessionResume;
 class stateInitStatusGet;
 class stateInitLocInfoGet;
 class statePowerOff;
@@ -46,6 +47,8 @@ class stateMenuLocAdd;
 class stateMenuLocFunctionsAdd;
 class stateMenuLocFunctionsChange;
 class stateMenuLocDelete;
+class stateMenuSpeedRamp;
+class stateMenuConsist;
 class stateCommandLineInterfaceActive;
 class stateCvProgramming;
 
@@ -60,39 +63,86 @@ WiFiUDP wmcApp::m_WifiUdp;
 Z21Slave wmcApp::m_z21Slave;
 WmcCli wmcApp::m_WmcCommandLine;
 LocStorage wmcApp::m_LocStorage;
+wmcEep wmcApp::m_wmcEep;
+wmcBootLog wmcApp::m_BootLog;
+wmcAck wmcApp::m_wmcAck;
+wmcAdcButtons wmcApp::m_AdcButtons;
+wmcTimer wmcApp::m_Timer;
+wmcEventQueue wmcApp::m_EventQueue;
+wmcPulseAccel wmcApp::m_PulseAccel;
+wmcSpeedRamp wmcApp::m_SpeedRamp;
+wmcConsist wmcApp::m_Consist;
+wmcLocImport wmcApp::m_locImport;
+wmcLocIndex wmcApp::m_locIndex;
+wmcLocCache wmcApp::m_locCache;
 bool wmcApp::m_locSelection;
-uint8_t wmcApp::m_IpAddresZ21[4];
-uint8_t wmcApp::m_IpAddresWmc[4];
-uint8_t wmcApp::m_IpGateway[4];
-uint8_t wmcApp::m_IpSubnet[4];
-byte wmcApp::m_WmcPacketBuffer[40];
+EepCfg::config wmcApp::m_Config;
+bool wmcApp::m_ConfigValid          = false;
+bool wmcApp::m_WifiStarted          = false;
+bool wmcApp::m_WifiFastConnect      = false;
+bool wmcApp::m_WifiLeaseReuse       = false;
+uint32_t wmcApp::m_WifiStartTime    = 0;
+uint32_t wmcApp::m_WifiPollInterval = 0;
+byte wmcApp::m_WmcPacketBuffer[RX_PACKET_BUFFER_SIZE];
+int wmcApp::m_RxPacketPending                 = 0;
 wmcApp::powerState wmcApp::m_TrackPower       = powerState::off;
 uint16_t wmcApp::m_ConnectCnt                 = 0;
+uint8_t wmcApp::m_HandshakePending            = 0;
+bool wmcApp::m_LinkMonitorActive              = false;
+uint32_t wmcApp::m_RxLastTime                 = 0;
+uint32_t wmcApp::m_LinkProbeTime              = 0;
+uint32_t wmcApp::m_LinkLostTime               = 0;
+wmcApp::resumeMode wmcApp::m_ResumeMode       = wmcApp::resumeLoc;
+Z21Slave::dataType wmcApp::m_ResumeStatus     = Z21Slave::none;
 uint16_t wmcApp::m_UdpLocalPort               = 21105;
 uint16_t wmcApp::m_locAddressAdd              = 1;
 uint16_t wmcApp::m_TurnOutAddress             = ADDRESS_TURNOUT_MIN;
 Z21Slave::turnout wmcApp::m_TurnOutDirection  = Z21Slave::directionOff;
-uint32_t wmcApp::m_TurnoutOffDelay            = 0;
 uint8_t wmcApp::m_locFunctionAdd              = 0;
 uint8_t wmcApp::m_locFunctionChange           = 0;
 uint16_t wmcApp::m_locAddressDelete           = 0;
+bool wmcApp::m_SpeedRampEditBrake             = false;
+uint16_t wmcApp::m_ConsistMemberAddress       = 0;
+bool wmcApp::m_ConsistMemberFlip              = false;
 uint16_t wmcApp::m_locAddressChange           = 0;
 uint16_t wmcApp::m_locDbDataTransmitCnt       = 0;
 uint32_t wmcApp::m_locDbDataTransmitCntRepeat = 0;
-bool wmcApp::m_WmcLocSpeedRequestPending      = false;
+uint32_t wmcApp::m_locDbDataProgressTime      = 0;
+bool wmcApp::m_SpeedTxPending                 = false;
+bool wmcApp::m_SpeedInFlight                  = false;
+uint16_t wmcApp::m_SpeedTxSent                = 0;
+uint32_t wmcApp::m_SpeedTxTime                = 0;
+uint32_t wmcApp::m_SpeedDeltaTime             = 0;
+bool wmcApp::m_LocInfoPollPending             = false;
+uint32_t wmcApp::m_LocInfoRxTime              = 0;
+uint32_t wmcApp::m_LocInfoPollTimeout         = LOC_INFO_POLL_TIMEOUT_MIN;
+uint32_t wmcApp::m_TxMinuteStart              = 0;
+bool wmcApp::m_LocSelectPending               = false;
+uint16_t wmcApp::m_TxMinuteDatagrams          = 0;
+uint16_t wmcApp::m_TxMinuteMessages           = 0;
 bool wmcApp::m_CvPomProgramming               = false;
 bool wmcApp::m_CvPomProgrammingFromPowerOn    = false;
 bool wmcApp::m_EmergencyStopEnabled           = false;
-bool wmcApp::m_ButtonPrevious                 = false;
-uint8_t wmcApp::m_ButtonIndexPrevious         = 0;
 uint8_t wmcApp::m_AdcIndex                    = 0;
 uint16_t wmcApp::m_AdcButtonValuePrevious     = 1024;
+uint32_t wmcApp::m_PowerButtonPressTime       = 0;
+bool wmcApp::m_PowerButtonQueued              = false;
 
 uint8_t wmcApp::m_locFunctionAssignment[5];
+uint8_t wmcApp::m_locDbDataEchoed[32];
 uint16_t wmcApp::m_AdcButtonValue[ADC_VALUES_ARRAY_SIZE];
 
-pushButtonsEvent wmcApp::m_wmcPushButtonEvent;
+wmcApp::configStatistics wmcApp::m_ConfigStatistics = { 0, 0, 0, 0, 0, 0, 0 };
+wmcApp::linkStatistics wmcApp::m_LinkStatistics     = { 0, 0, 0, 0 };
+wmcApp::rxStatistics wmcApp::m_RxStatistics = { 0, 0, 0, 0, 0, 0 };
+wmcApp::txStatistics wmcApp::m_TxStatistics = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+wmcApp::powerButtonStatistics wmcApp::m_PowerButtonStatistics = { 0, 0, 0 };
+wmcApp::speedStatistics wmcApp::m_SpeedStatistics = { 0, 0, 0, 0, 0, 0, 0 };
+wmcApp::locSelectStatistics wmcApp::m_LocSelectStatistics = { 0, 0, 0 };
+uint8_t wmcApp::m_TxQueue[TX_QUEUE_SIZE][TX_MESSAGE_SIZE_MAX];
+uint8_t wmcApp::m_TxQueueHead = 0;
 Z21Slave::locInfo wmcApp::m_WmcLocInfoControl;
+wmcSpeedRamp::config wmcApp::m_SpeedRampEdit;
 Z21Slave::locInfo* wmcApp::m_WmcLocInfoReceived = NULL;
 Z21Slave::locLibData* wmcApp::m_WmcLocLibInfo   = NULL;
 
@@ -105,26 +155,50 @@ class stateInit : public wmcApp
 
     void entry() override
     {
+        m_BootLog.Init();
         m_wmcTft.Init();
         m_wmcTft.Clear();
         m_LocStorage.Init();
+        WmcConfigLoad();
+        m_BootLog.Mark(wmcBootLog::configLoaded);
+
+        /* Association is the slowest part of the boot, start it before the local init. */
+        if (m_ConfigValid == true)
+        {
+            WmcWifiStart();
+        }
     };
 
     void react(updateEvent100msec const&) override
     {
-        uint8_t buttonAdcValid;
+        uint8_t Index = 0;
 
-        buttonAdcValid = EEPROM.read(EepCfg::ButtonAdcValuesAddressValid);
-        if (buttonAdcValid != 1)
+        if ((m_ConfigValid == false) || (m_Config.ButtonAdcValuesValid != 1))
         {
             transit<stateAdcButtons>();
         }
         else
         {
-            EEPROM.get(EepCfg::ButtonAdcValuesAddress, m_AdcButtonValue);
+            for (Index = 0; Index < ADC_VALUES_ARRAY_SIZE; Index++)
+            {
+                m_AdcButtonValue[Index] = (static_cast<uint16_t>(m_Config.ButtonAdcValues[Index * 2]) << 8)
+                    | m_Config.ButtonAdcValues[(Index * 2) + 1];
+            }
+
+            m_AdcButtons.Build(
+                m_AdcButtonValue, ADC_VALUES_ARRAY_REFERENCE_INDEX, m_AdcButtonValue[ADC_VALUES_ARRAY_REFERENCE_INDEX]);
             transit<stateSetUpWifi>();
         }
     };
+
+    /**
+     * No buttons in this state, the ADC is not sampled to leave the wifi undisturbed.
+     */
+    void react(updateEvent5msec const&) override
+    {
+        WmcTimerCheck();
+        WmcEventQueueCheck();
+    };
 };
 
 /***********************************************************************************************************************
@@ -137,91 +211,96 @@ class stateSetUpWifi : public wmcApp
      */
     void entry() override
     {
-        char SsidName[50];
-        char SsidPassword[64];
-        uint8_t StaticIp = 0;
-        uint8_t Index    = 0;
-
-        memset(SsidName, '\0', sizeof(SsidName));
-        memset(SsidPassword, '\0', sizeof(SsidPassword));
-
         m_ConnectCnt = 0;
 
+        /* Normally started in stateInit already, association continues while the modules are initialized. */
+        WmcWifiStart();
+
         /* Init modules. */
         m_wmcTft.ShowName();
         m_wmcTft.ShowVersion(SW_MAJOR, SW_MINOR, SW_PATCH);
         m_EmergencyStopEnabled = m_LocStorage.EmergencyOptionGet();
 
         m_locLib.Init(m_LocStorage);
+        m_locIndex.Build(m_locLib);
+        WmcSpeedRampLoad();
+        WmcConsistLoad();
         m_WmcCommandLine.Init(m_locLib, m_LocStorage);
-        m_wmcTft.UpdateStatus("CONNECTING TO WIFI", true, WmcTft::color_yellow);
-        m_wmcTft.UpdateRunningWheel(m_ConnectCnt);
-
-        /* Get SSID data from EEPROM. */
-        EEPROM.get(EepCfg::SsidNameAddress, SsidName);
-        EEPROM.get(EepCfg::SsidPasswordAddress, SsidPassword);
-
-        /* Get IP data. */
-        EEPROM.get(EepCfg::EepIpSubnet, m_IpSubnet);
-        EEPROM.get(EepCfg::EepIpGateway, m_IpGateway);
-        EEPROM.get(EepCfg::EepIpAddressWmc, m_IpAddresWmc);
-        EEPROM.get(EepCfg::EepIpAddressZ21, m_IpAddresZ21);
-        StaticIp = EEPROM.read(EepCfg::StaticIpAddress);
-
-        /* Get ADC button data. */
-        for (Index = 0; Index < ADC_VALUES_ARRAY_SIZE; Index++)
-        {
-            m_AdcButtonValue[Index] = (uint16_t)(EEPROM.read(EepCfg::ButtonAdcValuesAddress + (Index * 2))) << 8;
-            m_AdcButtonValue[Index] |= (uint16_t)(EEPROM.read(EepCfg::ButtonAdcValuesAddress + (Index * 2) + 1));
-        }
-
-        m_wmcTft.ShowNetworkName(SsidName);
-
-        /* Start wifi connection. */
-        WiFi.mode(WIFI_STA);
+        m_BootLog.Mark(wmcBootLog::localInit);
 
-        /* If static IP active set fixed IP settings for static IP. */
-        if (StaticIp == 1)
+        /* A status poll expired while still in the init state is done now. */
+        if (m_Timer.Active(wmcTimer::wifiPoll) == false)
         {
-            IPAddress ip(m_IpAddresWmc[0], m_IpAddresWmc[1], m_IpAddresWmc[2], m_IpAddresWmc[3]);
-            IPAddress gateway(m_IpGateway[0], m_IpGateway[1], m_IpGateway[2], m_IpGateway[3]);
-            IPAddress subnet(m_IpSubnet[0], m_IpSubnet[1], m_IpSubnet[2], m_IpSubnet[3]);
-
-            WiFi.config(ip, gateway, subnet);
+            m_Timer.Start(wmcTimer::wifiPoll, 0);
         }
 
-        /* Check for password length, if no password connect with NULL. */
-        if (strlen(SsidPassword) == 0)
-        {
-            WiFi.begin(SsidName, NULL);
-        }
-        else
+        /* Skip the connecting screen when associated already, the next state replaces it immediately. */
+        if (WiFi.status() != WL_CONNECTED)
         {
-            WiFi.begin(SsidName, SsidPassword);
+            m_wmcTft.UpdateStatus("CONNECTING TO WIFI", true, WmcTft::color_yellow);
+            m_wmcTft.UpdateRunningWheel(m_ConnectCnt);
+            m_wmcTft.ShowNetworkName(m_Config.SsidName);
         }
     };
 
     /**
-     * Wait for connection or when no connection can be made enter wifi error state.
+     * Stop polling the wifi status.
      */
-    void react(updateEvent500msec const&) override
+    void exit() override { m_Timer.Stop(wmcTimer::wifiPoll); };
+
+    /**
+     * Wait for connection with increasing poll interval. If the connect with the cached access point data does not
+     * succeed fall back to a full scan, when no connection can be made enter wifi error state.
+     */
+    void react(timerEvent const& e) override
     {
-        if (WiFi.status() != WL_CONNECTED)
+        uint32_t Now = millis();
+        wl_status_t Status;
+
+        switch (e.Id)
         {
-            m_ConnectCnt++;
-            if (m_ConnectCnt < CONNECT_CNT_MAX_FAIL_CONNECT_WIFI)
+        case wmcTimer::wifiPoll:
+            Status = WiFi.status();
+
+            if (m_WifiPollInterval < WIFI_POLL_INTERVAL_MAX)
             {
-                m_wmcTft.UpdateRunningWheel(m_ConnectCnt);
+                m_WifiPollInterval *= 2;
             }
-            else
+            m_Timer.Start(wmcTimer::wifiPoll, m_WifiPollInterval);
+
+            if (Status == WL_CONNECTED)
+            {
+                /* Start UDP */
+                m_BootLog.Mark(wmcBootLog::wifiAssociated);
+                WmcWifiCacheStore();
+                transit<stateInitUdpConnect>();
+            }
+            else if ((m_WifiFastConnect == true)
+                && ((Status == WL_CONNECT_FAILED) || (Status == WL_NO_SSID_AVAIL)
+                       || ((Now - m_WifiStartTime) >= WIFI_FAST_CONNECT_TIMEOUT)))
+            {
+                WmcWifiFallback();
+            }
+            else if ((Now - m_WifiStartTime) >= WIFI_CONNECT_TIMEOUT)
             {
                 transit<stateSetUpWifiFail>();
             }
+            break;
+        default: wmcApp::react(e); break;
         }
-        else
+    };
+
+    /**
+     * Update the running wheel.
+     */
+    void react(updateEvent50msec const&) override
+    {
+        uint32_t Now = millis();
+
+        if (((Now - m_WifiStartTime) / WIFI_WHEEL_INTERVAL) != m_ConnectCnt)
         {
-            /* Start UDP */
-            transit<stateInitUdpConnect>();
+            m_ConnectCnt = (Now - m_WifiStartTime) / WIFI_WHEEL_INTERVAL;
+            m_wmcTft.UpdateRunningWheel(m_ConnectCnt);
         }
     };
 
@@ -229,6 +308,15 @@ class stateSetUpWifi : public wmcApp
      * Avoid sending data.
      */
     void react(updateEvent3sec const&) override{};
+
+    /**
+     * No buttons in this state, the ADC is not sampled to leave the wifi undisturbed.
+     */
+    void react(updateEvent5msec const&) override
+    {
+        WmcTimerCheck();
+        WmcEventQueueCheck();
+    };
 };
 
 /***********************************************************************************************************************
@@ -241,6 +329,11 @@ class stateSetUpWifiFail : public wmcApp
     void react(updateEvent50msec const&) override{};
     void react(updateEvent500msec const&) override{};
     void react(updateEvent3sec const&) override{};
+    void react(updateEvent5msec const&) override
+    {
+        WmcTimerCheck();
+        WmcEventQueueCheck();
+    };
 };
 
 /***********************************************************************************************************************
@@ -255,25 +348,32 @@ class stateInitUdpConnect : public wmcApp
     {
         char IpStr[20];
 
-        snprintf(IpStr, sizeof(IpStr), "%hu.%hu.%hu.%hu", m_IpAddresZ21[0], m_IpAddresZ21[1], m_IpAddresZ21[2],
-            m_IpAddresZ21[3]);
+        snprintf(IpStr, sizeof(IpStr), "%hu.%hu.%hu.%hu", m_Config.IpAddressZ21[0], m_Config.IpAddressZ21[1],
+            m_Config.IpAddressZ21[2], m_Config.IpAddressZ21[3]);
+        m_BootLog.Mark(wmcBootLog::udpConnect);
         m_ConnectCnt = 0;
         m_wmcTft.ClearNetworkName();
         m_wmcTft.UpdateStatus("CONNECT TO CONTROL", true, WmcTft::color_yellow);
 
         m_wmcTft.ShowIpAddressToConnectTo(IpStr);
         m_wmcTft.UpdateRunningWheel(m_ConnectCnt);
+        m_RxPacketPending = 0;
         m_WifiUdp.begin(m_UdpLocalPort);
     }
 
     /**
-     * Request status to check connection with control.
+     * Request status to check connection with control. Without a reply on a reused lease connect again with DHCP.
      */
     void react(updateEvent500msec const&) override
     {
         m_ConnectCnt++;
 
-        if (m_ConnectCnt < CONNECT_CNT_MAX_FAIL_CONNECT_UDP)
+        if ((m_WifiLeaseReuse == true) && (m_ConnectCnt > CONNECT_CNT_LEASE_CONFLICT))
+        {
+            WmcWifiLeaseDrop();
+            transit<stateSetUpWifi>();
+        }
+        else if (m_ConnectCnt < CONNECT_CNT_MAX_FAIL_CONNECT_UDP)
         {
             m_z21Slave.LanGetStatus();
             WmcCheckForDataTx();
@@ -288,13 +388,16 @@ class stateInitUdpConnect : public wmcApp
     /**
      * Handle the response on the status message.
      */
-    void react(updateEvent50msec const&) override
+    void react(z21DataEvent const& e) override
     {
-        switch (WmcCheckForDataRx())
+        switch (e.Type)
         {
         case Z21Slave::trackPowerOff:
         case Z21Slave::programmingMode:
-        case Z21Slave::trackPowerOn: transit<stateInitBroadcast>(); break;
+        case Z21Slave::trackPowerOn:
+            m_BootLog.Mark(wmcBootLog::udpReply);
+            transit<stateInitHandshake>();
+            break;
         default: break;
         }
     };
@@ -303,6 +406,15 @@ class stateInitUdpConnect : public wmcApp
      * Override update during init.
      */
     void react(updateEvent3sec const&) override{};
+
+    /**
+     * No buttons in this state, the ADC is not sampled to leave the wifi undisturbed.
+     */
+    void react(updateEvent5msec const&) override
+    {
+        WmcTimerCheck();
+        WmcEventQueueCheck();
+    };
 };
 
 /***********************************************************************************************************************
@@ -316,16 +428,28 @@ class stateInitUdpConnectFail : public wmcApp
      * Handle the response on the status message of the 3 seconds update event, control device might be enabled
      * somewhat later.
      */
-    void react(updateEvent50msec const&) override
+    void react(z21DataEvent const& e) override
     {
-        switch (WmcCheckForDataRx())
+        switch (e.Type)
         {
         case Z21Slave::trackPowerOff:
         case Z21Slave::programmingMode:
-        case Z21Slave::trackPowerOn: transit<stateInitBroadcast>(); break;
+        case Z21Slave::trackPowerOn:
+            m_BootLog.Mark(wmcBootLog::udpReply);
+            transit<stateInitHandshake>();
+            break;
         default: break;
         }
     };
+
+    /**
+     * No buttons in this state, the ADC is not sampled to leave the wifi undisturbed.
+     */
+    void react(updateEvent5msec const&) override
+    {
+        WmcTimerCheck();
+        WmcEventQueueCheck();
+    };
 };
 
 /***********************************************************************************************************************
@@ -350,9 +474,8 @@ class stateAdcButtons : public wmcApp
      */
     void react(updateEvent100msec const&) override
     {
-        uint8_t Index          = 0;
-        uint8_t buttonAdcValid = 0;
-        uint16_t AdcValue      = analogRead(WMC_APP_ANALOG_IN);
+        uint8_t Index     = 0;
+        uint16_t AdcValue = analogRead(WMC_APP_ANALOG_IN);
 
         if (AdcValue >= (m_AdcButtonValue[ADC_VALUES_ARRAY_REFERENCE_INDEX] - 100))
         {
@@ -363,18 +486,19 @@ class stateAdcButtons : public wmcApp
 
                 if (m_AdcIndex >= 6)
                 {
-                    // Store all "learned" data.
+                    // Store all "learned" data in one commit.
                     for (Index = 0; Index < ADC_VALUES_ARRAY_SIZE; Index++)
                     {
-                        EEPROM.write(
-                            EepCfg::ButtonAdcValuesAddress + (Index * 2), (m_AdcButtonValue[Index] >> 8) & 0xFF);
-                        EEPROM.write(EepCfg::ButtonAdcValuesAddress + (Index * 2) + 1, m_AdcButtonValue[Index] & 0xFF);
-                        EEPROM.commit();
+                        m_Config.ButtonAdcValues[Index * 2]       = (m_AdcButtonValue[Index] >> 8) & 0xFF;
+                        m_Config.ButtonAdcValues[(Index * 2) + 1] = m_AdcButtonValue[Index] & 0xFF;
                     }
 
-                    buttonAdcValid = 1;
-                    EEPROM.write(EepCfg::ButtonAdcValuesAddressValid, buttonAdcValid);
-                    EEPROM.commit();
+                    m_Config.ButtonAdcValuesValid = 1;
+                    WmcConfigStore();
+                    m_wmcEep.Commit();
+
+                    m_AdcButtons.Build(m_AdcButtonValue, ADC_VALUES_ARRAY_REFERENCE_INDEX,
+                        m_AdcButtonValue[ADC_VALUES_ARRAY_REFERENCE_INDEX]);
 
                     transit<stateSetUpWifi>();
                 }
@@ -391,31 +515,116 @@ class stateAdcButtons : public wmcApp
             m_AdcButtonValuePrevious = AdcValue;
         }
     };
+
+    /**
+     * No buttons in this state, the ADC is not sampled to leave the wifi undisturbed.
+     */
+    void react(updateEvent5msec const&) override
+    {
+        WmcTimerCheck();
+        WmcEventQueueCheck();
+    };
 };
 
 /***********************************************************************************************************************
- * Sent broadcast message.
+ * Set the broadcast flags and request status and loc info in one go, the replies are accepted in any order.
  */
-class stateInitBroadcast : public wmcApp
+class stateInitHandshake : public wmcApp
 {
     /**
-     * Transmit broadcast info.
+     * Transmit broadcast flags, status request and loc info request, packed in one datagram.
      */
     void entry() override
     {
-        m_z21Slave.LanSetBroadCastFlags(1);
-        WmcCheckForDataTx();
+        m_BootLog.Mark(wmcBootLog::broadcast);
+        m_BootLog.Mark(wmcBootLog::statusGet);
+        m_BootLog.Mark(wmcBootLog::locInfoGet);
+
+        m_HandshakePending = HANDSHAKE_STATUS | HANDSHAKE_LOC_INFO;
+        m_locLib.UpdateLocData(m_locLib.GetActualLocAddress());
+        WmcHandshakeTransmit();
+    };
+
+    /**
+     * Handle the replies, when all are received continue with the state matching the track power.
+     */
+    void react(z21DataEvent const& e) override
+    {
+        switch (e.Type)
+        {
+        case Z21Slave::trackPowerOff:
+        case Z21Slave::programmingMode:
+            m_TrackPower = powerState::off;
+            m_HandshakePending &= ~HANDSHAKE_STATUS;
+            m_BootLog.Mark(wmcBootLog::statusReceived);
+            break;
+        case Z21Slave::trackPowerOn:
+            m_TrackPower = powerState::on;
+            m_HandshakePending &= ~HANDSHAKE_STATUS;
+            m_BootLog.Mark(wmcBootLog::statusReceived);
+            break;
+        case Z21Slave::emergencyStop:
+            m_TrackPower = powerState::emergency;
+            m_HandshakePending &= ~HANDSHAKE_STATUS;
+            m_BootLog.Mark(wmcBootLog::statusReceived);
+            break;
+        case Z21Slave::locinfo:
+            m_BootLog.Mark(wmcBootLog::locInfoReceived);
+            if ((m_HandshakePending & HANDSHAKE_LOC_INFO) != 0)
+            {
+                m_wmcTft.Clear();
+                if (updateLocInfoOnScreen(true) == true)
+                {
+                    m_HandshakePending &= ~HANDSHAKE_LOC_INFO;
+                    m_locLib.SpeedUpdate(m_WmcLocInfoReceived->Speed);
+                    WmcConsistInfoGet();
+
+                    if (m_WmcLocInfoReceived->Direction == Z21Slave::locDirectionForward)
+                    {
+                        m_locLib.DirectionSet(directionForward);
+                    }
+                    else
+                    {
+                        m_locLib.DirectionSet(directionBackWard);
+                    }
+                }
+            }
+            break;
+        default: break;
+        }
+
+        if (m_HandshakePending == 0)
+        {
+            m_BootLog.Mark(wmcBootLog::drivable);
+            WmcLinkMonitorStart();
+
+            switch (m_TrackPower)
+            {
+            case powerState::off: transit<statePowerOff>(); break;
+            case powerState::on: transit<statePowerOn>(); break;
+            case powerState::emergency: transit<stateEmergencyStop>(); break;
+            }
+        }
     };
 
     /**
-     * Continue to next state.
+     * Not all replies received, repeat the missing requests.
      */
-    void react(updateEvent50msec const&) override { transit<stateInitStatusGet>(); };
+    void react(updateEvent500msec const&) override { WmcHandshakeTransmit(); };
 
     /**
      * Override update during init.
      */
     void react(updateEvent3sec const&) override{};
+
+    /**
+     * No buttons in this state, the ADC is not sampled to leave the wifi undisturbed.
+     */
+    void react(updateEvent5msec const&) override
+    {
+        WmcTimerCheck();
+        WmcEventQueueCheck();
+    };
 };
 
 /***********************************************************************************************************************
@@ -428,6 +637,7 @@ class stateInitStatusGet : public wmcApp
      */
     void entry() override
     {
+        m_BootLog.Mark(wmcBootLog::statusGet);
         m_z21Slave.LanGetStatus();
         WmcCheckForDataTx();
     };
@@ -435,24 +645,28 @@ class stateInitStatusGet : public wmcApp
     /**
      * Check response of status request.
      */
-    void react(updateEvent50msec const&) override
+    void react(z21DataEvent const& e) override
     {
-        switch (WmcCheckForDataRx())
+        switch (e.Type)
         {
         case Z21Slave::trackPowerOff:
             m_TrackPower = powerState::off;
+            m_BootLog.Mark(wmcBootLog::statusReceived);
             transit<stateInitLocInfoGet>();
             break;
         case Z21Slave::programmingMode:
             m_TrackPower = powerState::off;
+            m_BootLog.Mark(wmcBootLog::statusReceived);
             transit<stateInitLocInfoGet>();
             break;
         case Z21Slave::trackPowerOn:
             m_TrackPower = powerState::on;
+            m_BootLog.Mark(wmcBootLog::statusReceived);
             transit<stateInitLocInfoGet>();
             break;
         case Z21Slave::emergencyStop:
             m_TrackPower = powerState::emergency;
+            m_BootLog.Mark(wmcBootLog::statusReceived);
             transit<stateInitLocInfoGet>();
             break;
         default: break;
@@ -462,12 +676,25 @@ class stateInitStatusGet : public wmcApp
     /**
      * No response, retry.
      */
-    void react(updateEvent500msec const&) override { m_z21Slave.LanGetStatus(); };
+    void react(updateEvent500msec const&) override
+    {
+        m_z21Slave.LanGetStatus();
+        WmcCheckForDataTx();
+    };
 
     /**
      * Override update during init.
      */
     void react(updateEvent3sec const&) override{};
+
+    /**
+     * No buttons in this state, the ADC is not sampled to leave the wifi undisturbed.
+     */
+    void react(updateEvent5msec const&) override
+    {
+        WmcTimerCheck();
+        WmcEventQueueCheck();
+    };
 };
 
 /***********************************************************************************************************************
@@ -481,6 +708,7 @@ class stateInitLocInfoGet : public wmcApp
     void entry() override
     {
         /* Get loc data. */
+        m_BootLog.Mark(wmcBootLog::locInfoGet);
         m_locLib.UpdateLocData(m_locLib.GetActualLocAddress());
         m_z21Slave.LanXGetLocoInfo(m_locLib.GetActualLocAddress());
         WmcCheckForDataTx();
@@ -489,15 +717,18 @@ class stateInitLocInfoGet : public wmcApp
     /**
      * Handle response of loc request and if loc data received setup screen.
      */
-    void react(updateEvent50msec const&) override
+    void react(z21DataEvent const& e) override
     {
-        switch (WmcCheckForDataRx())
+        switch (e.Type)
         {
         case Z21Slave::locinfo:
+            m_BootLog.Mark(wmcBootLog::locInfoReceived);
             m_wmcTft.Clear();
             if (updateLocInfoOnScreen(true) == true)
             {
+                m_BootLog.Mark(wmcBootLog::drivable);
                 m_locLib.SpeedUpdate(m_WmcLocInfoReceived->Speed);
+                WmcConsistInfoGet();
 
                 if (m_WmcLocInfoReceived->Direction == Z21Slave::locDirectionForward)
                 {
@@ -533,6 +764,134 @@ class stateInitLocInfoGet : public wmcApp
      * Override update during init.
      */
     void react(updateEvent3sec const&) override{};
+
+    /**
+     * No buttons in this state, the ADC is not sampled to leave the wifi undisturbed.
+     */
+    void react(updateEvent5msec const&) override
+    {
+        WmcTimerCheck();
+        WmcEventQueueCheck();
+    };
+};
+
+/***********************************************************************************************************************
+ * Connection with the control unit lost. Handshake again without clearing the screen and return to the operating
+ * state matching the track power. Selected loc, speed, direction and functions are kept.
+ */
+class stateSessionResume : public wmcApp
+{
+    /**
+     * Show connection lost and start the handshake.
+     */
+    void entry() override
+    {
+        m_LinkMonitorActive = false;
+        m_LinkStatistics.Losses++;
+        m_wmcTft.UpdateStatus("RECONNECTING", false, WmcTft::color_red);
+
+        m_ResumeStatus     = Z21Slave::none;
+        m_HandshakePending = HANDSHAKE_STATUS;
+        if (m_ResumeMode != resumeTurnout)
+        {
+            m_HandshakePending |= HANDSHAKE_LOC_INFO;
+        }
+
+        WmcHandshakeTransmit();
+    };
+
+    /**
+     * Handle the replies, when all are received return to the operating state.
+     */
+    void react(z21DataEvent const& e) override
+    {
+        uint32_t RecoveryTime;
+
+        switch (e.Type)
+        {
+        case Z21Slave::trackPowerOff:
+        case Z21Slave::trackPowerOn:
+        case Z21Slave::programmingMode:
+        case Z21Slave::emergencyStop:
+            m_ResumeStatus = e.Type;
+            m_HandshakePending &= ~HANDSHAKE_STATUS;
+            break;
+        case Z21Slave::locinfo:
+            if (((m_HandshakePending & HANDSHAKE_LOC_INFO) != 0) && (updateLocInfoOnScreen(false) == true))
+            {
+                m_HandshakePending &= ~HANDSHAKE_LOC_INFO;
+                m_locLib.SpeedUpdate(m_WmcLocInfoReceived->Speed);
+
+                if (m_WmcLocInfoReceived->Direction == Z21Slave::locDirectionForward)
+                {
+                    m_locLib.DirectionSet(directionForward);
+                }
+                else
+                {
+                    m_locLib.DirectionSet(directionBackWard);
+                }
+            }
+            break;
+        default: break;
+        }
+
+        if (m_HandshakePending == 0)
+        {
+            RecoveryTime                      = millis() - m_LinkLostTime;
+            m_LinkStatistics.RecoveryTimeLast = RecoveryTime;
+            if (RecoveryTime > m_LinkStatistics.RecoveryTimeMax)
+            {
+                m_LinkStatistics.RecoveryTimeMax = RecoveryTime;
+            }
+
+            if (m_ResumeMode == resumeLocRedraw)
+            {
+                m_wmcTft.Clear();
+                updateLocInfoOnScreen(true);
+            }
+
+            WmcLinkMonitorStart();
+
+            if (m_ResumeMode == resumeTurnout)
+            {
+                switch (m_ResumeStatus)
+                {
+                case Z21Slave::trackPowerOn: transit<stateTurnoutControl>(); break;
+                case Z21Slave::emergencyStop: transit<stateEmergencyStop>(); break;
+                default: transit<stateTurnoutControlPowerOff>(); break;
+                }
+            }
+            else
+            {
+                switch (m_ResumeStatus)
+                {
+                case Z21Slave::trackPowerOn: transit<statePowerOn>(); break;
+                case Z21Slave::programmingMode: transit<statePowerProgrammingMode>(); break;
+                case Z21Slave::emergencyStop: transit<stateEmergencyStop>(); break;
+                default: transit<statePowerOff>(); break;
+                }
+            }
+        }
+    };
+
+    /**
+     * Not all replies received, repeat the missing requests.
+     */
+    void react(updateEvent500msec const&) override { WmcHandshakeTransmit(); };
+
+    /**
+     * Override update, status is requested by the handshake.
+     */
+    void react(updateEvent3sec const&) override{};
+
+    /**
+     * No buttons in this state, the ADC is not sampled to leave the wifi undisturbed.
+     */
+    void react(updateEvent5msec const&) override
+    {
+        WmcTimerCheck();
+        WmcEventQueueCheck();
+    };
 };
 
 /***********************************************************************************************************************
@@ -540,9 +899,6 @@ class stateInitLocInfoGet : public wmcApp
  */
 class statePowerOff : public wmcApp
 {
-    uint8_t Index                    = 0;
-    uint8_t locFunctionAssignment[5] = { 0, 1, 2, 3, 4 };
-
     /**
      * Update status row.
      */
@@ -553,12 +909,21 @@ class statePowerOff : public wmcApp
         m_wmcTft.UpdateSelectedAndNumberOfLocs(m_locLib.GetActualSelectedLocIndex(), m_locLib.GetNumberOfLocs());
     }
 
+    /**
+     * Connection lost, resume with the loc screen as shown.
+     */
+    void react(linkLostEvent const&) override
+    {
+        m_ResumeMode = resumeLoc;
+        transit<stateSessionResume>();
+    };
+
     /**
      * Handle received data.
      */
-    void react(updateEvent50msec const&) override
+    void react(z21DataEvent const& e) override
     {
-        switch (WmcCheckForDataRx())
+        switch (e.Type)
         {
         case Z21Slave::trackPowerOn: transit<statePowerOn>(); break;
         case Z21Slave::programmingMode: transit<statePowerProgrammingMode>(); break;
@@ -581,23 +946,28 @@ class statePowerOff : public wmcApp
             /* First database data show status... */
             if (m_WmcLocLibInfo->Actual == 0)
             {
+                m_locImport.Clear();
                 m_wmcTft.UpdateStatus("RECEIVING", false, WmcTft::color_white);
             }
 
-            /* If loc not present store it. */
-            if (m_locLib.CheckLoc(m_WmcLocLibInfo->Address) == 255)
+            /* If loc not present stage it, staged locs are stored when all locs are received. */
+            if (WmcLocPresent(m_WmcLocLibInfo->Address) == false)
             {
-                m_locLib.StoreLoc(m_WmcLocLibInfo->Address, locFunctionAssignment, m_WmcLocLibInfo->NameStr,
-                    LocLib::storeAddNoAutoSelect);
-                m_wmcTft.UpdateSelectedAndNumberOfLocs(
-                    m_locLib.GetActualSelectedLocIndex(), m_locLib.GetNumberOfLocs());
+                if (m_locImport.Add(m_WmcLocLibInfo->Address, m_WmcLocLibInfo->NameStr) == false)
+                {
+                    WmcLocImportCommit();
+                    m_locImport.Add(m_WmcLocLibInfo->Address, m_WmcLocLibInfo->NameStr);
+                }
             }
 
-            /* If all locs received sort... */
+            /* Store the staged locs when the reception is interrupted. */
+            m_Timer.Start(wmcTimer::locImportCommit, LOC_IMPORT_TIMEOUT);
+
+            /* If all locs received store them... */
             if ((m_WmcLocLibInfo->Actual + 1) == m_WmcLocLibInfo->Total)
             {
-                m_wmcTft.UpdateStatus("SORTING  ", false, WmcTft::color_white);
-                m_locLib.LocBubbleSort();
+                m_Timer.Stop(wmcTimer::locImportCommit);
+                WmcLocImportCommit();
                 m_wmcTft.UpdateStatus("POWER OFF", false, WmcTft::color_red);
             }
             break;
@@ -605,23 +975,38 @@ class statePowerOff : public wmcApp
         }
     }
 
-    void react(updateEvent500msec const&)
+    /**
+     * Handle a stable loc selection and an interrupted loc library reception.
+     */
+    void react(timerEvent const& e) override
     {
-        m_z21Slave.LanXGetLocoInfo(m_locLib.GetActualLocAddress());
-        WmcCheckForDataTx();
+        switch (e.Id)
+        {
+        case wmcTimer::locSelectStable: WmcLocSelectStable(); break;
+        case wmcTimer::locImportCommit:
+            WmcLocImportCommit();
+            m_wmcTft.UpdateStatus("POWER OFF", false, WmcTft::color_red);
+            break;
+        default: wmcApp::react(e); break;
+        }
     };
 
     /**
-     * Keep alive.
+     * Store loc library data received so far.
      */
-    void react(updateEvent3sec const&) override
+    void exit() override
     {
-        m_z21Slave.LanXGetLocoInfo(m_locLib.GetActualLocAddress());
-        WmcCheckForDataTx();
-    }
+        m_Timer.Stop(wmcTimer::locImportCommit);
+        WmcLocImportCommit();
+    };
 
     /**
-     * Check button event data.
+     * Loc data is received by broadcast, only request it when nothing was heard for some time.
+     */
+    void react(updateEvent500msec const&) override { WmcLocInfoPoll(); };
+
+    /**
+     * Check button event data.
      */
     void react(pushButtonsEvent const& e) override
     {
@@ -629,8 +1014,7 @@ class statePowerOff : public wmcApp
         {
         case button_power:
             /* Power on request. */
-            m_z21Slave.LanSetTrackPowerOn();
-            WmcCheckForDataTx();
+            WmcTrackPowerOn();
             break;
         default: break;
         }
@@ -648,17 +1032,15 @@ class statePowerOff : public wmcApp
             if (e.Delta != 0)
             {
                 m_locLib.GetNextLoc(e.Delta);
-                m_z21Slave.LanXGetLocoInfo(m_locLib.GetActualLocAddress());
-                WmcCheckForDataTx();
                 m_wmcTft.UpdateSelectedAndNumberOfLocs(
                     m_locLib.GetActualSelectedLocIndex(), m_locLib.GetNumberOfLocs());
                 m_locSelection = true;
+                WmcLocSelectChanged();
             }
             break;
         case pushedShort:
             /* Power on request. */
-            m_z21Slave.LanSetTrackPowerOn();
-            WmcCheckForDataTx();
+            WmcTrackPowerOn();
             break;
         case pushedlong: transit<stateMainMenu1>(); break;
         default: break;
@@ -676,33 +1058,72 @@ class statePowerOn : public wmcApp
      */
     void entry() override
     {
-        m_locSelection              = false;
-        m_WmcLocSpeedRequestPending = false;
+        m_locSelection   = false;
+        m_SpeedTxPending = false;
         m_wmcTft.UpdateStatus("POWER ON", false, WmcTft::color_green);
         m_wmcTft.UpdateSelectedAndNumberOfLocs(m_locLib.GetActualSelectedLocIndex(), m_locLib.GetNumberOfLocs());
     };
 
     /**
-     * Handle received data.
+     * Connection lost, resume with the loc screen as shown.
+     */
+    void react(linkLostEvent const&) override
+    {
+        m_ResumeMode = resumeLoc;
+        transit<stateSessionResume>();
+    };
+
+    /**
+     * Sample the buttons, check for received data, expired timers and queued input and transmit the latest requested
+     * speed.
      */
     void react(updateEvent5msec const&) override
     {
-        switch (WmcCheckForDataRx())
+        WmcButtonSample();
+        WmcCheckForDataRx();
+        WmcTimerCheck();
+        WmcEventQueueCheck();
+        WmcSpeedTransmit();
+    };
+
+    /**
+     * Handle a stable loc selection.
+     */
+    void react(timerEvent const& e) override
+    {
+        switch (e.Id)
+        {
+        case wmcTimer::locSelectStable: WmcLocSelectStable(); break;
+        default: wmcApp::react(e); break;
+        }
+    };
+
+    /**
+     * Handle received data.
+     */
+    void react(z21DataEvent const& e) override
+    {
+        bool SpeedAccept = false;
+
+        switch (e.Type)
         {
         case Z21Slave::emergencyStop: transit<stateEmergencyStop>(); break;
         case Z21Slave::trackPowerOff: transit<statePowerOff>(); break;
         case Z21Slave::programmingMode: transit<statePowerProgrammingMode>(); break;
         case Z21Slave::locinfo:
-            updateLocInfoOnScreen(false);
-            m_WmcLocSpeedRequestPending = false;
-            m_locLib.SpeedUpdate(m_WmcLocInfoReceived->Speed);
-            if (m_WmcLocInfoReceived->Direction == Z21Slave::locDirectionForward)
-            {
-                m_locLib.DirectionSet(directionForward);
-            }
-            else
+            /* Only take over speed and direction when no own drive command is still travelling. */
+            SpeedAccept = WmcSpeedEchoAccept(m_z21Slave.LanXLocoInfo());
+            if ((updateLocInfoOnScreen(false) == true) && (SpeedAccept == true))
             {
-                m_locLib.DirectionSet(directionBackWard);
+                m_locLib.SpeedUpdate(m_WmcLocInfoReceived->Speed);
+                if (m_WmcLocInfoReceived->Direction == Z21Slave::locDirectionForward)
+                {
+                    m_locLib.DirectionSet(directionForward);
+                }
+                else
+                {
+                    m_locLib.DirectionSet(directionBackWard);
+                }
             }
             break;
         case Z21Slave::locLibraryData: break;
@@ -713,13 +1134,9 @@ class statePowerOn : public wmcApp
     void react(updateEvent50msec const&) override {}
 
     /**
-     * Request loc info if for some reason no repsonse was received.
+     * Request loc info if for some reason no broadcast or response was received.
      */
-    void react(updateEvent500msec const&)
-    {
-        m_z21Slave.LanXGetLocoInfo(m_locLib.GetActualLocAddress());
-        WmcCheckForDataTx();
-    };
+    void react(updateEvent500msec const&) override { WmcLocInfoPoll(); };
 
     /**
      * Handle pulse switch events.
@@ -727,6 +1144,7 @@ class statePowerOn : public wmcApp
     void react(pulseSwitchEvent const& e) override
     {
         uint16_t Speed = 0;
+        int16_t Delta  = 0;
 
         switch (e.Status)
         {
@@ -734,38 +1152,67 @@ class statePowerOn : public wmcApp
             /* Select next or previous loc. */
             if (e.Delta != 0)
             {
+                /* Speed not yet transmitted belongs to the loc being left. */
+                if (m_SpeedTxPending == true)
+                {
+                    WmcSpeedRequest();
+                }
+                m_SpeedInFlight = false;
+
                 m_locLib.GetNextLoc(e.Delta);
                 m_wmcTft.UpdateSelectedAndNumberOfLocs(
                     m_locLib.GetActualSelectedLocIndex(), m_locLib.GetNumberOfLocs());
-                m_z21Slave.LanXGetLocoInfo(m_locLib.GetActualLocAddress());
-                WmcCheckForDataTx();
                 m_locSelection = true;
+                WmcLocSelectChanged();
             }
             break;
         case turn:
-            /* Increase or decrease speed. */
-            if (m_WmcLocSpeedRequestPending == false)
+            /* Increase or decrease speed, show it immediately and transmit the latest value at a limited rate. */
+            Delta = m_PulseAccel.Apply(wmcPulseAccel::profileSpeed, e.Delta);
+            if (Delta > SPEED_DELTA_MAX)
+            {
+                Delta = SPEED_DELTA_MAX;
+            }
+            else if (Delta < -SPEED_DELTA_MAX)
+            {
+                Delta = -SPEED_DELTA_MAX;
+            }
+
+            Speed = m_locLib.SpeedSet(static_cast<int8_t>(Delta));
+            if (Speed != 0xFFFF)
             {
-                Speed = m_locLib.SpeedSet(e.Delta);
-                if (Speed != 0xFFFF)
+                m_SpeedStatistics.Deltas++;
+                if (m_SpeedTxPending == true)
+                {
+                    m_SpeedStatistics.Superseded++;
+                }
+                else
                 {
-                    m_WmcLocSpeedRequestPending = true;
-                    PrepareLanXSetLocoDriveAndTransmit(Speed);
+                    m_SpeedTxPending = true;
+                    m_SpeedDeltaTime = micros();
                 }
+
+                updateSpeedOnScreen();
+                WmcSpeedTransmit();
+            }
+            else
+            {
+                m_SpeedStatistics.Dropped++;
             }
             break;
         case pushedShort:
-            /* Stop or change direction when speed is zero. */
+            /* Stop or change direction when speed is zero, a stop is never ramped. */
             Speed = m_locLib.SpeedSet(0);
             if (Speed != 0xFFFF)
             {
+                m_SpeedRamp.Stop(m_locLib.GetActualLocAddress());
                 PrepareLanXSetLocoDriveAndTransmit(Speed);
             }
             break;
         case pushedNormal:
             /* Change direction. */
             m_locLib.DirectionToggle();
-            PrepareLanXSetLocoDriveAndTransmit(m_locLib.SpeedGet());
+            WmcSpeedRequest();
             break;
         case pushedlong:
             m_CvPomProgramming            = true;
@@ -775,6 +1222,12 @@ class statePowerOn : public wmcApp
         }
     };
 
+    /**
+     * Drop a speed not yet transmitted, leaving might be caused by a power off or emergency stop. The received loc
+     * info corrects the local speed afterwards.
+     */
+    void exit() override { m_SpeedTxPending = false; };
+
     /**
      * Handle button events.
      */
@@ -784,21 +1237,14 @@ class statePowerOn : public wmcApp
         switch (e.Button)
         {
         case button_power:
-            if (m_EmergencyStopEnabled == false)
-            {
-                m_z21Slave.LanSetTrackPowerOff();
-            }
-            else
-            {
-                m_z21Slave.LanSetStop();
-            }
-            WmcCheckForDataTx();
+            /* Power off or stop immediately, a speed not yet transmitted is dropped. */
+            m_SpeedTxPending = false;
+            WmcPowerButtonFast(m_EmergencyStopEnabled);
             break;
         case button_0:
             Function = m_locLib.FunctionAssignedGet(static_cast<uint8_t>(e.Button));
             m_locLib.FunctionToggle(Function);
-            m_z21Slave.LanXSetLocoFunction(m_locLib.GetActualLocAddress(), Function, Z21Slave::toggle);
-            WmcCheckForDataTx();
+            WmcLocFunctionTransmit(Function, Z21Slave::toggle);
             break;
         case button_1:
         case button_2:
@@ -808,13 +1254,12 @@ class statePowerOn : public wmcApp
             m_locLib.FunctionToggle(Function);
             if (m_locLib.FunctionStatusGet(Function) == LocLib::functionOn)
             {
-                m_z21Slave.LanXSetLocoFunction(m_locLib.GetActualLocAddress(), Function, Z21Slave::on);
+                WmcLocFunctionTransmit(Function, Z21Slave::on);
             }
             else
             {
-                m_z21Slave.LanXSetLocoFunction(m_locLib.GetActualLocAddress(), Function, Z21Slave::off);
+                WmcLocFunctionTransmit(Function, Z21Slave::off);
             }
-            WmcCheckForDataTx();
             break;
         case button_5:
             m_wmcTft.Clear();
@@ -835,8 +1280,7 @@ class stateEmergencyStop : public wmcApp
      */
     void entry() override
     {
-        m_locSelection              = false;
-        m_WmcLocSpeedRequestPending = false;
+        m_locSelection = false;
         m_wmcTft.UpdateStatus("POWER ON", false, WmcTft::color_yellow);
         m_wmcTft.UpdateSelectedAndNumberOfLocs(m_locLib.GetActualSelectedLocIndex(), m_locLib.GetNumberOfLocs());
 
@@ -845,12 +1289,21 @@ class stateEmergencyStop : public wmcApp
         updateLocInfoOnScreen(false);
     };
 
+    /**
+     * Connection lost, resume with the loc screen as shown.
+     */
+    void react(linkLostEvent const&) override
+    {
+        m_ResumeMode = resumeLoc;
+        transit<stateSessionResume>();
+    };
+
     /**
      * Handle received data.
      */
-    void react(updateEvent50msec const&) override
+    void react(z21DataEvent const& e) override
     {
-        switch (WmcCheckForDataRx())
+        switch (e.Type)
         {
         case Z21Slave::trackPowerOff: transit<statePowerOff>(); break;
         case Z21Slave::trackPowerOn: transit<statePowerOn>(); break;
@@ -858,7 +1311,6 @@ class stateEmergencyStop : public wmcApp
         case Z21Slave::programmingMode: break;
         case Z21Slave::locinfo:
             updateLocInfoOnScreen(false);
-            m_WmcLocSpeedRequestPending = false;
             m_locLib.SpeedUpdate(m_WmcLocInfoReceived->Speed);
             if (m_WmcLocInfoReceived->Direction == Z21Slave::locDirectionForward)
             {
@@ -886,7 +1338,7 @@ class stateEmergencyStop : public wmcApp
         case pushedNormal:
             /* Change direction. */
             m_locLib.DirectionToggle();
-            PrepareLanXSetLocoDriveAndTransmit(m_locLib.SpeedGet());
+            WmcSpeedRequest();
             break;
         case pushedShort:
         case pushedlong: transit<stateMainMenu1>(); break;
@@ -902,8 +1354,7 @@ class stateEmergencyStop : public wmcApp
         switch (e.Button)
         {
         case button_power:
-            m_z21Slave.LanSetTrackPowerOn();
-            WmcCheckForDataTx();
+            WmcTrackPowerOn();
             break;
         case button_0:
         case button_1:
@@ -914,13 +1365,12 @@ class stateEmergencyStop : public wmcApp
             m_locLib.FunctionToggle(Function);
             if (m_locLib.FunctionStatusGet(Function) == LocLib::functionOn)
             {
-                m_z21Slave.LanXSetLocoFunction(m_locLib.GetActualLocAddress(), Function, Z21Slave::on);
+                WmcLocFunctionTransmit(Function, Z21Slave::on);
             }
             else
             {
-                m_z21Slave.LanXSetLocoFunction(m_locLib.GetActualLocAddress(), Function, Z21Slave::off);
+                WmcLocFunctionTransmit(Function, Z21Slave::off);
             }
-            WmcCheckForDataTx();
             break;
         case button_5:
         case button_none: break;
@@ -943,12 +1393,21 @@ class statePowerProgrammingMode : public wmcApp
         m_wmcTft.UpdateSelectedAndNumberOfLocs(m_locLib.GetActualSelectedLocIndex(), m_locLib.GetNumberOfLocs());
     };
 
+    /**
+     * Connection lost, resume with the loc screen as shown.
+     */
+    void react(linkLostEvent const&) override
+    {
+        m_ResumeMode = resumeLoc;
+        transit<stateSessionResume>();
+    };
+
     /**
      * Handle received data.
      */
-    void react(updateEvent50msec const&) override
+    void react(z21DataEvent const& e) override
     {
-        switch (WmcCheckForDataRx())
+        switch (e.Type)
         {
         case Z21Slave::trackPowerOff: transit<statePowerOff>(); break;
         case Z21Slave::trackPowerOn: transit<statePowerOn>(); break;
@@ -964,8 +1423,7 @@ class statePowerProgrammingMode : public wmcApp
         switch (e.Button)
         {
         case button_power:
-            m_z21Slave.LanSetTrackPowerOff();
-            WmcCheckForDataTx();
+            WmcTrackPowerOff(false);
             break;
         case button_0:
         case button_1:
@@ -996,27 +1454,37 @@ class stateTurnoutControl : public wmcApp
         m_wmcTft.ShowTurnoutDirection(static_cast<uint8_t>(m_TurnOutDirection));
     };
 
+    /**
+     * Connection lost, resume with the turnout screen as shown.
+     */
+    void react(linkLostEvent const&) override
+    {
+        m_ResumeMode = resumeTurnout;
+        transit<stateSessionResume>();
+    };
+
     /**
      * Handle received data.
      */
-    void react(updateEvent50msec const&) override
+    void react(z21DataEvent const& e) override
     {
-        switch (WmcCheckForDataRx())
+        switch (e.Type)
         {
         case Z21Slave::trackPowerOff: transit<stateTurnoutControlPowerOff>(); break;
         default: break;
         }
+    };
 
-        /* When turnout active sent after 500msec off command. */
-        if (m_TurnOutDirection != Z21Slave::directionOff)
+    /**
+     * Switch off the turnout output and show it.
+     */
+    void react(timerEvent const& e) override
+    {
+        wmcApp::react(e);
+
+        if (e.Id == wmcTimer::turnoutOff)
         {
-            if ((millis() - m_TurnoutOffDelay) > 500)
-            {
-                m_TurnOutDirection = Z21Slave::directionOff;
-                m_z21Slave.LanXSetTurnout(m_TurnOutAddress - 1, m_TurnOutDirection);
-                WmcCheckForDataTx();
-                m_wmcTft.ShowTurnoutDirection(static_cast<uint8_t>(m_TurnOutDirection));
-            }
+            m_wmcTft.ShowTurnoutDirection(static_cast<uint8_t>(m_TurnOutDirection));
         }
     };
 
@@ -1030,31 +1498,12 @@ class stateTurnoutControl : public wmcApp
         {
         case pushturn: break;
         case turn:
-            if (e.Delta > 0)
-            {
-                /* Increase address and check for overrrun. */
-                if (m_TurnOutAddress < ADDRESS_TURNOUT_MAX)
-                {
-                    m_TurnOutAddress++;
-                }
-                else
-                {
-                    m_TurnOutAddress = ADDRESS_TURNOUT_MIN;
-                }
-
-                updateScreen = true;
-            }
-            else if (e.Delta < 0)
+            /* Change address, faster turning gives larger steps, wrap around when at the limit. */
+            if (e.Delta != 0)
             {
-                /* Decrease address and handle address 0. */
-                if (m_TurnOutAddress > ADDRESS_TURNOUT_MIN)
-                {
-                    m_TurnOutAddress--;
-                }
-                else
-                {
-                    m_TurnOutAddress = ADDRESS_TURNOUT_MAX;
-                }
+                m_TurnOutAddress = wmcPulseAccel::Step(m_TurnOutAddress,
+                    m_PulseAccel.Apply(wmcPulseAccel::profileTurnoutAddress, e.Delta), ADDRESS_TURNOUT_MIN,
+                    ADDRESS_TURNOUT_MAX);
                 updateScreen = true;
             }
             break;
@@ -1089,23 +1538,18 @@ class stateTurnoutControl : public wmcApp
         /* Handle button requests. */
         switch (e.Button)
         {
-        case button_power:
-            m_z21Slave.LanSetTrackPowerOff();
-            WmcCheckForDataTx();
-            break;
+        case button_power: WmcPowerButtonFast(false); break;
         case button_0: m_TurnOutAddress++; break;
         case button_1: m_TurnOutAddress += 10; break;
         case button_2: m_TurnOutAddress += 100; break;
         case button_3: m_TurnOutAddress += 1000; break;
         case button_4:
             m_TurnOutDirection = Z21Slave::directionForward;
-            m_TurnoutOffDelay  = millis();
             updateScreen       = false;
             sentTurnOutCommand = true;
             break;
         case button_5:
             m_TurnOutDirection = Z21Slave::directionTurn;
-            m_TurnoutOffDelay  = millis();
             updateScreen       = false;
             sentTurnOutCommand = true;
             break;
@@ -1123,10 +1567,11 @@ class stateTurnoutControl : public wmcApp
 
         if (sentTurnOutCommand == true)
         {
-            /* Sent command and show turnout direction. */
+            /* Sent command and show turnout direction, switch off the output after a delay. */
             m_z21Slave.LanXSetTurnout(m_TurnOutAddress - 1, m_TurnOutDirection);
             WmcCheckForDataTx();
             m_wmcTft.ShowTurnoutDirection(static_cast<uint8_t>(m_TurnOutDirection));
+            m_Timer.Start(wmcTimer::turnoutOff, TURNOUT_OFF_DELAY);
         }
     };
 
@@ -1135,6 +1580,8 @@ class stateTurnoutControl : public wmcApp
      */
     void exit() override
     {
+        m_Timer.Stop(wmcTimer::turnoutOff);
+
         if (m_TurnOutDirection != Z21Slave::directionOff)
         {
             m_TurnOutDirection = Z21Slave::directionOff;
@@ -1159,12 +1606,21 @@ class stateTurnoutControlPowerOff : public wmcApp
         m_TrackPower = powerState::off;
     };
 
+    /**
+     * Connection lost, resume with the turnout screen as shown.
+     */
+    void react(linkLostEvent const&) override
+    {
+        m_ResumeMode = resumeTurnout;
+        transit<stateSessionResume>();
+    };
+
     /**
      * Handle received data.
      */
-    void react(updateEvent50msec const&) override
+    void react(z21DataEvent const& e) override
     {
-        switch (WmcCheckForDataRx())
+        switch (e.Type)
         {
         case Z21Slave::trackPowerOff: break;
         case Z21Slave::trackPowerOn:
@@ -1202,8 +1658,7 @@ class stateTurnoutControlPowerOff : public wmcApp
         switch (e.Button)
         {
         case button_power:
-            m_z21Slave.LanSetTrackPowerOn();
-            WmcCheckForDataTx();
+            WmcTrackPowerOn();
             break;
         case button_0:
         case button_1:
@@ -1266,11 +1721,14 @@ class stateMainMenu1 : public wmcApp
             m_CvPomProgramming = true;
             transit<stateCvProgramming>();
             break;
+        case button_0:
+            /* Not shown by the menu screen of the display library, documented in the README. */
+            transit<stateMenuSpeedRamp>();
+            break;
         case button_power:
             m_locSelection = true;
             transit<stateInitStatusGet>();
             break;
-        case button_0:
         case button_none: break;
         }
     };
@@ -1313,6 +1771,9 @@ class stateMainMenu2 : public wmcApp
         switch (e.Button)
         {
         case button_0:
+            /* Not shown by the menu screen of the display library, documented in the README. */
+            transit<stateMenuConsist>();
+            break;
         case button_1: break;
         case button_2:
             /* Toggle emergency stop or power off for power button. */
@@ -1352,6 +1813,7 @@ class stateMainMenu2 : public wmcApp
             m_LocStorage.NumberOfLocsSet(1);
             m_LocStorage.EmergencyOptionSet(0);
             m_WmcCommandLine.IpSettingsDefault();
+            WmcConfigSync();
             m_wmcTft.Clear();
             m_wmcTft.CommandLine();
             while (1)
@@ -1393,16 +1855,11 @@ class stateMenuLocAdd : public wmcApp
         switch (e.Status)
         {
         case turn:
-            /* Increase or decrease loc address to be added. */
-            if (e.Delta > 0)
-            {
-                m_locAddressAdd++;
-                m_locAddressAdd = m_locLib.limitLocAddress(m_locAddressAdd);
-                m_wmcTft.ShowlocAddress(m_locAddressAdd, WmcTft::color_green);
-            }
-            else if (e.Delta < 0)
+            /* Increase or decrease loc address to be added, faster turning gives larger steps. */
+            if (e.Delta != 0)
             {
-                m_locAddressAdd--;
+                m_locAddressAdd = wmcPulseAccel::Step(m_locAddressAdd,
+                    m_PulseAccel.Apply(wmcPulseAccel::profileLocAddress, e.Delta), ADDRESS_LOC_MIN, ADDRESS_LOC_MAX);
                 m_locAddressAdd = m_locLib.limitLocAddress(m_locAddressAdd);
                 m_wmcTft.ShowlocAddress(m_locAddressAdd, WmcTft::color_green);
             }
@@ -1411,7 +1868,7 @@ class stateMenuLocAdd : public wmcApp
         case pushedNormal:
         case pushedlong:
             /* If loc is not present goto add functions else red address indicating loc already present. */
-            if (m_locLib.CheckLoc(m_locAddressAdd) != 255)
+            if (WmcLocPresent(m_locAddressAdd) == true)
             {
                 m_wmcTft.ShowlocAddress(m_locAddressAdd, WmcTft::color_red);
             }
@@ -1440,7 +1897,7 @@ class stateMenuLocAdd : public wmcApp
         case button_4: m_locAddressAdd = 1; break;
         case button_5:
             /* If loc is not present goto add functions else red address indicating loc already present. */
-            if (m_locLib.CheckLoc(m_locAddressAdd) != 255)
+            if (WmcLocPresent(m_locAddressAdd) == true)
             {
                 updateScreen = false;
                 m_wmcTft.ShowlocAddress(m_locAddressAdd, WmcTft::color_red);
@@ -1521,8 +1978,7 @@ class stateMenuLocFunctionsAdd : public wmcApp
             break;
         case pushedNormal:
             /* Store loc functions */
-            m_locLib.StoreLoc(m_locAddressAdd, m_locFunctionAssignment, NULL, LocLib::storeAdd);
-            m_locLib.LocBubbleSort();
+            WmcLocAdd(m_locAddressAdd, m_locFunctionAssignment, NULL, LocLib::storeAdd, true);
             m_locAddressAdd++;
             transit<stateMenuLocAdd>();
             break;
@@ -1558,8 +2014,7 @@ class stateMenuLocFunctionsAdd : public wmcApp
         case button_power: transit<stateMainMenu1>(); break;
         case button_5:
             /* Store loc functions */
-            m_locLib.StoreLoc(m_locAddressAdd, m_locFunctionAssignment, NULL, LocLib::storeAdd);
-            m_locLib.LocBubbleSort();
+            WmcLocAdd(m_locAddressAdd, m_locFunctionAssignment, NULL, LocLib::storeAdd, true);
             m_locAddressAdd++;
             transit<stateMenuLocAdd>();
             break;
@@ -1723,6 +2178,8 @@ class stateMenuLocDelete : public wmcApp
         case pushedlong:
             /* Remove loc. */
             m_locLib.RemoveLoc(m_locAddressDelete);
+            m_locIndex.Remove(m_locAddressDelete);
+            m_locIndex.LibrarySortedSet(false);
             m_wmcTft.UpdateSelectedAndNumberOfLocs(m_locLib.GetActualSelectedLocIndex(), m_locLib.GetNumberOfLocs());
             m_locAddressDelete = m_locLib.GetActualLocAddress();
             m_wmcTft.ShowlocAddress(m_locAddressDelete, WmcTft::color_green);
@@ -1751,19 +2208,22 @@ class stateMenuLocDelete : public wmcApp
 };
 
 /***********************************************************************************************************************
- * Transmit loc data on XpressNet
+ * Change the acceleration and braking rate of the selected loc.
  */
-class stateMenuTransmitLocDatabase : public wmcApp
+class stateMenuSpeedRamp : public wmcApp
 {
+    /**
+     * Show the speed ramp screen with the acceleration rate of the selected loc.
+     */
     void entry() override
     {
-        m_locDbDataTransmitCnt       = 0;
-        m_locDbDataTransmitCntRepeat = 0;
-        m_wmcTft.UpdateStatus("SEND LOC DATA", true, WmcTft::color_white);
+        m_SpeedRamp.ConfigGet(m_locLib.GetActualLocAddress(), m_SpeedRampEdit);
+        m_SpeedRampEditBrake = false;
 
-        /* Update status row. */
-        m_wmcTft.UpdateTransmitCount(
-            static_cast<uint8_t>(m_locDbDataTransmitCnt + 1), static_cast<uint8_t>(m_locLib.GetNumberOfLocs()));
+        m_wmcTft.Clear();
+        m_wmcTft.ShowLocSymbolFw(WmcTft::color_white);
+        m_wmcTft.ShowlocAddress(m_locLib.GetActualLocAddress(), WmcTft::color_green);
+        WmcSpeedRampShow();
     }
 
     /**
@@ -1771,53 +2231,45 @@ class stateMenuTransmitLocDatabase : public wmcApp
      */
     void react(pulseSwitchEvent const& e) override
     {
+        uint16_t* RatePtr = (m_SpeedRampEditBrake == true) ? &m_SpeedRampEdit.Brake : &m_SpeedRampEdit.Accelerate;
+
         switch (e.Status)
         {
         case turn:
+            /* Change the rate in whole speed steps per second, 0 is no ramp. */
+            if (e.Delta != 0)
+            {
+                *RatePtr = wmcPulseAccel::Step(*RatePtr / wmcSpeedRamp::SPEED_RAMP_ONE,
+                               m_PulseAccel.Apply(wmcPulseAccel::profileSpeed, e.Delta), 0, SPEED_RAMP_RATE_MAX)
+                    * wmcSpeedRamp::SPEED_RAMP_ONE;
+                WmcSpeedRampShow();
+            }
+            break;
+        case pushedShort:
+            /* Toggle between acceleration and braking rate. */
+            m_SpeedRampEditBrake = !m_SpeedRampEditBrake;
+            WmcSpeedRampShow();
+            break;
         case pushedNormal:
         case pushedlong:
-            transit<stateMainMenu2>();
-            break;
+            /* Store the rates, red when all entries are in use by other locs. */
+            if (SpeedRampConfigSet(m_locLib.GetActualLocAddress(), m_SpeedRampEdit.Accelerate, m_SpeedRampEdit.Brake)
+                == true)
+            {
+                transit<stateMainMenu1>();
+            }
+            else
+            {
+                m_wmcTft.UpdateStatus("SPEED RAMP FULL", true, WmcTft::color_red);
+            }
             break;
         default: break;
         }
     }
 
     /**
-     * Transmit loc data.
-     */
-    void react(updateEvent100msec const&)
-    {
-        LocLibData* LocDbData;
-
-        /* The loc database needs to be transmitted twice.. */
-        if (m_locDbDataTransmitCntRepeat > 2)
-        {
-            m_locDbDataTransmitCntRepeat = 1;
-            m_locDbDataTransmitCnt++;
-
-            /* Update status row. */
-            m_wmcTft.UpdateTransmitCount(
-                static_cast<uint8_t>(m_locDbDataTransmitCnt + 1), static_cast<uint8_t>(m_locLib.GetNumberOfLocs()));
-        }
-        m_locDbDataTransmitCntRepeat++;
-
-        // If last loc transmitted back to menu else transmit loc data,
-        if (m_locDbDataTransmitCnt >= m_locLib.GetNumberOfLocs())
-        {
-            transit<stateMainMenu2>();
-        }
-        else
-        {
-            LocDbData = m_locLib.LocGetAllDataByIndex(m_locDbDataTransmitCnt);
-            m_z21Slave.LanXLocLibDataTransmit(LocDbData->Addres, m_locDbDataTransmitCnt,
-                static_cast<uint8_t>(m_locLib.GetNumberOfLocs()), LocDbData->Name);
-            WmcCheckForDataTx();
-        }
-    }
-
-    /**
-     * Handle button events, just go back to main menu on each button.
+     * Handle button events, button 0 selects the acceleration and button 1 the braking rate. Other buttons go back to
+     * the main menu without storing.
      */
     void react(pushButtonsEvent const& e) override
     {
@@ -1825,89 +2277,353 @@ class stateMenuTransmitLocDatabase : public wmcApp
         {
         case button_0:
         case button_1:
+            m_SpeedRampEditBrake = (e.Button == button_1);
+            WmcSpeedRampShow();
+            break;
         case button_2:
         case button_3:
         case button_4:
         case button_5:
-        case button_power: transit<stateMainMenu2>(); break;
+        case button_power: transit<stateMainMenu1>(); break;
         case button_none: break;
         }
     };
 };
 
 /***********************************************************************************************************************
- * Command lie interface active state.
+ * Consist of the selected loc as lead: the knob selects a member address, a short push toggles its running direction.
+ * Button 0 adds or updates the member, button 1 removes it and button 2 toggles applying the functions to all members.
  */
-class stateCommandLineInterfaceActive : public wmcApp
+class stateMenuConsist : public wmcApp
 {
     /**
-     * Show delete screen.
+     * Show the consist screen with the first member of the selected loc.
      */
     void entry() override
     {
-        m_WifiUdp.stop();
-        m_wmcTft.Clear();
-        m_wmcTft.UpdateStatus("COMMAND LINE", true, WmcTft::color_green);
-        m_wmcTft.CommandLine();
-    };
-};
+        wmcConsist::member Member;
 
-/***********************************************************************************************************************
- * CV programming main state.
- */
-class stateCvProgramming : public wmcApp
-{
-    /**
-     * Show delete screen.
-     */
-    void entry() override
-    {
-        cvEvent EventCv;
-        m_wmcTft.Clear();
-        if (m_CvPomProgramming == false)
+        if (m_Consist.MemberGet(m_locLib.GetActualLocAddress(), 0, Member) == true)
         {
-            EventCv.EventData = startCv;
-            m_wmcTft.UpdateStatus("CV PROGRAMMING", true, WmcTft::color_green);
+            m_ConsistMemberAddress = Member.Address;
+            m_ConsistMemberFlip    = Member.Flip;
         }
         else
         {
-            EventCv.EventData = startPom;
-            m_wmcTft.UpdateStatus("POM PROGRAMMING", true, WmcTft::color_green);
-            m_z21Slave.LanSetTrackPowerOn();
-            WmcCheckForDataTx();
+            m_ConsistMemberAddress = m_locLib.GetActualLocAddress();
+            m_ConsistMemberFlip    = false;
         }
 
-        send_event(EventCv);
-    };
+        m_wmcTft.Clear();
+        m_wmcTft.ShowLocSymbolFw(WmcTft::color_white);
+        m_wmcTft.ShowlocAddress(m_locLib.GetActualLocAddress(), WmcTft::color_green);
+        WmcConsistShow();
+    }
 
     /**
-     * Handle received Z21 data.
+     * Handle pulse switch events.
      */
-    void react(updateEvent50msec const&) override
+    void react(pulseSwitchEvent const& e) override
     {
-        cvEvent EventCv;
-        cvpushButtonEvent ButtonEvent;
-        Z21Slave::cvData* cvDataPtr = NULL;
+        wmcConsist::member Member;
 
-        switch (WmcCheckForDataRx())
+        switch (e.Status)
         {
-        case Z21Slave::trackPowerOff:
-            m_TrackPower = powerState::off;
-            /* Use power off button event to stop CV programming. */
-            ButtonEvent.EventData.Button = button_power;
-            send_event(ButtonEvent);
-            transit<stateInitLocInfoGet>();
-            break;
-        case Z21Slave::trackPowerOn:
-            if ((m_CvPomProgramming == false) || (m_CvPomProgrammingFromPowerOn == true))
+        case turn:
+            /* Select the member address, a present member shows its own running direction. */
+            if (e.Delta != 0)
             {
-                ButtonEvent.EventData.Button = button_power;
-                send_event(ButtonEvent);
-                transit<stateInitLocInfoGet>();
+                m_ConsistMemberAddress = wmcPulseAccel::Step(m_ConsistMemberAddress,
+                    m_PulseAccel.Apply(wmcPulseAccel::profileLocAddress, e.Delta), ADDRESS_LOC_MIN, ADDRESS_LOC_MAX);
+                m_ConsistMemberFlip = false;
+                if (WmcConsistMemberFind(m_ConsistMemberAddress, Member) == true)
+                {
+                    m_ConsistMemberFlip = Member.Flip;
+                }
+                WmcConsistShow();
             }
             break;
-        case Z21Slave::programmingCvNackSc:
-            EventCv.EventData = cvNack;
+        case pushedShort:
+            m_ConsistMemberFlip = !m_ConsistMemberFlip;
+            WmcConsistShow();
+            break;
+        case pushedNormal:
+        case pushedlong: transit<stateMainMenu2>(); break;
+        default: break;
+        }
+    }
+
+    /**
+     * Handle button events, other buttons go back to the main menu.
+     */
+    void react(pushButtonsEvent const& e) override
+    {
+        uint16_t Lead = m_locLib.GetActualLocAddress();
+
+        switch (e.Button)
+        {
+        case button_0:
+            /* Red when the consist is full or the loc can not be a member. */
+            if (ConsistMemberAdd(Lead, m_ConsistMemberAddress, m_ConsistMemberFlip) == true)
+            {
+                WmcConsistShow();
+            }
+            else
+            {
+                m_wmcTft.UpdateStatus("MEMBER NOT ADDED", true, WmcTft::color_red);
+            }
+            break;
+        case button_1:
+            ConsistMemberRemove(Lead, m_ConsistMemberAddress);
+            WmcConsistShow();
+            break;
+        case button_2:
+            ConsistFunctionsAllSet(Lead, !m_Consist.FunctionsAll(Lead));
+            WmcConsistShow();
+            break;
+        case button_3:
+        case button_4:
+        case button_5:
+        case button_power: transit<stateMainMenu2>(); break;
+        case button_none: break;
+        }
+    };
+};
+
+/***********************************************************************************************************************
+ * Transmit loc data on XpressNet
+ */
+class stateMenuTransmitLocDatabase : public wmcApp
+{
+    void entry() override
+    {
+        m_locDbDataTransmitCnt       = 0;
+        m_locDbDataTransmitCntRepeat = 0;
+        m_locDbDataProgressTime      = millis();
+        m_Timer.Start(wmcTimer::locDbTransmit, 0);
+        memset(m_locDbDataEchoed, 0, sizeof(m_locDbDataEchoed));
+        m_wmcTft.UpdateStatus("SEND LOC DATA", true, WmcTft::color_white);
+
+        /* Update status row. */
+        m_wmcTft.UpdateTransmitCount(
+            static_cast<uint8_t>(m_locDbDataTransmitCnt + 1), static_cast<uint8_t>(m_locLib.GetNumberOfLocs()));
+    }
+
+    /**
+     * Handle pulse switch events.
+     */
+    void react(pulseSwitchEvent const& e) override
+    {
+        switch (e.Status)
+        {
+        case turn:
+        case pushedNormal:
+        case pushedlong:
+            transit<stateMainMenu2>();
+            break;
+            break;
+        default: break;
+        }
+    }
+
+    /**
+     * Loc data received back from the control, no need to repeat it. The transfer is done when all locs are received
+     * back.
+     */
+    void react(z21DataEvent const& e) override
+    {
+        uint8_t Index;
+
+        if (e.Type == Z21Slave::locLibraryData)
+        {
+            m_WmcLocLibInfo = m_z21Slave.LanXLocLibData();
+            Index           = m_WmcLocLibInfo->Actual;
+
+            if ((Index < m_locLib.GetNumberOfLocs())
+                && (m_locLib.LocGetAllDataByIndex(Index)->Addres == m_WmcLocLibInfo->Address))
+            {
+                m_locDbDataEchoed[Index / 8] |= (1 << (Index % 8));
+                if (WmcLocDbEchoedAll() == true)
+                {
+                    transit<stateMainMenu2>();
+                }
+            }
+        }
+    }
+
+    /**
+     * Stop transmitting.
+     */
+    void exit() override { m_Timer.Stop(wmcTimer::locDbTransmit); };
+
+    /**
+     * Transmit loc data, a window of locs each pacing interval. When all locs are transmitted the locs not received
+     * back are repeated after a short delay.
+     */
+    void react(timerEvent const& e) override
+    {
+        uint8_t Transmitted  = 0;
+        uint8_t NumberOfLocs = m_locLib.GetNumberOfLocs();
+        LocLibData* LocDbData;
+
+        if (e.Id != wmcTimer::locDbTransmit)
+        {
+            wmcApp::react(e);
+        }
+        else
+        {
+            while ((Transmitted < LOC_DB_TX_WINDOW) && (m_locDbDataTransmitCnt < NumberOfLocs))
+            {
+                if ((m_locDbDataEchoed[m_locDbDataTransmitCnt / 8] & (1 << (m_locDbDataTransmitCnt % 8))) == 0)
+                {
+                    LocDbData = m_locLib.LocGetAllDataByIndex(m_locDbDataTransmitCnt);
+                    m_z21Slave.LanXLocLibDataTransmit(
+                        LocDbData->Addres, m_locDbDataTransmitCnt, NumberOfLocs, LocDbData->Name);
+                    WmcCheckForDataTx();
+                    Transmitted++;
+                }
+                m_locDbDataTransmitCnt++;
+            }
+
+            // If all locs transmitted repeat the locs not received back or back to menu.
+            if (m_locDbDataTransmitCnt >= NumberOfLocs)
+            {
+                if ((m_locDbDataTransmitCntRepeat < LOC_DB_TX_REPEAT_MAX) && (WmcLocDbEchoedAll() == false))
+                {
+                    /* Start of a repeat, give the control some time to echo. */
+                    m_locDbDataTransmitCnt = 0;
+                    m_locDbDataTransmitCntRepeat++;
+                    m_Timer.Start(wmcTimer::locDbTransmit, LOC_DB_TX_REPEAT_DELAY);
+                }
+                else
+                {
+                    transit<stateMainMenu2>();
+                }
+            }
+            else
+            {
+                m_Timer.Start(wmcTimer::locDbTransmit, LOC_DB_TX_INTERVAL);
+                if ((millis() - m_locDbDataProgressTime) >= LOC_DB_TX_PROGRESS_INTERVAL)
+                {
+                    /* Update status row. */
+                    m_locDbDataProgressTime = millis();
+                    m_wmcTft.UpdateTransmitCount(
+                        static_cast<uint8_t>(m_locDbDataTransmitCnt + 1), static_cast<uint8_t>(NumberOfLocs));
+                }
+            }
+        }
+    }
+
+    /**
+     * Handle button events, just go back to main menu on each button.
+     */
+    void react(pushButtonsEvent const& e) override
+    {
+        switch (e.Button)
+        {
+        case button_0:
+        case button_1:
+        case button_2:
+        case button_3:
+        case button_4:
+        case button_5:
+        case button_power: transit<stateMainMenu2>(); break;
+        case button_none: break;
+        }
+    };
+};
+
+/***********************************************************************************************************************
+ * Command lie interface active state.
+ */
+class stateCommandLineInterfaceActive : public wmcApp
+{
+    /**
+     * Show delete screen.
+     */
+    void entry() override
+    {
+        m_wmcEep.Commit();
+        m_LinkMonitorActive = false;
+        m_WifiUdp.stop();
+        m_wmcTft.Clear();
+        m_wmcTft.UpdateStatus("COMMAND LINE", true, WmcTft::color_green);
+        m_wmcTft.CommandLine();
+
+        /* WmcCli has no boot log command, show the boot timeline when the command line is entered. */
+        m_BootLog.Print();
+    };
+
+    /**
+     * No buttons in this state, the ADC is not sampled to leave the wifi undisturbed.
+     */
+    void react(updateEvent5msec const&) override
+    {
+        WmcTimerCheck();
+        WmcEventQueueCheck();
+    };
+};
+
+/***********************************************************************************************************************
+ * CV programming main state.
+ */
+class stateCvProgramming : public wmcApp
+{
+    /**
+     * Show delete screen.
+     */
+    void entry() override
+    {
+        cvEvent EventCv;
+        m_wmcTft.Clear();
+        if (m_CvPomProgramming == false)
+        {
+            EventCv.EventData = startCv;
+            m_wmcTft.UpdateStatus("CV PROGRAMMING", true, WmcTft::color_green);
+        }
+        else
+        {
+            EventCv.EventData = startPom;
+            m_wmcTft.UpdateStatus("POM PROGRAMMING", true, WmcTft::color_green);
+            WmcTrackPowerOn();
+        }
+
+        send_event(EventCv);
+    };
+
+    /**
+     * Connection lost, the CV module reports the missing response.
+     */
+    void react(linkLostEvent const&) override{};
+
+    /**
+     * Handle received Z21 data.
+     */
+    void react(z21DataEvent const& e) override
+    {
+        cvEvent EventCv;
+        cvpushButtonEvent ButtonEvent;
+        Z21Slave::cvData* cvDataPtr = NULL;
+
+        switch (e.Type)
+        {
+        case Z21Slave::trackPowerOff:
+            m_TrackPower = powerState::off;
+            /* Use power off button event to stop CV programming. */
+            ButtonEvent.EventData.Button = button_power;
+            send_event(ButtonEvent);
+            transit<stateInitLocInfoGet>();
+            break;
+        case Z21Slave::trackPowerOn:
+            if ((m_CvPomProgramming == false) || (m_CvPomProgrammingFromPowerOn == true))
+            {
+                ButtonEvent.EventData.Button = button_power;
+                send_event(ButtonEvent);
+                transit<stateInitLocInfoGet>();
+            }
+            break;
+        case Z21Slave::programmingCvNackSc:
+            EventCv.EventData = cvNack;
             send_event(EventCv);
             break;
         case Z21Slave::programmingCvResult:
@@ -1923,13 +2639,9 @@ class stateCvProgramming : public wmcApp
     };
 
     /**
-     * Keep alive by requesting loc status. Requesting power system status forces the CV mode back to normal mode...
+     * Keep alive is done by the loc info poll. Requesting power system status forces the CV mode back to normal mode...
      */
-    void react(updateEvent3sec const&) override
-    {
-        m_z21Slave.LanXGetLocoInfo(m_locLib.GetActualLocAddress());
-        WmcCheckForDataTx();
-    }
+    void react(updateEvent3sec const&) override{};
 
     /**
      * Handle pulse switch events.
@@ -1958,6 +2670,8 @@ class stateCvProgramming : public wmcApp
         cvEvent EventCv;
         EventCv.EventData = update;
         send_event(EventCv);
+
+        WmcLocInfoPoll();
     }
 
     /**
@@ -2041,63 +2755,60 @@ class stateCvProgramming : public wmcApp
  */
 void wmcApp::react(pulseSwitchEvent const&){};
 void wmcApp::react(pushButtonsEvent const&){};
-void wmcApp::react(updateEvent5msec const&){};
+void wmcApp::react(updateEvent5msec const&)
+{
+    WmcButtonSample();
+    WmcTimerCheck();
+    WmcEventQueueCheck();
+};
 void wmcApp::react(updateEvent50msec const&) { WmcCheckForDataRx(); };
 void wmcApp::react(updateEvent100msec const&)
 {
-    bool Found    = false;
-    uint8_t Index = 0;
-    uint16_t readingIn;
-
     m_WmcCommandLine.Update();
+    WmcConfigSync();
+    m_wmcEep.Update();
+};
 
-    readingIn = analogRead(WMC_APP_ANALOG_IN);
-
-    /* Button pressed ? */
-    if (readingIn < m_AdcButtonValue[ADC_VALUES_ARRAY_REFERENCE_INDEX])
+void wmcApp::react(updateEvent500msec const&){};
+void wmcApp::react(z21DataEvent const&){};
+void wmcApp::react(powerButtonEvent const& e)
+{
+    /* A queued press is handled like the power button of the sketch, keep the press time for the latency. */
+    pushButtonsEvent ButtonEvent;
+
+    ButtonEvent.Button     = button_power;
+    m_PowerButtonPressTime = e.PressTime;
+    m_PowerButtonQueued    = true;
+    dispatch(ButtonEvent);
+    m_PowerButtonQueued = false;
+};
+void wmcApp::react(timerEvent const& e)
+{
+    switch (e.Id)
     {
-        /* Check which button is pressed. */
-        while ((Index < 6) && (Found == false))
+    case wmcTimer::turnoutOff:
+        if (m_TurnOutDirection != Z21Slave::directionOff)
         {
-            /* One button results in ADC values ~10, check. */
-            if (m_AdcButtonValue[Index] < 20)
-            {
-                if (readingIn <= m_AdcButtonValue[Index])
-                {
-                    /* Button value within defined borders... */
-                    Found                 = true;
-                    m_ButtonIndexPrevious = Index;
-                }
-                else
-                {
-                    Index++;
-                }
-            }
-            else if ((readingIn > (m_AdcButtonValue[Index] - 20)) && (readingIn < (m_AdcButtonValue[Index] + 20)))
-            {
-                /* Button value within defined borders... */
-                Found                 = true;
-                m_ButtonIndexPrevious = Index;
-            }
-            else
-            {
-                /* Increase index for next check... */
-                Index++;
-            }
+            m_TurnOutDirection = Z21Slave::directionOff;
+            m_z21Slave.LanXSetTurnout(m_TurnOutAddress - 1, m_TurnOutDirection);
+            WmcCheckForDataTx();
         }
+        break;
+    case wmcTimer::locSelectStable:
+        /* Loc control left before the selection was stable, loc info is requested on return. */
+        m_LocSelectPending = false;
+        break;
+    case wmcTimer::locImportCommit: WmcLocImportCommit(); break;
+    case wmcTimer::speedRamp: WmcSpeedRampUpdate(); break;
+    default: break;
     }
-
-    if ((Found == false) && (m_ButtonPrevious == true))
-    {
-        // Valid button detected, throw event once after release of button..
-        m_wmcPushButtonEvent.Button = static_cast<pushButtons>(m_ButtonIndexPrevious);
-        send_event(m_wmcPushButtonEvent);
-    }
-
-    m_ButtonPrevious = Found;
 };
-
-void wmcApp::react(updateEvent500msec const&){};
+void wmcApp::react(linkLostEvent const&)
+{
+    /* Menus and other screens are replaced by the loc screen. */
+    m_ResumeMode = resumeLocRedraw;
+    transit<stateSessionResume>();
+};
 void wmcApp::react(updateEvent3sec const&)
 {
     m_z21Slave.LanGetStatus();
@@ -2112,24 +2823,51 @@ void wmcApp::react(cvProgEvent const&){};
 FSM_INITIAL_STATE(wmcApp, stateInit)
 
 /***********************************************************************************************************************
- * Check for received Z21 data and process it.
+ * Check for received Z21 data and process it. All pending datagrams are read within the per tick packet and time
+ * budget and each decoded Z21 message is dispatched to the active state.
  */
-Z21Slave::dataType wmcApp::WmcCheckForDataRx(void)
+void wmcApp::WmcCheckForDataRx(void)
 {
+    int WmcPacketSize             = 0;
     int WmcPacketBufferLength     = 0;
-    Z21Slave::dataType returnData = Z21Slave::none;
+    uint8_t Packets               = 0;
+    uint32_t StartTime            = micros();
+    bool BudgetAvailable          = true;
 #if WMC_APP_DEBUG_TX_RX == 1
-    uint8_t Index;
+    uint16_t Index;
 #endif
 
-    if (m_WifiUdp.parsePacket())
+    while (BudgetAvailable == true)
     {
-        // We've received a packet, read the data from it into the buffer
-        WmcPacketBufferLength = m_WifiUdp.read(m_WmcPacketBuffer, 40);
-
-        if (WmcPacketBufferLength != 0)
+        /* A datagram found when the budget of the previous tick ran out is the current one already. */
+        if (m_RxPacketPending > 0)
         {
-#if WMC_APP_DEBUG_TX_RX == 1
+            WmcPacketSize     = m_RxPacketPending;
+            m_RxPacketPending = 0;
+        }
+        else
+        {
+            WmcPacketSize = m_WifiUdp.parsePacket();
+        }
+
+        if (WmcPacketSize == 0)
+        {
+            break;
+        }
+
+        Packets++;
+
+        // We've received a packet, read the data from it into the buffer
+        WmcPacketBufferLength = m_WifiUdp.read(m_WmcPacketBuffer, sizeof(m_WmcPacketBuffer));
+
+        if (WmcPacketBufferLength <= 0)
+        {
+            /* Empty datagram. */
+            m_RxStatistics.Dropped++;
+        }
+        else
+        {
+#if WMC_APP_DEBUG_TX_RX == 1
             Serial.print("RX : ");
 
             for (Index = 0; Index < WmcPacketBufferLength; Index++)
@@ -2141,154 +2879,1678 @@ Z21Slave::dataType wmcApp::WmcCheckForDataRx(void)
             Serial.println("");
 #endif
             // Process the data.
-            returnData = m_z21Slave.ProcesDataRx(m_WmcPacketBuffer, sizeof(m_WmcPacketBuffer));
+            m_RxLastTime = millis();
+            WmcProcessDatagram(static_cast<uint16_t>(WmcPacketBufferLength));
+        }
+
+        /* Leave remaining data for the next tick when budget is used. The budget is only exceeded when data is left,
+         * parsePacket() moves to that datagram so it is handled first by the next tick. */
+        if ((Packets >= RX_PACKETS_PER_TICK_MAX) || ((micros() - StartTime) >= RX_TIME_PER_TICK_MAX))
+        {
+            BudgetAvailable   = false;
+            m_RxPacketPending = m_WifiUdp.parsePacket();
+            if (m_RxPacketPending > 0)
+            {
+                m_RxStatistics.BudgetExceeded++;
+            }
         }
     }
 
-    return (returnData);
+    m_RxStatistics.PacketsTick = Packets;
+    m_RxStatistics.Packets += Packets;
+    if (Packets > m_RxStatistics.PacketsTickMax)
+    {
+        m_RxStatistics.PacketsTickMax = Packets;
+    }
+
+    WmcAckCheck();
+    WmcLinkCheck();
 }
 
 /***********************************************************************************************************************
- * Check for data to be transmitted.
+ * Walk through all Z21 messages in the received datagram. Each message starts with its little endian data length
+ * which includes the length field itself, so the next message starts directly behind the current one.
  */
-void wmcApp::WmcCheckForDataTx(void)
+void wmcApp::WmcProcessDatagram(uint16_t Length)
 {
-    uint8_t* DataTransmitPtr;
-    IPAddress WmcUdpIp(m_IpAddresZ21[0], m_IpAddresZ21[1], m_IpAddresZ21[2], m_IpAddresZ21[3]);
+    uint16_t Offset       = 0;
+    uint16_t RecordLength = 0;
+    z21DataEvent WmcDataEvent;
 
-#if WMC_APP_DEBUG_TX_RX == 1
-    uint8_t Index;
-#endif
+    while ((Length - Offset) >= Z21_RECORD_HEADER_SIZE)
+    {
+        RecordLength = WmcDataLengthGet(&m_WmcPacketBuffer[Offset]);
 
-    if (m_z21Slave.txDataPresent() == true)
+        if ((RecordLength < Z21_RECORD_HEADER_SIZE) || (RecordLength > (Length - Offset)))
+        {
+            /* Invalid length, rest of datagram can not be trusted. */
+            break;
+        }
+
+        m_RxStatistics.Records++;
+
+        WmcDataEvent.Type = m_z21Slave.ProcesDataRx(&m_WmcPacketBuffer[Offset], RecordLength);
+        m_wmcAck.Confirm(WmcDataEvent.Type, m_z21Slave.LanXLocoInfo());
+        if ((WmcDataEvent.Type == Z21Slave::trackPowerOff) || (WmcDataEvent.Type == Z21Slave::emergencyStop))
+        {
+            m_SpeedRamp.StopAll();
+        }
+        if (WmcDataEvent.Type == Z21Slave::locinfo)
+        {
+            WmcLocInfoHeard(m_z21Slave.LanXLocoInfo());
+            m_locCache.Update(m_z21Slave.LanXLocoInfo());
+        }
+
+        if (WmcDataEvent.Type != Z21Slave::none)
+        {
+            dispatch(WmcDataEvent);
+        }
+
+        Offset += RecordLength;
+    }
+
+    if (Offset != Length)
     {
-        DataTransmitPtr = m_z21Slave.GetDataTx();
+        m_RxStatistics.Dropped++;
+    }
+}
 
-#if WMC_APP_DEBUG_TX_RX == 1
-        Serial.print("TX : ");
+/***********************************************************************************************************************
+ * Get the little endian data length of a Z21 message.
+ */
+uint16_t wmcApp::WmcDataLengthGet(const uint8_t* DataPtr)
+{
+    return (static_cast<uint16_t>(DataPtr[0]) | (static_cast<uint16_t>(DataPtr[1]) << 8));
+}
+
+/***********************************************************************************************************************
+ * Start monitoring the connection with the control unit.
+ */
+void wmcApp::WmcLinkMonitorStart(void)
+{
+    m_RxLastTime        = millis();
+    m_LinkProbeTime     = m_RxLastTime;
+    m_LinkMonitorActive = true;
+}
+
+/***********************************************************************************************************************
+ * Probe the control unit with status requests when it is silent and throw a link lost event when it does not respond.
+ */
+void wmcApp::WmcLinkCheck(void)
+{
+    linkLostEvent LinkLostEvent;
+    uint32_t Now = millis();
 
-        for (Index = 0; Index < DataTransmitPtr[0]; Index++)
+    if (m_LinkMonitorActive == true)
+    {
+        if ((Now - m_RxLastTime) >= LINK_LOST_TIME)
+        {
+            m_LinkLostTime = m_RxLastTime;
+            dispatch(LinkLostEvent);
+        }
+        else if (((Now - m_RxLastTime) >= LINK_PROBE_TIME) && ((Now - m_LinkProbeTime) >= LINK_PROBE_INTERVAL))
         {
-            Serial.print(DataTransmitPtr[Index], HEX);
-            Serial.print(" ");
+            m_LinkProbeTime = Now;
+            m_LinkStatistics.Probes++;
+            m_z21Slave.LanGetStatus();
+            WmcCheckForDataTx();
         }
+    }
+}
 
-        Serial.println("");
-#endif
+/***********************************************************************************************************************
+ * Transmit the broadcast flags and the handshake requests for which no reply is received yet.
+ */
+void wmcApp::WmcHandshakeTransmit(void)
+{
+    m_z21Slave.LanSetBroadCastFlags(1);
+    WmcCheckForDataTx();
 
-        m_WifiUdp.beginPacket(WmcUdpIp, m_UdpLocalPort);
-        m_WifiUdp.write(DataTransmitPtr, DataTransmitPtr[0]);
-        m_WifiUdp.endPacket();
+    if ((m_HandshakePending & HANDSHAKE_STATUS) != 0)
+    {
+        m_z21Slave.LanGetStatus();
+        WmcCheckForDataTx();
+    }
+
+    if ((m_HandshakePending & HANDSHAKE_LOC_INFO) != 0)
+    {
+        m_z21Slave.LanXGetLocoInfo(m_locLib.GetActualLocAddress());
+        WmcCheckForDataTx();
     }
 }
 
 /***********************************************************************************************************************
- * Convert loc data to tft loc data.
+ * Request track power on, a power off or stop not yet confirmed may no longer be retransmitted.
  */
-void wmcApp::convertLocDataToDisplayData(Z21Slave::locInfo* Z21DataPtr, WmcTft::locoInfo* TftDataPtr)
+void wmcApp::WmcTrackPowerOn(void)
 {
-    TftDataPtr->Address = Z21DataPtr->Address;
-    TftDataPtr->Speed   = Z21DataPtr->Speed;
+    m_wmcAck.Cancel(wmcAck::powerOff, 0);
+    m_wmcAck.Cancel(wmcAck::stop, 0);
 
-    switch (Z21DataPtr->Steps)
+    m_z21Slave.LanSetTrackPowerOn();
+    WmcCheckForDataTx();
+}
+
+/***********************************************************************************************************************
+ * Request track power off or emergency stop, retransmitted until confirmed.
+ */
+void wmcApp::WmcTrackPowerOff(bool Stop)
+{
+    m_SpeedRamp.StopAll();
+
+    if (Stop == false)
     {
-    case Z21Slave::locDecoderSpeedSteps14: TftDataPtr->Steps = WmcTft::locoDecoderSpeedSteps14; break;
-    case Z21Slave::locDecoderSpeedSteps28: TftDataPtr->Steps = WmcTft::locoDecoderSpeedSteps28; break;
-    case Z21Slave::locDecoderSpeedSteps128: TftDataPtr->Steps = WmcTft::locoDecoderSpeedSteps128; break;
-    case Z21Slave::locDecoderSpeedStepsUnknown: TftDataPtr->Steps = WmcTft::locoDecoderSpeedStepsUnknown; break;
+        m_z21Slave.LanSetTrackPowerOff();
+        m_wmcAck.Track(wmcAck::powerOff, NULL);
+    }
+    else
+    {
+        m_z21Slave.LanSetStop();
+        m_wmcAck.Track(wmcAck::stop, NULL);
     }
 
-    switch (Z21DataPtr->Direction)
+    WmcCheckForDataTxUrgent();
+}
+
+/***********************************************************************************************************************
+ * Power button fast path, transmit power off or stop ahead of the transmit queue. The press to transmit latency is
+ * only known for a press taken from the event queue.
+ */
+void wmcApp::WmcPowerButtonFast(bool Stop)
+{
+    WmcTrackPowerOff(Stop);
+
+    m_PowerButtonStatistics.Presses++;
+    if (m_PowerButtonQueued == true)
     {
-    case Z21Slave::locDirectionForward: TftDataPtr->Direction = WmcTft::locoDirectionForward; break;
-    case Z21Slave::locDirectionBackward: TftDataPtr->Direction = WmcTft::locoDirectionBackward; break;
+        m_PowerButtonStatistics.LatencyLast = micros() - m_PowerButtonPressTime;
+        if (m_PowerButtonStatistics.LatencyLast > m_PowerButtonStatistics.LatencyMax)
+        {
+            m_PowerButtonStatistics.LatencyMax = m_PowerButtonStatistics.LatencyLast;
+        }
     }
+}
 
-    switch (Z21DataPtr->Light)
+/***********************************************************************************************************************
+ * Retransmit safety critical commands not confirmed within the retry interval.
+ */
+void wmcApp::WmcAckCheck(void)
+{
+    wmcAck::command Command;
+    Z21Slave::locInfo LocInfo;
+
+    while (m_wmcAck.RetransmitGet(Command, LocInfo) == true)
     {
-    case Z21Slave::locLightOn: TftDataPtr->Light = WmcTft::locoLightOn; break;
-    case Z21Slave::locLightOff: TftDataPtr->Light = WmcTft::locoLightOff; break;
+        switch (Command)
+        {
+        case wmcAck::powerOff: m_z21Slave.LanSetTrackPowerOff(); break;
+        case wmcAck::stop: m_z21Slave.LanSetStop(); break;
+        case wmcAck::locStop: m_z21Slave.LanXSetLocoDrive(&LocInfo); break;
+        }
+
+        WmcCheckForDataTx();
+    }
+}
+
+/***********************************************************************************************************************
+ * Get the statistics of the safety critical commands.
+ */
+const wmcAck::statistics& wmcApp::AckStatisticsGet(void) { return (m_wmcAck.StatisticsGet()); }
+
+/***********************************************************************************************************************
+ * Get the connection statistics.
+ */
+const wmcApp::linkStatistics& wmcApp::LinkStatisticsGet(void) { return (m_LinkStatistics); }
+
+/***********************************************************************************************************************
+ * Get the receive statistics.
+ */
+const wmcApp::rxStatistics& wmcApp::RxStatisticsGet(void) { return (m_RxStatistics); }
+
+/***********************************************************************************************************************
+ * Check for data to be transmitted and put it in the transmit queue. The queue is transmitted by WmcTxFlush at the
+ * end of the event, so all messages of one tick are packed into one datagram.
+ */
+void wmcApp::WmcCheckForDataTx(void)
+{
+    uint8_t* DataTransmitPtr;
+    uint16_t DataTransmitLength;
+    uint8_t Slot;
+
+    if (m_z21Slave.txDataPresent() == true)
+    {
+        DataTransmitPtr    = m_z21Slave.GetDataTx();
+        DataTransmitLength = WmcDataLengthGet(DataTransmitPtr);
+
+        if (DataTransmitLength > TX_MESSAGE_SIZE_MAX)
+        {
+            /* Message does not fit in a queue slot, keep order and transmit it on its own. */
+            WmcTxFlush();
+            WmcTxDatagram(DataTransmitPtr, DataTransmitLength);
+        }
+        else
+        {
+            if (m_TxStatistics.QueueDepth >= TX_QUEUE_SIZE)
+            {
+                m_TxStatistics.Overflow++;
+                WmcTxFlush();
+            }
+
+            Slot = (m_TxQueueHead + m_TxStatistics.QueueDepth) % TX_QUEUE_SIZE;
+            memcpy(m_TxQueue[Slot], DataTransmitPtr, DataTransmitLength);
+            m_TxStatistics.QueueDepth++;
+
+            if (m_TxStatistics.QueueDepth > m_TxStatistics.QueueDepthMax)
+            {
+                m_TxStatistics.QueueDepthMax = m_TxStatistics.QueueDepth;
+            }
+        }
     }
+}
 
-    TftDataPtr->Functions = Z21DataPtr->Functions;
-    TftDataPtr->Occupied  = Z21DataPtr->Occupied;
+/***********************************************************************************************************************
+ * Transmit Z21 data immediately in its own datagram, ahead of the messages waiting in the transmit queue.
+ */
+void wmcApp::WmcCheckForDataTxUrgent(void)
+{
+    uint8_t* DataTransmitPtr;
+
+    if (m_z21Slave.txDataPresent() == true)
+    {
+        DataTransmitPtr = m_z21Slave.GetDataTx();
+        WmcTxDatagram(DataTransmitPtr, WmcDataLengthGet(DataTransmitPtr));
+        m_TxStatistics.Urgent++;
+    }
 }
 
 /***********************************************************************************************************************
- * Update loc info on screen.
+ * Transmit all queued messages, packed in as less datagrams as possible.
  */
-bool wmcApp::updateLocInfoOnScreen(bool updateAll)
+void wmcApp::WmcTxFlush(void)
 {
-    uint8_t Index        = 0;
-    bool Result          = true;
-    m_WmcLocInfoReceived = m_z21Slave.LanXLocoInfo();
-    WmcTft::locoInfo locInfoActual;
-    WmcTft::locoInfo locInfoPrevious;
+    uint8_t* DataTransmitPtr;
+    uint16_t DataTransmitLength;
+    uint16_t DatagramLength  = 0;
+    uint8_t DatagramMessages = 0;
+    IPAddress WmcUdpIp(m_Config.IpAddressZ21[0], m_Config.IpAddressZ21[1], m_Config.IpAddressZ21[2],
+        m_Config.IpAddressZ21[3]);
 
-    if (m_locLib.GetActualLocAddress() == m_WmcLocInfoReceived->Address)
+    while (m_TxStatistics.QueueDepth > 0)
     {
-        switch (m_WmcLocInfoReceived->Steps)
+        DataTransmitPtr    = m_TxQueue[m_TxQueueHead];
+        DataTransmitLength = WmcDataLengthGet(DataTransmitPtr);
+
+        if ((DatagramLength + DataTransmitLength) > TX_DATAGRAM_SIZE_MAX)
         {
-        case Z21Slave::locDecoderSpeedSteps14: m_locLib.DecoderStepsUpdate(decoderStep14); break;
-        case Z21Slave::locDecoderSpeedSteps28: m_locLib.DecoderStepsUpdate(decoderStep28); break;
-        case Z21Slave::locDecoderSpeedSteps128: m_locLib.DecoderStepsUpdate(decoderStep128); break;
-        case Z21Slave::locDecoderSpeedStepsUnknown: m_locLib.DecoderStepsUpdate(decoderStep28); break;
+            m_WifiUdp.endPacket();
+            DatagramLength   = 0;
+            DatagramMessages = 0;
         }
 
-        for (Index = 0; Index < 5; Index++)
+        if (DatagramLength == 0)
         {
-            m_locFunctionAssignment[Index] = m_locLib.FunctionAssignedGet(Index);
+            m_WifiUdp.beginPacket(WmcUdpIp, m_UdpLocalPort);
+            m_TxStatistics.Datagrams++;
+            m_TxMinuteDatagrams++;
         }
 
-        /* Invert functions so function symbols are updated if new loc is selected and set new direction. */
-        if (m_locSelection == true)
+        WmcTxDebug(DataTransmitPtr, DataTransmitLength);
+        m_WifiUdp.write(DataTransmitPtr, DataTransmitLength);
+        DatagramLength += DataTransmitLength;
+        DatagramMessages++;
+        m_TxStatistics.Messages++;
+        m_TxMinuteMessages++;
+
+        if (DatagramMessages > 1)
         {
-            m_WmcLocInfoControl.Functions = ~m_WmcLocInfoReceived->Functions;
-            m_locSelection                = false;
+            m_TxStatistics.Coalesced++;
         }
 
-        convertLocDataToDisplayData(m_WmcLocInfoReceived, &locInfoActual);
-        convertLocDataToDisplayData(&m_WmcLocInfoControl, &locInfoPrevious);
-        m_wmcTft.UpdateLocInfo(
-            &locInfoActual, &locInfoPrevious, m_locFunctionAssignment, m_locLib.GetLocName(), updateAll);
+        m_TxQueueHead = (m_TxQueueHead + 1) % TX_QUEUE_SIZE;
+        m_TxStatistics.QueueDepth--;
+    }
 
-        memcpy(&m_WmcLocInfoControl, m_WmcLocInfoReceived, sizeof(Z21Slave::locInfo));
+    if (DatagramLength != 0)
+    {
+        m_WifiUdp.endPacket();
     }
-    else
+
+    /* Publish the number of transmitted datagrams and messages once a minute. */
+    if ((millis() - m_TxMinuteStart) >= 60000)
     {
-        Result = false;
+        m_TxStatistics.DatagramsPerMinute = m_TxMinuteDatagrams;
+        m_TxStatistics.MessagesPerMinute  = m_TxMinuteMessages;
+        m_TxMinuteDatagrams               = 0;
+        m_TxMinuteMessages                = 0;
+        m_TxMinuteStart                   = millis();
     }
+}
 
-    return (Result);
+/***********************************************************************************************************************
+ * Transmit a single message in its own datagram.
+ */
+void wmcApp::WmcTxDatagram(uint8_t* DataTransmitPtr, uint16_t DataTransmitLength)
+{
+    IPAddress WmcUdpIp(m_Config.IpAddressZ21[0], m_Config.IpAddressZ21[1], m_Config.IpAddressZ21[2],
+        m_Config.IpAddressZ21[3]);
+
+    WmcTxDebug(DataTransmitPtr, DataTransmitLength);
+    m_WifiUdp.beginPacket(WmcUdpIp, m_UdpLocalPort);
+    m_WifiUdp.write(DataTransmitPtr, DataTransmitLength);
+    m_WifiUdp.endPacket();
+
+    m_TxStatistics.Messages++;
+    m_TxStatistics.Datagrams++;
+    m_TxMinuteMessages++;
+    m_TxMinuteDatagrams++;
 }
 
 /***********************************************************************************************************************
- * Compose locomotive message to be transmitted and transmit it.
+ * Show transmitted data when debugging is enabled.
  */
-void wmcApp::PrepareLanXSetLocoDriveAndTransmit(uint16_t Speed)
+void wmcApp::WmcTxDebug(uint8_t* DataTransmitPtr, uint16_t DataTransmitLength)
 {
-    Z21Slave::locInfo LocInfoTx;
+#if WMC_APP_DEBUG_TX_RX == 1
+    uint16_t Index;
 
-    /* Get loc data and compose it for transmit */
-    LocInfoTx.Speed = Speed;
-    if (m_locLib.DirectionGet() == directionForward)
+    Serial.print("TX : ");
+
+    for (Index = 0; Index < DataTransmitLength; Index++)
     {
-        LocInfoTx.Direction = Z21Slave::locDirectionForward;
+        Serial.print(DataTransmitPtr[Index], HEX);
+        Serial.print(" ");
     }
-    else
+
+    Serial.println("");
+#else
+    (void)DataTransmitPtr;
+    (void)DataTransmitLength;
+#endif
+}
+
+/***********************************************************************************************************************
+ * Loc info of the selected loc is received by broadcast or as response. When it is the response on a poll adapt the
+ * poll timeout: a changed loc means broadcasts were missed so poll sooner, an unchanged loc allows to back off.
+ */
+void wmcApp::WmcLocInfoHeard(Z21Slave::locInfo* LocInfoPtr)
+{
+    if (LocInfoPtr->Address == m_locLib.GetActualLocAddress())
+    {
+        if (m_LocInfoPollPending == true)
+        {
+            m_LocInfoPollPending = false;
+
+            if ((LocInfoPtr->Speed != m_WmcLocInfoControl.Speed)
+                || (LocInfoPtr->Direction != m_WmcLocInfoControl.Direction)
+                || (LocInfoPtr->Functions != m_WmcLocInfoControl.Functions))
+            {
+                m_LocInfoPollTimeout = LOC_INFO_POLL_TIMEOUT_MIN;
+            }
+            else if (m_LocInfoPollTimeout < LOC_INFO_POLL_TIMEOUT_MAX)
+            {
+                m_LocInfoPollTimeout *= 2;
+            }
+        }
+
+        m_LocInfoRxTime = millis();
+    }
+}
+
+/***********************************************************************************************************************
+ * Request loc info of the selected loc when no loc info was received within the poll timeout.
+ */
+void wmcApp::WmcLocInfoPoll(void)
+{
+    if ((m_LocSelectPending == false) && ((millis() - m_LocInfoRxTime) >= m_LocInfoPollTimeout))
     {
-        LocInfoTx.Direction = Z21Slave::locDirectionBackward;
+        m_LocInfoPollPending = true;
+        m_LocInfoRxTime      = millis();
+        m_TxStatistics.LocInfoPolls++;
+        m_z21Slave.LanXGetLocoInfo(m_locLib.GetActualLocAddress());
+        WmcCheckForDataTx();
     }
+}
+
+/***********************************************************************************************************************
+ * Read the configuration record from EEPROM in one pass and check version and CRC. A record not matching its CRC is
+ * corrupt, it is replaced by the last known good copy or when the copy is not valid either by defaults, so the
+ * buttons are learned and the network is set by the CLI again.
+ */
+void wmcApp::WmcConfigLoad(void)
+{
+    uint32_t StartTime = micros();
 
-    LocInfoTx.Address = m_locLib.GetActualLocAddress();
+    EEPROM.get(0, m_Config);
 
-    switch (m_locLib.DecoderStepsGet())
+    m_ConfigValid = (m_Config.EepromVersion == EepCfg::EepromVersion);
+    if (m_ConfigValid == false)
     {
-    case decoderStep14: LocInfoTx.Steps = Z21Slave::locDecoderSpeedSteps14; break;
-    case decoderStep28: LocInfoTx.Steps = Z21Slave::locDecoderSpeedSteps28; break;
-    case decoderStep128: LocInfoTx.Steps = Z21Slave::locDecoderSpeedSteps128; break;
+        m_ConfigStatistics.VersionErrors++;
     }
+    else if (WmcConfigCrcValid(m_Config) == false)
+    {
+        m_ConfigStatistics.CrcErrors++;
 
-    m_z21Slave.LanXSetLocoDrive(&LocInfoTx);
-    WmcCheckForDataTx();
+        EEPROM.get(EepCfg::ConfigCopyAddress, m_Config);
+        if ((m_Config.EepromVersion == EepCfg::EepromVersion) && (WmcConfigCrcValid(m_Config) == true))
+        {
+            m_ConfigStatistics.Restores++;
+        }
+        else
+        {
+            m_ConfigStatistics.Defaults++;
+            m_ConfigValid = false;
+            memset(&m_Config, 0, sizeof(m_Config));
+            m_Config.EepromVersion = EepCfg::EepromVersion;
+        }
+
+        m_wmcEep.Put(0, m_Config);
+        WmcConfigStore();
+        m_wmcEep.Commit();
+    }
+
+    /* Strings must always be terminated. */
+    m_Config.SsidName[sizeof(m_Config.SsidName) - 1]         = '\0';
+    m_Config.SsidPassword[sizeof(m_Config.SsidPassword) - 1] = '\0';
+
+    m_ConfigStatistics.LoadTime = micros() - StartTime;
+}
+
+/***********************************************************************************************************************
+ * Write the parts of the configuration record owned by the application, its CRC and the last known good copy.
+ * Settings owned by LocStorage are not written from the RAM copy, they may have been changed after boot.
+ */
+void wmcApp::WmcConfigStore(void)
+{
+    uint16_t Crc = WmcConfigCrc(m_Config);
+
+    m_Config.Crc[0] = Crc & 0xFF;
+    m_Config.Crc[1] = Crc >> 8;
+
+    m_wmcEep.Write(EepCfg::ButtonAdcValuesAddressValid, m_Config.ButtonAdcValuesValid);
+    m_wmcEep.Write(EepCfg::ButtonAdcValuesAddress, m_Config.ButtonAdcValues, sizeof(m_Config.ButtonAdcValues));
+    m_wmcEep.Write(EepCfg::ConfigCrcAddress, m_Config.Crc, sizeof(m_Config.Crc));
+    m_wmcEep.Write(EepCfg::WifiCacheAddress, &m_Config.WifiCacheValid,
+        offsetof(EepCfg::config, Reserved47) - offsetof(EepCfg::config, WifiCacheValid));
+    m_wmcEep.Put(EepCfg::ConfigCopyAddress, m_Config);
+    m_ConfigStatistics.Stores++;
+}
+
+/***********************************************************************************************************************
+ * The CLI and LocStorage write their settings to EEPROM without updating the CRC. Take over such a write and seal
+ * the record again, so only corruption results in a CRC mismatch at boot.
+ */
+void wmcApp::WmcConfigSync(void)
+{
+    EepCfg::config Config;
+
+    EEPROM.get(0, Config);
+    if ((Config.EepromVersion == EepCfg::EepromVersion) && (WmcConfigCrcValid(Config) == false))
+    {
+        m_Config = Config;
+        m_Config.SsidName[sizeof(m_Config.SsidName) - 1]         = '\0';
+        m_Config.SsidPassword[sizeof(m_Config.SsidPassword) - 1] = '\0';
+
+        WmcConfigStore();
+        m_wmcEep.Commit();
+        m_ConfigStatistics.Seals++;
+    }
+}
+
+/***********************************************************************************************************************
+ * Check the CRC of a configuration record.
+ */
+bool wmcApp::WmcConfigCrcValid(const EepCfg::config& Config)
+{
+    uint16_t Crc = WmcConfigCrc(Config);
+
+    return ((Config.Crc[0] == (Crc & 0xFF)) && (Config.Crc[1] == (Crc >> 8)));
+}
+
+/***********************************************************************************************************************
+ * CRC16-CCITT of the configuration record. The CRC itself, the settings changed at run time by LocStorage and the
+ * string terminators forced after reading are excluded.
+ */
+uint16_t wmcApp::WmcConfigCrc(const EepCfg::config& Config)
+{
+    EepCfg::config Data = Config;
+    const uint8_t* DataPtr;
+    uint16_t Crc = 0xFFFF;
+    uint8_t Bit;
+    size_t Index;
+
+    Data.Crc[0]               = 0;
+    Data.Crc[1]               = 0;
+    Data.AcTypeControl        = 0;
+    Data.EmergencyStopEnabled = 0;
+    Data.SelectedLoc[0]       = 0;
+    Data.SelectedLoc[1]       = 0;
+
+    Data.SsidName[sizeof(Data.SsidName) - 1]         = '\0';
+    Data.SsidPassword[sizeof(Data.SsidPassword) - 1] = '\0';
+
+    DataPtr = reinterpret_cast<const uint8_t*>(&Data);
+    for (Index = 0; Index < sizeof(Data); Index++)
+    {
+        Crc ^= static_cast<uint16_t>(DataPtr[Index]) << 8;
+        for (Bit = 0; Bit < 8; Bit++)
+        {
+            Crc = (Crc & 0x8000) ? ((Crc << 1) ^ 0x1021) : (Crc << 1);
+        }
+    }
+
+    return (Crc);
+}
+
+/***********************************************************************************************************************
+ * Start the association with the wifi network of the configuration, only once. When data of the last connection is
+ * present first try a fast connect to the same access point and channel without scan.
+ */
+void wmcApp::WmcWifiStart(void)
+{
+    if (m_WifiStarted == false)
+    {
+        m_WifiStarted = true;
+        m_BootLog.Mark(wmcBootLog::wifiStart);
+
+        /* Credentials are in our own EEPROM data, avoid a flash write by the SDK on each begin. */
+        WiFi.persistent(false);
+        WiFi.mode(WIFI_STA);
+
+        m_WifiStartTime    = millis();
+        m_WifiPollInterval = WIFI_POLL_INTERVAL_MIN;
+        m_Timer.Start(wmcTimer::wifiPoll, m_WifiPollInterval);
+        m_WifiFastConnect  = (m_Config.WifiCacheValid == 1);
+        m_WifiLeaseReuse   = (m_WifiFastConnect == true) && (m_Config.StaticIp != 1)
+            && (m_Config.WifiLeaseUses < WIFI_LEASE_USES_MAX);
+        WmcWifiBegin();
+    }
+}
+
+/***********************************************************************************************************************
+ * Set the IP configuration and begin the connection, with cached access point data for a fast connect.
+ */
+void wmcApp::WmcWifiBegin(void)
+{
+    const char* PasswordPtr = NULL;
+
+    /* If static IP active set fixed IP settings for static IP. */
+    if (m_Config.StaticIp == 1)
+    {
+        IPAddress ip(
+            m_Config.IpAddressWmc[0], m_Config.IpAddressWmc[1], m_Config.IpAddressWmc[2], m_Config.IpAddressWmc[3]);
+        IPAddress gateway(m_Config.IpGateway[0], m_Config.IpGateway[1], m_Config.IpGateway[2], m_Config.IpGateway[3]);
+        IPAddress subnet(m_Config.IpSubnet[0], m_Config.IpSubnet[1], m_Config.IpSubnet[2], m_Config.IpSubnet[3]);
+
+        WiFi.config(ip, gateway, subnet);
+    }
+    else if (m_WifiLeaseReuse == true)
+    {
+        /* Reuse the last DHCP lease, skips the DHCP exchange. */
+        IPAddress ip(m_Config.WifiIpAddress[0], m_Config.WifiIpAddress[1], m_Config.WifiIpAddress[2],
+            m_Config.WifiIpAddress[3]);
+        IPAddress gateway(
+            m_Config.WifiGateway[0], m_Config.WifiGateway[1], m_Config.WifiGateway[2], m_Config.WifiGateway[3]);
+        IPAddress subnet(
+            m_Config.WifiSubnet[0], m_Config.WifiSubnet[1], m_Config.WifiSubnet[2], m_Config.WifiSubnet[3]);
+
+        WiFi.config(ip, gateway, subnet);
+    }
+    else
+    {
+        /* Back to DHCP. */
+        WiFi.config(IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0));
+    }
+
+    /* Check for password length, if no password connect with NULL. */
+    if (strlen(m_Config.SsidPassword) != 0)
+    {
+        PasswordPtr = m_Config.SsidPassword;
+    }
+
+    if (m_WifiFastConnect == true)
+    {
+        WiFi.begin(m_Config.SsidName, PasswordPtr, m_Config.WifiChannel, m_Config.WifiBssid);
+    }
+    else
+    {
+        WiFi.begin(m_Config.SsidName, PasswordPtr);
+    }
+}
+
+/***********************************************************************************************************************
+ * Fast connect failed, the access point, channel or lease changed. Connect again with a full scan and DHCP.
+ */
+void wmcApp::WmcWifiFallback(void)
+{
+    m_BootLog.Mark(wmcBootLog::wifiScan);
+    m_WifiFastConnect  = false;
+    m_WifiLeaseReuse   = false;
+    m_WifiPollInterval = WIFI_POLL_INTERVAL_MIN;
+    m_Timer.Start(wmcTimer::wifiPoll, m_WifiPollInterval);
+
+    WiFi.disconnect();
+    WmcWifiBegin();
+}
+
+/***********************************************************************************************************************
+ * No reply of the control unit with the reused lease, the address may be in use by another device. Drop the cached
+ * data and connect again with a full scan and DHCP.
+ */
+void wmcApp::WmcWifiLeaseDrop(void)
+{
+    m_Config.WifiCacheValid = 0;
+    m_Config.WifiLeaseUses  = 0;
+    WmcConfigStore();
+    m_wmcEep.Commit();
+
+    m_WifiUdp.stop();
+    m_WifiStartTime = millis();
+    WmcWifiFallback();
+}
+
+/***********************************************************************************************************************
+ * Store access point, channel and DHCP lease of the connection for a fast connect at the next boot. A reused lease is
+ * not stored again, only its use is counted so DHCP is done again after WIFI_LEASE_USES_MAX connects.
+ */
+void wmcApp::WmcWifiCacheStore(void)
+{
+    uint8_t* BssidPtr = WiFi.BSSID();
+    IPAddress Ip      = WiFi.localIP();
+    IPAddress Gateway = WiFi.gatewayIP();
+    IPAddress Subnet  = WiFi.subnetMask();
+    uint8_t Index;
+
+    m_Config.WifiCacheValid = 1;
+    m_Config.WifiChannel    = WiFi.channel();
+    memcpy(m_Config.WifiBssid, BssidPtr, sizeof(m_Config.WifiBssid));
+
+    if (m_WifiLeaseReuse == true)
+    {
+        m_Config.WifiLeaseUses++;
+    }
+    else
+    {
+        m_Config.WifiLeaseUses = 0;
+        for (Index = 0; Index < 4; Index++)
+        {
+            m_Config.WifiIpAddress[Index] = Ip[Index];
+            m_Config.WifiGateway[Index]   = Gateway[Index];
+            m_Config.WifiSubnet[Index]    = Subnet[Index];
+        }
+    }
+
+    WmcConfigStore();
+}
+
+/***********************************************************************************************************************
+ * Get the boot timeline of the actual (index 0) or a previous boot.
+ */
+const wmcBootLog::boot* wmcApp::BootLogGet(uint8_t Index) { return (m_BootLog.Get(Index)); }
+
+/***********************************************************************************************************************
+ * Get the configuration record statistics.
+ */
+const wmcApp::configStatistics& wmcApp::ConfigStatisticsGet(void) { return (m_ConfigStatistics); }
+
+/***********************************************************************************************************************
+ * Sample the button ADC input, a detected press is queued and dispatched with the other queued input. The pulse switch
+ * interrupt writes to the same lane, so it is masked while queueing.
+ */
+void wmcApp::WmcButtonSample(void)
+{
+    uint8_t Button = m_AdcButtons.Sample(analogRead(WMC_APP_ANALOG_IN));
+
+    if (Button != wmcAdcButtons::BUTTON_NONE)
+    {
+        noInterrupts();
+        m_EventQueue.PushButton(static_cast<pushButtons>(Button));
+        interrupts();
+    }
+}
+
+/***********************************************************************************************************************
+ * Dispatch the input events queued by the interrupts and the button sampling, called at the end of the 5 msec update
+ * of each state. The power button lane is emptied first. Commands of the events leave with the transmit of the update.
+ */
+void wmcApp::WmcEventQueueCheck(void)
+{
+    wmcEventQueue::entry Entry;
+    pulseSwitchEvent PulseSwitchEvent;
+    pushButtonsEvent PushButtonsEvent;
+    powerButtonEvent PowerButtonEvent;
+
+    while (m_EventQueue.Pop(Entry) == true)
+    {
+        switch (Entry.Type)
+        {
+        case wmcEventQueue::pulseSwitch:
+            PulseSwitchEvent.Delta  = Entry.Delta;
+            PulseSwitchEvent.Status = Entry.Status;
+            dispatch(PulseSwitchEvent);
+            break;
+        case wmcEventQueue::pushButton:
+            PushButtonsEvent.Button = Entry.Button;
+            dispatch(PushButtonsEvent);
+            break;
+        case wmcEventQueue::powerButton:
+            PowerButtonEvent.PressTime = Entry.Time;
+            dispatch(PowerButtonEvent);
+            break;
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ * Get the button decoding statistics.
+ */
+const wmcAdcButtons::statistics& wmcApp::ButtonStatisticsGet(void) { return (m_AdcButtons.StatisticsGet()); }
+
+/***********************************************************************************************************************
+ * Dispatch an event for each expired timer, called from the 5 msec update of each state. Only the first deadline is
+ * compared when no timer expired.
+ */
+void wmcApp::WmcTimerCheck(void)
+{
+    timerEvent TimerEvent;
+
+    while (m_Timer.Expired(TimerEvent.Id) == true)
+    {
+        dispatch(TimerEvent);
+    }
+}
+
+/***********************************************************************************************************************
+ * Get the timer statistics.
+ */
+const wmcTimer::statistics& wmcApp::TimerStatisticsGet(void) { return (m_Timer.StatisticsGet()); }
+
+/***********************************************************************************************************************
+ * Get the input event queue statistics.
+ */
+const wmcEventQueue::statistics& wmcApp::EventQueueStatisticsGet(void) { return (m_EventQueue.StatisticsGet()); }
+
+/***********************************************************************************************************************
+ * Get the pulse switch acceleration statistics.
+ */
+const wmcPulseAccel::statistics& wmcApp::PulseAccelStatisticsGet(void) { return (m_PulseAccel.StatisticsGet()); }
+
+/***********************************************************************************************************************
+ * Change the pulse switch acceleration profile of a context.
+ */
+void wmcApp::PulseAccelProfileSet(wmcPulseAccel::profile Id, const wmcPulseAccel::config& Config)
+{
+    m_PulseAccel.ProfileSet(Id, Config);
+}
+
+/***********************************************************************************************************************
+ * Get the power button fast path statistics.
+ */
+const wmcApp::powerButtonStatistics& wmcApp::PowerButtonStatisticsGet(void) { return (m_PowerButtonStatistics); }
+
+/***********************************************************************************************************************
+ * Get the transmit statistics.
+ */
+const wmcApp::txStatistics& wmcApp::TxStatisticsGet(void) { return (m_TxStatistics); }
+
+/***********************************************************************************************************************
+ * Get the EEPROM write statistics.
+ */
+const wmcEep::statistics& wmcApp::EepStatisticsGet(void) { return (m_wmcEep.StatisticsGet()); }
+
+/***********************************************************************************************************************
+ * Get the loc cache statistics.
+ */
+const wmcLocCache::statistics& wmcApp::LocCacheStatisticsGet(void) { return (m_locCache.StatisticsGet()); }
+
+/***********************************************************************************************************************
+ * Get the loc selection statistics.
+ */
+const wmcApp::locSelectStatistics& wmcApp::LocSelectStatisticsGet(void) { return (m_LocSelectStatistics); }
+
+/***********************************************************************************************************************
+ * Get the speed pipeline statistics.
+ */
+const wmcApp::speedStatistics& wmcApp::SpeedStatisticsGet(void) { return (m_SpeedStatistics); }
+
+/***********************************************************************************************************************
+ * Convert loc data to tft loc data.
+ */
+void wmcApp::convertLocDataToDisplayData(Z21Slave::locInfo* Z21DataPtr, WmcTft::locoInfo* TftDataPtr)
+{
+    TftDataPtr->Address = Z21DataPtr->Address;
+    TftDataPtr->Speed   = Z21DataPtr->Speed;
+
+    switch (Z21DataPtr->Steps)
+    {
+    case Z21Slave::locDecoderSpeedSteps14: TftDataPtr->Steps = WmcTft::locoDecoderSpeedSteps14; break;
+    case Z21Slave::locDecoderSpeedSteps28: TftDataPtr->Steps = WmcTft::locoDecoderSpeedSteps28; break;
+    case Z21Slave::locDecoderSpeedSteps128: TftDataPtr->Steps = WmcTft::locoDecoderSpeedSteps128; break;
+    case Z21Slave::locDecoderSpeedStepsUnknown: TftDataPtr->Steps = WmcTft::locoDecoderSpeedStepsUnknown; break;
+    }
+
+    switch (Z21DataPtr->Direction)
+    {
+    case Z21Slave::locDirectionForward: TftDataPtr->Direction = WmcTft::locoDirectionForward; break;
+    case Z21Slave::locDirectionBackward: TftDataPtr->Direction = WmcTft::locoDirectionBackward; break;
+    }
+
+    switch (Z21DataPtr->Light)
+    {
+    case Z21Slave::locLightOn: TftDataPtr->Light = WmcTft::locoLightOn; break;
+    case Z21Slave::locLightOff: TftDataPtr->Light = WmcTft::locoLightOff; break;
+    }
+
+    TftDataPtr->Functions = Z21DataPtr->Functions;
+    TftDataPtr->Occupied  = Z21DataPtr->Occupied;
+}
+
+/***********************************************************************************************************************
+ * Update received loc info on screen.
+ */
+bool wmcApp::updateLocInfoOnScreen(bool updateAll)
+{
+    return (updateLocInfoOnScreen(m_z21Slave.LanXLocoInfo(), updateAll));
+}
+
+/***********************************************************************************************************************
+ * Update loc info on screen.
+ */
+bool wmcApp::updateLocInfoOnScreen(Z21Slave::locInfo* LocInfoPtr, bool updateAll)
+{
+    uint8_t Index        = 0;
+    bool Result          = true;
+    m_WmcLocInfoReceived = LocInfoPtr;
+    WmcTft::locoInfo locInfoActual;
+    WmcTft::locoInfo locInfoPrevious;
+    Z21Slave::locInfo locInfoShow;
+
+    if (m_locLib.GetActualLocAddress() == m_WmcLocInfoReceived->Address)
+    {
+        switch (m_WmcLocInfoReceived->Steps)
+        {
+        case Z21Slave::locDecoderSpeedSteps14: m_locLib.DecoderStepsUpdate(decoderStep14); break;
+        case Z21Slave::locDecoderSpeedSteps28: m_locLib.DecoderStepsUpdate(decoderStep28); break;
+        case Z21Slave::locDecoderSpeedSteps128: m_locLib.DecoderStepsUpdate(decoderStep128); break;
+        case Z21Slave::locDecoderSpeedStepsUnknown: m_locLib.DecoderStepsUpdate(decoderStep28); break;
+        }
+
+        for (Index = 0; Index < 5; Index++)
+        {
+            m_locFunctionAssignment[Index] = m_locLib.FunctionAssignedGet(Index);
+        }
+
+        /* Invert functions so function symbols are updated if new loc is selected and set new direction. */
+        if (m_locSelection == true)
+        {
+            m_WmcLocInfoControl.Functions = ~m_WmcLocInfoReceived->Functions;
+            m_locSelection                = false;
+        }
+
+        /* Keep showing the locally requested speed and direction until the control confirms it. */
+        memcpy(&locInfoShow, m_WmcLocInfoReceived, sizeof(Z21Slave::locInfo));
+        if (WmcSpeedUnconfirmed() == true)
+        {
+            WmcSpeedLocalSet(&locInfoShow);
+        }
+
+        convertLocDataToDisplayData(&locInfoShow, &locInfoActual);
+        convertLocDataToDisplayData(&m_WmcLocInfoControl, &locInfoPrevious);
+        m_wmcTft.UpdateLocInfo(
+            &locInfoActual, &locInfoPrevious, m_locFunctionAssignment, m_locLib.GetLocName(), updateAll);
+
+        memcpy(&m_WmcLocInfoControl, &locInfoShow, sizeof(Z21Slave::locInfo));
+    }
+    else
+    {
+        Result = false;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Loc selection changed by the pulse switch, the loc info request is done when the selection is stable.
+ */
+void wmcApp::WmcLocSelectChanged(void)
+{
+    m_LocSelectStatistics.Changes++;
+    if (m_LocSelectPending == true)
+    {
+        m_LocSelectStatistics.Suppressed++;
+    }
+
+    m_LocSelectPending = true;
+    m_Timer.Start(wmcTimer::locSelectStable, LOC_SELECT_STABLE_TIME);
+}
+
+/***********************************************************************************************************************
+ * Loc selection is stable, show the cached data and request the loc info of the selected loc.
+ */
+void wmcApp::WmcLocSelectStable(void)
+{
+    if (m_LocSelectPending == true)
+    {
+        m_LocSelectPending = false;
+        m_LocSelectStatistics.Requests++;
+
+        /* Show cached data immediately, refresh in the background. */
+        m_locSelection = true;
+        WmcLocInfoFromCache();
+        m_z21Slave.LanXGetLocoInfo(m_locLib.GetActualLocAddress());
+        WmcCheckForDataTx();
+        WmcConsistInfoGet();
+    }
+}
+
+/***********************************************************************************************************************
+ * Show the cached loc info of the selected loc and take over speed and direction when present.
+ */
+void wmcApp::WmcLocInfoFromCache(void)
+{
+    Z21Slave::locInfo* LocInfoPtr = m_locCache.Get(m_locLib.GetActualLocAddress());
+
+    if (LocInfoPtr != NULL)
+    {
+        if (updateLocInfoOnScreen(LocInfoPtr, false) == true)
+        {
+            m_locLib.SpeedUpdate(LocInfoPtr->Speed);
+            if (LocInfoPtr->Direction == Z21Slave::locDirectionForward)
+            {
+                m_locLib.DirectionSet(directionForward);
+            }
+            else
+            {
+                m_locLib.DirectionSet(directionBackWard);
+            }
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ * Check whether a loc is present, by binary search in the address index when it holds all locs.
+ */
+bool wmcApp::WmcLocPresent(uint16_t Address)
+{
+    bool Result = false;
+
+    if (m_locIndex.Valid() == true)
+    {
+        Result = (m_locIndex.Find(Address) != wmcLocIndex::NOT_FOUND);
+    }
+    else
+    {
+        Result = (m_locLib.CheckLoc(Address) != 255);
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Add a loc to the loc library and address index. A new loc with the highest address is stored behind the others
+ * so a sorted library stays sorted, only in other cases the library needs to be sorted.
+ */
+void wmcApp::WmcLocAdd(uint16_t Address, uint8_t* FunctionPtr, char* NamePtr, LocLib::action Action, bool Sort)
+{
+    uint8_t NumberOfLocs = m_locLib.GetNumberOfLocs();
+    uint8_t Position     = wmcLocIndex::NOT_FOUND;
+
+    m_locLib.StoreLoc(Address, FunctionPtr, NamePtr, Action);
+
+    if (m_locLib.GetNumberOfLocs() != NumberOfLocs)
+    {
+        Position = m_locIndex.Insert(Address);
+
+        if ((m_locIndex.LibrarySorted() == false) || (Position != (m_locIndex.Count() - 1)))
+        {
+            if (Sort == true)
+            {
+                m_locLib.LocBubbleSort();
+                m_locIndex.LibrarySortedSet(true);
+            }
+            else
+            {
+                m_locIndex.LibrarySortedSet(false);
+            }
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ * Store all staged locs of a received loc library. The locs are staged sorted by address, so they are added in
+ * increasing order and the library only needs to be sorted once when the new locs are mixed with present ones.
+ */
+void wmcApp::WmcLocImportCommit(void)
+{
+    uint8_t Index                    = 0;
+    uint8_t locFunctionAssignment[5] = { 0, 1, 2, 3, 4 };
+    wmcLocImport::locData* LocDataPtr;
+
+    if (m_locImport.Count() > 0)
+    {
+        m_wmcTft.UpdateStatus("STORING  ", false, WmcTft::color_white);
+
+        for (Index = 0; Index < m_locImport.Count(); Index++)
+        {
+            LocDataPtr = m_locImport.Get(Index);
+            WmcLocAdd(
+                LocDataPtr->Address, locFunctionAssignment, LocDataPtr->Name, LocLib::storeAddNoAutoSelect, false);
+        }
+
+        if (m_locIndex.LibrarySorted() == false)
+        {
+            m_locLib.LocBubbleSort();
+            m_locIndex.LibrarySortedSet(true);
+        }
+
+        m_locImport.Clear();
+        m_wmcTft.UpdateSelectedAndNumberOfLocs(m_locLib.GetActualSelectedLocIndex(), m_locLib.GetNumberOfLocs());
+    }
+}
+
+/***********************************************************************************************************************
+ * Compose locomotive message to be transmitted and transmit it.
+ */
+void wmcApp::PrepareLanXSetLocoDriveAndTransmit(uint16_t Speed)
+{
+    Z21Slave::locInfo LocInfoTx;
+
+    WmcLocDriveSet(&LocInfoTx, Speed);
+    WmcLocDriveTransmit(&LocInfoTx);
+
+    /* Administration of the speed pipeline. */
+    if (m_SpeedTxPending == true)
+    {
+        m_SpeedStatistics.LatencyLast = micros() - m_SpeedDeltaTime;
+        if (m_SpeedStatistics.LatencyLast > m_SpeedStatistics.LatencyMax)
+        {
+            m_SpeedStatistics.LatencyMax = m_SpeedStatistics.LatencyLast;
+        }
+    }
+
+    m_SpeedStatistics.Commands++;
+    m_SpeedTxPending = false;
+    m_SpeedInFlight  = true;
+    m_SpeedTxSent    = Speed;
+    m_SpeedTxTime    = millis();
+}
+
+/***********************************************************************************************************************
+ * Compose a drive command with the speed for the selected loc.
+ */
+void wmcApp::WmcLocDriveSet(Z21Slave::locInfo* LocInfoPtr, uint16_t Speed)
+{
+    /* Get loc data and compose it for transmit */
+    LocInfoPtr->Speed = Speed;
+    if (m_locLib.DirectionGet() == directionForward)
+    {
+        LocInfoPtr->Direction = Z21Slave::locDirectionForward;
+    }
+    else
+    {
+        LocInfoPtr->Direction = Z21Slave::locDirectionBackward;
+    }
+
+    LocInfoPtr->Address = m_locLib.GetActualLocAddress();
+
+    switch (m_locLib.DecoderStepsGet())
+    {
+    case decoderStep14: LocInfoPtr->Steps = Z21Slave::locDecoderSpeedSteps14; break;
+    case decoderStep28: LocInfoPtr->Steps = Z21Slave::locDecoderSpeedSteps28; break;
+    case decoderStep128: LocInfoPtr->Steps = Z21Slave::locDecoderSpeedSteps128; break;
+    }
+}
+
+/***********************************************************************************************************************
+ * Transmit a drive command. The members of a consist led by the loc get the same command in the same datagram, with
+ * their own direction and the speed scaled to the speed steps known of them.
+ */
+void wmcApp::WmcLocDriveTransmit(Z21Slave::locInfo* LocInfoPtr)
+{
+    Z21Slave::locInfo MemberInfo;
+    Z21Slave::locInfo* CachePtr;
+    wmcConsist::member Member;
+    uint8_t Index = 0;
+
+    WmcLocDriveCommand(LocInfoPtr);
+
+    while (m_Consist.MemberGet(LocInfoPtr->Address, Index, Member) == true)
+    {
+        memcpy(&MemberInfo, LocInfoPtr, sizeof(Z21Slave::locInfo));
+        MemberInfo.Address = Member.Address;
+
+        if (Member.Flip == true)
+        {
+            if (LocInfoPtr->Direction == Z21Slave::locDirectionForward)
+            {
+                MemberInfo.Direction = Z21Slave::locDirectionBackward;
+            }
+            else
+            {
+                MemberInfo.Direction = Z21Slave::locDirectionForward;
+            }
+        }
+
+        CachePtr = m_locCache.Get(Member.Address);
+        if ((CachePtr != NULL) && (CachePtr->Steps != Z21Slave::locDecoderSpeedStepsUnknown))
+        {
+            MemberInfo.Steps = CachePtr->Steps;
+            MemberInfo.Speed = WmcSpeedScale(LocInfoPtr->Speed, LocInfoPtr->Steps, CachePtr->Steps);
+        }
+
+        /* The lead loc is leading, a ramp of the member itself is ended. */
+        m_SpeedRamp.Stop(Member.Address);
+        WmcLocDriveCommand(&MemberInfo);
+        Index++;
+    }
+
+    m_Consist.DriveCount(Index);
+}
+
+/***********************************************************************************************************************
+ * Scale a speed to another speed step mode, rounded to the nearest step. A moving loc never scales to a stop.
+ */
+uint8_t wmcApp::WmcSpeedScale(uint8_t Speed, Z21Slave::locDecoderSpeedSteps From, Z21Slave::locDecoderSpeedSteps To)
+{
+    /* Highest speed, indexed by the speed steps. */
+    static const uint16_t SpeedMax[] = { 14, 28, 126 };
+    uint16_t Result                  = Speed;
+
+    if ((Speed > 0) && (From != To) && (From != Z21Slave::locDecoderSpeedStepsUnknown)
+        && (To != Z21Slave::locDecoderSpeedStepsUnknown))
+    {
+        Result = ((Speed * SpeedMax[To]) + (SpeedMax[From] / 2)) / SpeedMax[From];
+        Result = (Result == 0) ? 1 : ((Result > SpeedMax[To]) ? SpeedMax[To] : Result);
+    }
+
+    return (static_cast<uint8_t>(Result));
+}
+
+/***********************************************************************************************************************
+ * Queue a drive command and track a stop until confirmed.
+ */
+void wmcApp::WmcLocDriveCommand(Z21Slave::locInfo* LocInfoPtr)
+{
+    m_z21Slave.LanXSetLocoDrive(LocInfoPtr);
+    WmcCheckForDataTx();
+
+    /* A stop must reach the loc, a newer speed makes a pending stop obsolete. */
+    if (LocInfoPtr->Speed == 0)
+    {
+        m_wmcAck.Track(wmcAck::locStop, LocInfoPtr);
+    }
+    else
+    {
+        m_wmcAck.Cancel(wmcAck::locStop, LocInfoPtr->Address);
+    }
+}
+
+/***********************************************************************************************************************
+ * Transmit the latest requested speed when one is pending and the minimum interval since the previous drive command
+ * has passed. Intermediate speeds requested within the interval are never transmitted.
+ */
+void wmcApp::WmcSpeedTransmit(void)
+{
+    if ((m_SpeedTxPending == true) && ((millis() - m_SpeedTxTime) >= SPEED_TX_INTERVAL))
+    {
+        WmcSpeedRequest();
+    }
+}
+
+/***********************************************************************************************************************
+ * Request the speed and direction of the selected loc, through its speed ramp when the loc has ramp rates and else
+ * by a direct drive command.
+ */
+void wmcApp::WmcSpeedRequest(void)
+{
+    Z21Slave::locInfo LocInfoTx;
+
+    WmcLocDriveSet(&LocInfoTx, m_locLib.SpeedGet());
+    if (m_SpeedRamp.Target(LocInfoTx, m_locCache.Get(LocInfoTx.Address)) == true)
+    {
+        m_SpeedTxPending = false;
+        if (m_Timer.Active(wmcTimer::speedRamp) == false)
+        {
+            m_Timer.Start(wmcTimer::speedRamp, 0);
+        }
+    }
+    else
+    {
+        PrepareLanXSetLocoDriveAndTransmit(LocInfoTx.Speed);
+    }
+}
+
+/***********************************************************************************************************************
+ * Move the speed ramps and transmit the drive commands of changed speed steps, at most one per loc per interval.
+ */
+void wmcApp::WmcSpeedRampUpdate(void)
+{
+    Z21Slave::locInfo LocInfoTx;
+
+    m_SpeedRamp.Update();
+    while (m_SpeedRamp.TransmitGet(LocInfoTx) == true)
+    {
+        WmcLocDriveTransmit(&LocInfoTx);
+
+        /* Ramp commands of the selected loc are echoed like direct drive commands. */
+        if (LocInfoTx.Address == m_locLib.GetActualLocAddress())
+        {
+            m_SpeedInFlight = true;
+            m_SpeedTxSent   = LocInfoTx.Speed;
+            m_SpeedTxTime   = millis();
+        }
+    }
+
+    if (m_SpeedRamp.Active() == true)
+    {
+        m_Timer.Start(wmcTimer::speedRamp, SPEED_RAMP_INTERVAL);
+    }
+}
+
+/***********************************************************************************************************************
+ * Transmit a function of the selected loc, when the consist of the loc applies functions to all members the members
+ * get the resulting function status.
+ */
+void wmcApp::WmcLocFunctionTransmit(uint8_t Function, Z21Slave::function Mode)
+{
+    wmcConsist::member Member;
+    uint8_t Index             = 0;
+    uint16_t Address          = m_locLib.GetActualLocAddress();
+    Z21Slave::function Status = Z21Slave::off;
+
+    m_z21Slave.LanXSetLocoFunction(Address, Function, Mode);
+    WmcCheckForDataTx();
+
+    if (m_Consist.FunctionsAll(Address) == true)
+    {
+        if (m_locLib.FunctionStatusGet(Function) == LocLib::functionOn)
+        {
+            Status = Z21Slave::on;
+        }
+
+        while (m_Consist.MemberGet(Address, Index, Member) == true)
+        {
+            m_z21Slave.LanXSetLocoFunction(Member.Address, Function, Status);
+            WmcCheckForDataTx();
+            Index++;
+        }
+
+        m_Consist.FunctionCount(Index);
+    }
+}
+
+/***********************************************************************************************************************
+ * Check whether all locs of the loc database transmit are received back from the control.
+ */
+bool wmcApp::WmcLocDbEchoedAll(void)
+{
+    bool Result   = true;
+    uint8_t Index = 0;
+
+    while ((Result == true) && (Index < m_locLib.GetNumberOfLocs()))
+    {
+        Result = ((m_locDbDataEchoed[Index / 8] & (1 << (Index % 8))) != 0);
+        Index++;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Get the consist statistics.
+ */
+const wmcConsist::statistics& wmcApp::ConsistStatisticsGet(void) { return (m_Consist.StatisticsGet()); }
+
+/***********************************************************************************************************************
+ * Add a member with its running direction to the consist of a lead loc. The loc info of the member is requested so
+ * the control reports it, which confirms stops and provides the speed steps of the member.
+ */
+bool wmcApp::ConsistMemberAdd(uint16_t Lead, uint16_t Address, bool Flip)
+{
+    bool Result = m_Consist.MemberAdd(Lead, Address, Flip);
+
+    if (Result == true)
+    {
+        WmcConsistStore();
+        m_z21Slave.LanXGetLocoInfo(Address);
+        WmcCheckForDataTx();
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Remove a member from the consist of a lead loc.
+ */
+void wmcApp::ConsistMemberRemove(uint16_t Lead, uint16_t Address)
+{
+    m_Consist.MemberRemove(Lead, Address);
+    WmcConsistStore();
+}
+
+/***********************************************************************************************************************
+ * Set whether the functions of a lead loc are applied to all members of its consist.
+ */
+void wmcApp::ConsistFunctionsAllSet(uint16_t Lead, bool FunctionsAll)
+{
+    m_Consist.FunctionsAllSet(Lead, FunctionsAll);
+    WmcConsistStore();
+}
+
+/***********************************************************************************************************************
+ * Show the member address and its running direction in the consist screen, green when it is a member of the consist
+ * of the selected loc. F marks a consist applying the functions to all members.
+ */
+void wmcApp::WmcConsistShow(void)
+{
+    wmcConsist::member Member;
+    WmcTft::color Color = WmcTft::color_white;
+    char Text[24];
+
+    if (WmcConsistMemberFind(m_ConsistMemberAddress, Member) == true)
+    {
+        Color = WmcTft::color_green;
+    }
+
+    snprintf(Text, sizeof(Text), "MEMBER %u %s%s", m_ConsistMemberAddress,
+        (m_ConsistMemberFlip == true) ? "REV" : "FWD",
+        (m_Consist.FunctionsAll(m_locLib.GetActualLocAddress()) == true) ? " F" : "");
+    m_wmcTft.UpdateStatus(Text, true, Color);
+}
+
+/***********************************************************************************************************************
+ * Find a member in the consist of the selected loc.
+ */
+bool wmcApp::WmcConsistMemberFind(uint16_t Address, wmcConsist::member& Member)
+{
+    bool Result   = false;
+    uint8_t Index = 0;
+
+    while ((Result == false) && (m_Consist.MemberGet(m_locLib.GetActualLocAddress(), Index, Member) == true))
+    {
+        Result = (Member.Address == Address);
+        Index++;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Request the loc info of the members of the consist of the selected loc not yet known, so the drive commands of the
+ * members use their own speed steps.
+ */
+void wmcApp::WmcConsistInfoGet(void)
+{
+    wmcConsist::member Member;
+    Z21Slave::locInfo* CachePtr;
+    uint8_t Index = 0;
+
+    while (m_Consist.MemberGet(m_locLib.GetActualLocAddress(), Index, Member) == true)
+    {
+        CachePtr = m_locCache.Get(Member.Address);
+        if ((CachePtr == NULL) || (CachePtr->Steps == Z21Slave::locDecoderSpeedStepsUnknown))
+        {
+            m_z21Slave.LanXGetLocoInfo(Member.Address);
+            WmcCheckForDataTx();
+        }
+        Index++;
+    }
+}
+
+/***********************************************************************************************************************
+ * Load the consists.
+ */
+void wmcApp::WmcConsistLoad(void)
+{
+    EepCfg::consist Consists;
+    uint8_t Index;
+    uint8_t Member;
+
+    EEPROM.get(EepCfg::ConsistAddress, Consists);
+    if (Consists.Valid == 1)
+    {
+        for (Index = 0; Index < EepCfg::ConsistEntries; Index++)
+        {
+            for (Member = 0; (Member < Consists.Entry[Index].Members) && (Member < EepCfg::ConsistMembers); Member++)
+            {
+                m_Consist.MemberAdd(Consists.Entry[Index].Lead, Consists.Entry[Index].Member[Member].Address,
+                    (Consists.Entry[Index].Member[Member].Flip == 1));
+            }
+
+            m_Consist.FunctionsAllSet(Consists.Entry[Index].Lead, (Consists.Entry[Index].FunctionsAll == 1));
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ * Store the consists.
+ */
+void wmcApp::WmcConsistStore(void)
+{
+    EepCfg::consist Consists;
+    wmcConsist::member Member;
+    uint16_t Lead;
+    uint8_t Index;
+    uint8_t Members;
+
+    static_assert(wmcConsist::CONSIST_ENTRIES <= EepCfg::ConsistEntries, "Not all consists stored");
+    static_assert(wmcConsist::CONSIST_MEMBERS_MAX <= EepCfg::ConsistMembers, "Not all consist members stored");
+
+    memset(&Consists, 0, sizeof(Consists));
+    Consists.Valid = 1;
+
+    for (Index = 0; Index < EepCfg::ConsistEntries; Index++)
+    {
+        Lead    = m_Consist.LeadGet(Index);
+        Members = 0;
+
+        if (Lead != 0)
+        {
+            Consists.Entry[Index].Lead         = Lead;
+            Consists.Entry[Index].FunctionsAll = (m_Consist.FunctionsAll(Lead) == true) ? 1 : 0;
+
+            while (m_Consist.MemberGet(Lead, Members, Member) == true)
+            {
+                Consists.Entry[Index].Member[Members].Address = Member.Address;
+                Consists.Entry[Index].Member[Members].Flip    = (Member.Flip == true) ? 1 : 0;
+                Members++;
+            }
+        }
+
+        Consists.Entry[Index].Members = Members;
+    }
+
+    m_wmcEep.Put(EepCfg::ConsistAddress, Consists);
+    m_wmcEep.Commit();
+}
+
+/***********************************************************************************************************************
+ * Get the speed ramp statistics.
+ */
+const wmcSpeedRamp::statistics& wmcApp::SpeedRampStatisticsGet(void) { return (m_SpeedRamp.StatisticsGet()); }
+
+/***********************************************************************************************************************
+ * Set the acceleration and braking rate of a loc in speed steps per second as 8.8 fixed point, 0 for no ramp. The
+ * rates of all locs are stored.
+ */
+bool wmcApp::SpeedRampConfigSet(uint16_t Address, uint16_t Accelerate, uint16_t Brake)
+{
+    wmcSpeedRamp::config Config;
+    bool Result;
+
+    Config.Accelerate = Accelerate;
+    Config.Brake      = Brake;
+
+    Result = m_SpeedRamp.ConfigSet(Address, Config);
+    if (Result == true)
+    {
+        WmcSpeedRampStore();
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Show the rate being changed in the speed ramp menu.
+ */
+void wmcApp::WmcSpeedRampShow(void)
+{
+    char Text[24];
+
+    if (m_SpeedRampEditBrake == true)
+    {
+        snprintf(Text, sizeof(Text), "BRAKE %u/S", m_SpeedRampEdit.Brake / wmcSpeedRamp::SPEED_RAMP_ONE);
+    }
+    else
+    {
+        snprintf(Text, sizeof(Text), "ACCELERATE %u/S", m_SpeedRampEdit.Accelerate / wmcSpeedRamp::SPEED_RAMP_ONE);
+    }
+
+    m_wmcTft.UpdateStatus(Text, true, WmcTft::color_green);
+}
+
+/***********************************************************************************************************************
+ * Load the speed ramp rates of the locs.
+ */
+void wmcApp::WmcSpeedRampLoad(void)
+{
+    EepCfg::speedRamp Ramps;
+    wmcSpeedRamp::config Config;
+    uint8_t Index;
+
+    EEPROM.get(EepCfg::SpeedRampAddress, Ramps);
+    if (Ramps.Valid == 1)
+    {
+        for (Index = 0; Index < EepCfg::SpeedRampLocs; Index++)
+        {
+            if (Ramps.Loc[Index].Address != 0)
+            {
+                Config.Accelerate = Ramps.Loc[Index].Accelerate;
+                Config.Brake      = Ramps.Loc[Index].Brake;
+                m_SpeedRamp.ConfigSet(Ramps.Loc[Index].Address, Config);
+            }
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ * Store the speed ramp rates of all locs.
+ */
+void wmcApp::WmcSpeedRampStore(void)
+{
+    EepCfg::speedRamp Ramps;
+    wmcSpeedRamp::config Config;
+    uint16_t Address;
+    uint8_t Index;
+
+    static_assert(wmcSpeedRamp::SPEED_RAMP_ENTRIES <= EepCfg::SpeedRampLocs, "Not all speed ramp rates stored");
+
+    memset(&Ramps, 0, sizeof(Ramps));
+    Ramps.Valid = 1;
+
+    for (Index = 0; Index < EepCfg::SpeedRampLocs; Index++)
+    {
+        if (m_SpeedRamp.ConfigIndexGet(Index, Address, Config) == true)
+        {
+            Ramps.Loc[Index].Address    = Address;
+            Ramps.Loc[Index].Accelerate = Config.Accelerate;
+            Ramps.Loc[Index].Brake      = Config.Brake;
+        }
+    }
+
+    m_wmcEep.Put(EepCfg::SpeedRampAddress, Ramps);
+    m_wmcEep.Commit();
+}
+
+/***********************************************************************************************************************
+ * Check whether a requested speed is not yet transmitted or not yet confirmed by the control.
+ */
+bool wmcApp::WmcSpeedUnconfirmed(void)
+{
+    bool Result = false;
+
+    if (m_SpeedTxPending == true)
+    {
+        Result = true;
+    }
+    else if ((m_SpeedInFlight == true) && ((millis() - m_SpeedTxTime) < SPEED_ECHO_TIMEOUT))
+    {
+        Result = true;
+    }
+    else if (m_SpeedRamp.Active(m_locLib.GetActualLocAddress()) == true)
+    {
+        Result = true;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Check received loc info against the transmitted drive command. Returns true when the received speed and direction
+ * may be taken over, false when the data is older than the locally requested speed.
+ */
+bool wmcApp::WmcSpeedEchoAccept(Z21Slave::locInfo* LocInfoPtr)
+{
+    bool Result = true;
+    Z21Slave::locInfo LocInfoLocal;
+
+    if (LocInfoPtr->Address == m_locLib.GetActualLocAddress())
+    {
+        WmcSpeedLocalSet(&LocInfoLocal);
+
+        if ((m_SpeedTxPending == false) && (m_SpeedInFlight == true) && (LocInfoPtr->Speed == m_SpeedTxSent)
+            && (LocInfoPtr->Direction == LocInfoLocal.Direction))
+        {
+            /* Echo of the transmitted command, while ramping the requested speed stays leading. */
+            m_SpeedInFlight = false;
+            Result          = (m_SpeedRamp.Active(LocInfoPtr->Address) == false);
+        }
+        else if (WmcSpeedUnconfirmed() == true)
+        {
+            m_SpeedStatistics.StaleEchoes++;
+            Result = false;
+        }
+        else
+        {
+            /* No confirmation within timeout, the control is leading. */
+            m_SpeedInFlight = false;
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Fill speed and direction with the locally requested values.
+ */
+void wmcApp::WmcSpeedLocalSet(Z21Slave::locInfo* LocInfoPtr)
+{
+    LocInfoPtr->Speed = m_locLib.SpeedGet();
+    if (m_locLib.DirectionGet() == directionForward)
+    {
+        LocInfoPtr->Direction = Z21Slave::locDirectionForward;
+    }
+    else
+    {
+        LocInfoPtr->Direction = Z21Slave::locDirectionBackward;
+    }
+}
+
+/***********************************************************************************************************************
+ * Show the locally requested speed and direction without waiting for the control.
+ */
+void wmcApp::updateSpeedOnScreen(void)
+{
+    Z21Slave::locInfo locInfoShow;
+    WmcTft::locoInfo locInfoActual;
+    WmcTft::locoInfo locInfoPrevious;
+
+    memcpy(&locInfoShow, &m_WmcLocInfoControl, sizeof(Z21Slave::locInfo));
+    WmcSpeedLocalSet(&locInfoShow);
+
+    convertLocDataToDisplayData(&locInfoShow, &locInfoActual);
+    convertLocDataToDisplayData(&m_WmcLocInfoControl, &locInfoPrevious);
+    m_wmcTft.UpdateLocInfo(&locInfoActual, &locInfoPrevious, m_locFunctionAssignment, m_locLib.GetLocName(), false);
+
+    memcpy(&m_WmcLocInfoControl, &locInfoShow, sizeof(Z21Slave::locInfo));
 }
@@ -15,7 +15,20 @@
 #include "WmcCli.h"
 #include "WmcTft.h"
 #include "Z21Slave.h"
+#include "eep_cfg.h"
+#include "wmc_ack.h"
+#include "wmc_adc_buttons.h"
+#include "wmc_boot_log.h"
+#include "wmc_consist.h"
+#include "wmc_eep.h"
 #include "wmc_event.h"
+#include "wmc_event_queue.h"
+#include "wmc_loc_cache.h"
+#include "wmc_loc_import.h"
+#include "wmc_loc_index.h"
+#include "wmc_pulse_accel.h"
+#include "wmc_speed_ramp.h"
+#include "wmc_timer.h"
 #include <ESP8266WiFi.h>
 #include <WiFiUdp.h>
 #include <tinyfsm.hpp>
@@ -43,6 +56,10 @@ public:
     virtual void react(updateEvent50msec const&);
     virtual void react(updateEvent100msec const&);
     virtual void react(updateEvent500msec const&);
+    virtual void react(z21DataEvent const&);
+    virtual void react(linkLostEvent const&);
+    virtual void react(powerButtonEvent const&);
+    virtual void react(timerEvent const&);
 
     virtual void entry(void){}; /* entry actions in some states */
     virtual void exit(void){};  /* no exit actions at all */
@@ -54,54 +71,292 @@ public:
         emergency
     };
 
+    /**
+     * Statistics of the Z21 receive path.
+     */
+    struct rxStatistics
+    {
+        uint8_t PacketsTick;     /* Datagrams handled during the last tick. */
+        uint8_t PacketsTickMax;  /* Maximum number of datagrams handled during one tick. */
+        uint32_t Packets;        /* Total number of handled datagrams. */
+        uint32_t Records;        /* Total number of Z21 messages found in the datagrams. */
+        uint32_t Dropped;        /* Datagrams dropped because of invalid or truncated data. */
+        uint32_t BudgetExceeded; /* Number of ticks the receive budget ran out. */
+    };
+
+    /**
+     * Statistics of the Z21 transmit path.
+     */
+    struct txStatistics
+    {
+        uint8_t QueueDepth;          /* Number of messages waiting in the transmit queue. */
+        uint8_t QueueDepthMax;       /* Maximum number of messages waiting in the transmit queue. */
+        uint32_t Messages;           /* Total number of transmitted messages. */
+        uint32_t Datagrams;          /* Total number of transmitted datagrams. */
+        uint32_t Coalesced;          /* Messages transmitted in a datagram together with another message. */
+        uint32_t Overflow;           /* Number of times the queue was full and flushed before the end of the tick. */
+        uint16_t DatagramsPerMinute; /* Datagrams transmitted during the last complete minute. */
+        uint16_t MessagesPerMinute;  /* Messages transmitted during the last complete minute. */
+        uint32_t LocInfoPolls;       /* Loc info requests because no loc info was received. */
+        uint32_t Urgent;             /* Messages transmitted immediately, ahead of the queue. */
+    };
+
+    /**
+     * Statistics of the power button fast path.
+     */
+    struct powerButtonStatistics
+    {
+        uint32_t Presses;     /* Power button presses handled by the fast path. */
+        uint32_t LatencyLast; /* Time between queued press and transmit of the command in usec. */
+        uint32_t LatencyMax;  /* Maximum time between queued press and transmit of the command in usec. */
+    };
+
+    /**
+     * Statistics of the speed command pipeline.
+     */
+    struct speedStatistics
+    {
+        uint32_t Deltas;      /* Pulse switch deltas applied to the requested speed. */
+        uint32_t Superseded;  /* Deltas merged into a drive command not yet transmitted. */
+        uint32_t Dropped;     /* Deltas which could not be applied to the speed. */
+        uint32_t Commands;    /* Transmitted drive commands. */
+        uint32_t StaleEchoes; /* Received loc info older than the requested speed. */
+        uint32_t LatencyLast; /* Time between first delta and transmit of last drive command in usec. */
+        uint32_t LatencyMax;  /* Maximum time between first delta and transmit of a drive command in usec. */
+    };
+
+    /**
+     * Statistics of the loc selection.
+     */
+    struct locSelectStatistics
+    {
+        uint32_t Changes;    /* Loc selection changes by the pulse switch. */
+        uint32_t Requests;   /* Loc info requests after a stable selection. */
+        uint32_t Suppressed; /* Selection changes for which no loc info request was done. */
+    };
+
+    /**
+     * Screen to return to after a lost connection is resumed.
+     */
+    enum resumeMode
+    {
+        resumeLoc = 0,   /* Loc screen still shown. */
+        resumeLocRedraw, /* Loc screen must be drawn again. */
+        resumeTurnout    /* Turnout screen still shown. */
+    };
+
+    /**
+     * Statistics of the connection with the control unit.
+     */
+    struct linkStatistics
+    {
+        uint32_t Probes;           /* Status requests because no data was received for a while. */
+        uint32_t Losses;           /* Number of times the connection was lost. */
+        uint32_t RecoveryTimeLast; /* Time between last data before a loss and resume in msec. */
+        uint32_t RecoveryTimeMax;  /* Maximum time between last data before a loss and resume in msec. */
+    };
+
+    /**
+     * Statistics of the configuration record.
+     */
+    struct configStatistics
+    {
+        uint32_t LoadTime;     /* Time needed to read and check the configuration record in usec. */
+        uint8_t VersionErrors; /* Boots with a configuration record of another EEPROM version. */
+        uint8_t CrcErrors;     /* Boots with a configuration record not matching its CRC. */
+        uint8_t Restores;      /* CRC errors repaired with the last known good configuration record. */
+        uint8_t Defaults;      /* CRC errors without a valid copy, the configuration was set to defaults. */
+        uint8_t Stores;        /* Number of times the configuration record was stored. */
+        uint8_t Seals;         /* Settings written by the CLI or LocStorage taken over and sealed with a new CRC. */
+    };
+
+    static const configStatistics& ConfigStatisticsGet(void);
+    static const wmcBootLog::boot* BootLogGet(uint8_t Index);
+    static const wmcAck::statistics& AckStatisticsGet(void);
+    static const wmcAdcButtons::statistics& ButtonStatisticsGet(void);
+    static const linkStatistics& LinkStatisticsGet(void);
+    static const rxStatistics& RxStatisticsGet(void);
+    static const locSelectStatistics& LocSelectStatisticsGet(void);
+    static const wmcLocCache::statistics& LocCacheStatisticsGet(void);
+    static const wmcEep::statistics& EepStatisticsGet(void);
+    static const txStatistics& TxStatisticsGet(void);
+    static const powerButtonStatistics& PowerButtonStatisticsGet(void);
+    static const speedStatistics& SpeedStatisticsGet(void);
+    static const wmcTimer::statistics& TimerStatisticsGet(void);
+    static const wmcEventQueue::statistics& EventQueueStatisticsGet(void);
+    static const wmcPulseAccel::statistics& PulseAccelStatisticsGet(void);
+    static void PulseAccelProfileSet(wmcPulseAccel::profile Id, const wmcPulseAccel::config& Config);
+    static const wmcSpeedRamp::statistics& SpeedRampStatisticsGet(void);
+    static bool SpeedRampConfigSet(uint16_t Address, uint16_t Accelerate, uint16_t Brake);
+    static const wmcConsist::statistics& ConsistStatisticsGet(void);
+    static bool ConsistMemberAdd(uint16_t Lead, uint16_t Address, bool Flip);
+    static void ConsistMemberRemove(uint16_t Lead, uint16_t Address);
+    static void ConsistFunctionsAllSet(uint16_t Lead, bool FunctionsAll);
+
+    /**
+     * Queue of input events, filled by the pulse switch and button interrupts. Inline so it is usable from an
+     * interrupt.
+     */
+    static wmcEventQueue& EventQueueGet(void) { return (m_EventQueue); }
+
+    static void WmcTxFlush(void);
+
 protected:
-    Z21Slave::dataType WmcCheckForDataRx(void);
-    void WmcCheckForDataTx(void);
+    void WmcCheckForDataRx(void);
+    void WmcProcessDatagram(uint16_t Length);
+    void WmcLinkMonitorStart(void);
+    void WmcLinkCheck(void);
+    void WmcHandshakeTransmit(void);
+    void WmcTrackPowerOn(void);
+    void WmcTrackPowerOff(bool Stop);
+    void WmcPowerButtonFast(bool Stop);
+    void WmcAckCheck(void);
+    void WmcButtonSample(void);
+    void WmcTimerCheck(void);
+    void WmcEventQueueCheck(void);
+    static uint16_t WmcDataLengthGet(const uint8_t* DataPtr);
+    static void WmcCheckForDataTx(void);
+    void WmcCheckForDataTxUrgent(void);
+    static void WmcTxDatagram(uint8_t* DataTransmitPtr, uint16_t DataTransmitLength);
+    static void WmcTxDebug(uint8_t* DataTransmitPtr, uint16_t DataTransmitLength);
     void convertLocDataToDisplayData(Z21Slave::locInfo* Z21DataPtr, WmcTft::locoInfo* TftDataPtr);
     bool updateLocInfoOnScreen(bool updateAll);
+    bool updateLocInfoOnScreen(Z21Slave::locInfo* LocInfoPtr, bool updateAll);
+    void WmcLocInfoFromCache(void);
+    void WmcLocSelectChanged(void);
+    void WmcLocSelectStable(void);
+    bool WmcLocPresent(uint16_t Address);
+    void WmcLocAdd(uint16_t Address, uint8_t* FunctionPtr, char* NamePtr, LocLib::action Action, bool Sort);
+    void WmcLocImportCommit(void);
+    bool WmcLocDbEchoedAll(void);
     void PrepareLanXSetLocoDriveAndTransmit(uint16_t Speed);
+    void WmcSpeedTransmit(void);
+    void WmcSpeedRequest(void);
+    void WmcSpeedRampUpdate(void);
+    void WmcSpeedRampShow(void);
+    static void WmcSpeedRampLoad(void);
+    static void WmcSpeedRampStore(void);
+    void WmcConsistShow(void);
+    bool WmcConsistMemberFind(uint16_t Address, wmcConsist::member& Member);
+    void WmcConsistInfoGet(void);
+    static void WmcConsistLoad(void);
+    static void WmcConsistStore(void);
+    void WmcLocDriveSet(Z21Slave::locInfo* LocInfoPtr, uint16_t Speed);
+    void WmcLocDriveTransmit(Z21Slave::locInfo* LocInfoPtr);
+    void WmcLocDriveCommand(Z21Slave::locInfo* LocInfoPtr);
+    static uint8_t WmcSpeedScale(uint8_t Speed, Z21Slave::locDecoderSpeedSteps From, Z21Slave::locDecoderSpeedSteps To);
+    void WmcLocFunctionTransmit(uint8_t Function, Z21Slave::function Mode);
+    bool WmcSpeedUnconfirmed(void);
+    bool WmcSpeedEchoAccept(Z21Slave::locInfo* LocInfoPtr);
+    void WmcSpeedLocalSet(Z21Slave::locInfo* LocInfoPtr);
+    void updateSpeedOnScreen(void);
+    void WmcLocInfoHeard(Z21Slave::locInfo* LocInfoPtr);
+    void WmcLocInfoPoll(void);
+    void WmcConfigLoad(void);
+    void WmcWifiStart(void);
+    void WmcWifiBegin(void);
+    void WmcWifiFallback(void);
+    void WmcWifiLeaseDrop(void);
+    void WmcWifiCacheStore(void);
+    void WmcConfigStore(void);
+    void WmcConfigSync(void);
+    static bool WmcConfigCrcValid(const EepCfg::config& Config);
+    static uint16_t WmcConfigCrc(const EepCfg::config& Config);
 
-    static const uint8_t CONNECT_CNT_MAX_FAIL_CONNECT_WIFI = 200;
     static const uint8_t CONNECT_CNT_MAX_FAIL_CONNECT_UDP  = 40;
+    static const uint8_t CONNECT_CNT_LEASE_CONFLICT        = 4;
     static const uint16_t ADDRESS_TURNOUT_MIN              = 1;
     static const uint16_t ADDRESS_TURNOUT_MAX              = 9999;
+    static const uint16_t ADDRESS_LOC_MIN                  = 1;
+    static const uint16_t ADDRESS_LOC_MAX                  = 9999;
+    static const int8_t SPEED_DELTA_MAX                    = 127;
     static const uint8_t FUNCTION_MIN                      = 0;
     static const uint8_t FUNCTION_MAX                      = 28;
     static const uint8_t ADC_VALUES_ARRAY_SIZE             = 7;
     static const uint8_t ADC_VALUES_ARRAY_REFERENCE_INDEX  = 6;
+    static const uint8_t RX_PACKETS_PER_TICK_MAX           = 16;
+    static const uint32_t RX_TIME_PER_TICK_MAX             = 4000; /* usec */
+    static const uint16_t RX_PACKET_BUFFER_SIZE            = 1472; /* UDP payload of a 1500 byte MTU. */
+    static const uint16_t Z21_RECORD_HEADER_SIZE           = 4;    /* Data length and header field. */
+    static const uint16_t TX_DATAGRAM_SIZE_MAX             = 1472; /* UDP payload of a 1500 byte MTU. */
+    static const uint8_t TX_QUEUE_SIZE                     = 16;
+    static const uint8_t TX_MESSAGE_SIZE_MAX               = 48;
+    static const uint8_t HANDSHAKE_STATUS                  = 0x01; /* Status reply pending. */
+    static const uint8_t HANDSHAKE_LOC_INFO                = 0x02; /* Loc info reply pending. */
 
     static WmcTft m_wmcTft;
     static LocLib m_locLib;
     static WiFiUDP m_WifiUdp;
     static WmcCli m_WmcCommandLine;
     static LocStorage m_LocStorage;
+    static wmcEep m_wmcEep;
+    static wmcBootLog m_BootLog;
+    static wmcAck m_wmcAck;
+    static wmcAdcButtons m_AdcButtons;
+    static wmcTimer m_Timer;
+    static wmcEventQueue m_EventQueue;
+    static wmcPulseAccel m_PulseAccel;
+    static wmcSpeedRamp m_SpeedRamp;
+    static wmcConsist m_Consist;
+    static wmcLocCache m_locCache;
+    static wmcLocIndex m_locIndex;
+    static wmcLocImport m_locImport;
     static wmcApp::powerState m_TrackPower;
     static Z21Slave m_z21Slave;
     static bool m_locSelection;
     static uint16_t m_ConnectCnt;
-    static uint8_t m_IpAddresZ21[4];
-    static uint8_t m_IpAddresWmc[4];
-    static uint8_t m_IpGateway[4];
-    static uint8_t m_IpSubnet[4];
+    static uint8_t m_HandshakePending;
+    static bool m_LinkMonitorActive;
+    static uint32_t m_RxLastTime;
+    static uint32_t m_LinkProbeTime;
+    static uint32_t m_LinkLostTime;
+    static resumeMode m_ResumeMode;
+    static Z21Slave::dataType m_ResumeStatus;
+    static linkStatistics m_LinkStatistics;
+    static EepCfg::config m_Config;
+    static bool m_ConfigValid;
+    static bool m_WifiStarted;
+    static bool m_WifiFastConnect;
+    static bool m_WifiLeaseReuse;
+    static uint32_t m_WifiStartTime;
+    static uint32_t m_WifiPollInterval;
+    static configStatistics m_ConfigStatistics;
     static uint16_t m_UdpLocalPort;
     static uint16_t m_locAddressAdd;
     static uint16_t m_TurnOutAddress;
     static Z21Slave::turnout m_TurnOutDirection;
-    static uint32_t m_TurnoutOffDelay;
     static uint16_t m_locAddressChange;
     static uint16_t m_locDbDataTransmitCnt;
     static uint32_t m_locDbDataTransmitCntRepeat;
+    static uint32_t m_locDbDataProgressTime;
+    static uint8_t m_locDbDataEchoed[32];
     static uint16_t m_locAddressDelete;
-    static byte m_WmcPacketBuffer[40];
+    static wmcSpeedRamp::config m_SpeedRampEdit;
+    static bool m_SpeedRampEditBrake;
+    static uint16_t m_ConsistMemberAddress;
+    static bool m_ConsistMemberFlip;
+    static byte m_WmcPacketBuffer[RX_PACKET_BUFFER_SIZE];
+    static int m_RxPacketPending;
     static uint8_t m_locFunctionAdd;
     static uint8_t m_locFunctionChange;
     static uint8_t m_locFunctionAssignment[5];
     static Z21Slave::locInfo m_WmcLocInfoControl;
     static Z21Slave::locInfo* m_WmcLocInfoReceived;
     static Z21Slave::locLibData* m_WmcLocLibInfo;
-    static bool m_ButtonPrevious;
-    static uint8_t m_ButtonIndexPrevious;
-    static bool m_WmcLocSpeedRequestPending;
+    static bool m_SpeedTxPending;
+    static bool m_SpeedInFlight;
+    static uint16_t m_SpeedTxSent;
+    static uint32_t m_SpeedTxTime;
+    static uint32_t m_SpeedDeltaTime;
+    static speedStatistics m_SpeedStatistics;
+    static bool m_LocInfoPollPending;
+    static uint32_t m_LocInfoRxTime;
+    static uint32_t m_LocInfoPollTimeout;
+    static uint32_t m_TxMinuteStart;
+    static bool m_LocSelectPending;
+    static locSelectStatistics m_LocSelectStatistics;
+    static uint16_t m_TxMinuteDatagrams;
+    static uint16_t m_TxMinuteMessages;
     static bool m_CvPomProgramming;
     static bool m_CvPomProgrammingFromPowerOn;
     static bool m_EmergencyStopEnabled;
@@ -109,10 +364,39 @@ protected:
     static uint16_t m_AdcButtonValue[ADC_VALUES_ARRAY_SIZE];
     static uint16_t m_AdcButtonValuePrevious;
     static uint8_t m_AdcIndex;
+    static uint32_t m_PowerButtonPressTime;
+    static bool m_PowerButtonQueued;
 
-    static pushButtonsEvent m_wmcPushButtonEvent;
+    static rxStatistics m_RxStatistics;
+    static txStatistics m_TxStatistics;
+    static powerButtonStatistics m_PowerButtonStatistics;
+    static uint8_t m_TxQueue[TX_QUEUE_SIZE][TX_MESSAGE_SIZE_MAX];
+    static uint8_t m_TxQueueHead;
 
-    static const uint32_t LOC_DATABASE_TX_DELAY = 200;
+    static const uint32_t LOC_DATABASE_TX_DELAY       = 200;
+    static const uint8_t LOC_DB_TX_WINDOW             = 4;      /* Locs transmitted each pacing interval. */
+    static const uint32_t LOC_DB_TX_INTERVAL          = 50;     /* Pacing interval of loc data transmit in msec. */
+    static const uint8_t LOC_DB_TX_REPEAT_MAX         = 2;      /* Repeats of locs not received back, 0 is no repeat. */
+    static const uint32_t LOC_DB_TX_REPEAT_DELAY      = 300;    /* Delay before repeating locs in msec. */
+    static const uint32_t LOC_DB_TX_PROGRESS_INTERVAL = 250;    /* Minimum time between progress updates in msec. */
+    static const uint32_t SPEED_TX_INTERVAL           = 50;     /* Minimum time between drive commands in msec. */
+    static const uint32_t SPEED_ECHO_TIMEOUT          = 500;    /* Wait for drive command confirmation in msec. */
+    static const uint32_t LOC_INFO_POLL_TIMEOUT_MIN   = 2000;   /* Minimum time without loc info before polling. */
+    static const uint32_t LOC_INFO_POLL_TIMEOUT_MAX   = 16000;  /* Maximum time without loc info before polling. */
+    static const uint32_t LOC_SELECT_STABLE_TIME      = 300;    /* Time loc selection must be unchanged in msec. */
+    static const uint32_t LOC_IMPORT_TIMEOUT          = 2000;   /* Time without loc library data before storing. */
+    static const uint32_t WIFI_POLL_INTERVAL_MIN      = 50;     /* First wifi status poll interval in msec. */
+    static const uint32_t WIFI_POLL_INTERVAL_MAX      = 400;    /* Maximum wifi status poll interval in msec. */
+    static const uint32_t WIFI_FAST_CONNECT_TIMEOUT   = 1500;   /* Time for connect with cached data in msec. */
+    static const uint8_t WIFI_LEASE_USES_MAX          = 8;      /* Connects with a cached lease before DHCP again. */
+    static const uint32_t WIFI_CONNECT_TIMEOUT        = 100000; /* Time before wifi connect fails in msec. */
+    static const uint32_t WIFI_WHEEL_INTERVAL         = 500;    /* Running wheel update interval in msec. */
+    static const uint32_t LINK_PROBE_TIME             = 1000;   /* Time without data before probing in msec. */
+    static const uint32_t LINK_PROBE_INTERVAL         = 500;    /* Time between status probes in msec. */
+    static const uint32_t LINK_LOST_TIME              = 2500;   /* Time without data before connection is lost. */
+    static const uint32_t TURNOUT_OFF_DELAY           = 500;    /* Turnout output active time in msec. */
+    static const uint32_t SPEED_RAMP_INTERVAL         = 100;    /* Interval of speed ramp drive commands in msec. */
+    static const uint16_t SPEED_RAMP_RATE_MAX         = 100;    /* Maximum ramp rate in speed steps per second. */
 };
 
 #endif
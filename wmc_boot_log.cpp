@@ -0,0 +1,134 @@
+/***********************************************************************************************************************
+   @file   wmc_boot_log.cpp
+   @brief  Timestamps of the boot phases, kept for the last boots in RTC memory.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "wmc_boot_log.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   F O R W A R D  D E C L A R A T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+
+static const char* const BootLogPhaseName[wmcBootLog::phaseMax] = { "Init", "Config loaded", "Wifi start", "Local init",
+    "Wifi full scan", "Wifi associated", "UDP connect", "UDP reply", "Broadcast", "Status get", "Status received",
+    "Loc info get", "Loc info received", "Drivable" };
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+wmcBootLog::wmcBootLog() { memset(&m_Log, 0, sizeof(m_Log)); }
+
+/***********************************************************************************************************************
+ */
+void wmcBootLog::Init(void)
+{
+    uint32_t Number = 0;
+    uint8_t Index   = 0;
+
+    /* After power up the RTC memory contains random data. */
+    if ((ESP.rtcUserMemoryRead(BOOT_LOG_RTC_OFFSET, reinterpret_cast<uint32_t*>(&m_Log), sizeof(m_Log)) == false)
+        || (m_Log.Magic != BOOT_LOG_MAGIC) || (m_Log.Newest >= BOOT_LOG_SIZE))
+    {
+        memset(&m_Log, 0xFF, sizeof(m_Log));
+        m_Log.Magic  = BOOT_LOG_MAGIC;
+        m_Log.Newest = BOOT_LOG_SIZE - 1;
+    }
+    else
+    {
+        Number = m_Log.Boots[m_Log.Newest].Number + 1;
+    }
+
+    m_Log.Newest                     = (m_Log.Newest + 1) % BOOT_LOG_SIZE;
+    m_Log.Boots[m_Log.Newest].Number = Number;
+
+    for (Index = 0; Index < phaseMax; Index++)
+    {
+        m_Log.Boots[m_Log.Newest].Time[Index] = TIME_NOT_SET;
+    }
+
+    Mark(bootStart);
+}
+
+/***********************************************************************************************************************
+ */
+void wmcBootLog::Mark(phase Phase)
+{
+    if (m_Log.Boots[m_Log.Newest].Time[Phase] == TIME_NOT_SET)
+    {
+        m_Log.Boots[m_Log.Newest].Time[Phase] = millis();
+        Store();
+    }
+}
+
+/***********************************************************************************************************************
+ */
+const wmcBootLog::boot* wmcBootLog::Get(uint8_t Index)
+{
+    const boot* BootPtr = NULL;
+
+    if ((m_Log.Magic == BOOT_LOG_MAGIC) && (Index < BOOT_LOG_SIZE))
+    {
+        BootPtr = &m_Log.Boots[(m_Log.Newest + BOOT_LOG_SIZE - Index) % BOOT_LOG_SIZE];
+        if (BootPtr->Number == TIME_NOT_SET)
+        {
+            BootPtr = NULL;
+        }
+    }
+
+    return (BootPtr);
+}
+
+/***********************************************************************************************************************
+ */
+void wmcBootLog::Print(void)
+{
+    const boot* BootPtr;
+    uint32_t Previous;
+    uint32_t Delta;
+    uint8_t Index;
+    uint8_t Phase;
+
+    for (Index = 0; Index < BOOT_LOG_SIZE; Index++)
+    {
+        BootPtr = Get(Index);
+        if (BootPtr != NULL)
+        {
+            Serial.printf("Boot %lu\r\n", (unsigned long)BootPtr->Number);
+            Previous = 0;
+
+            for (Phase = 0; Phase < phaseMax; Phase++)
+            {
+                /* Replies may arrive out of order, the delta is relative to the latest time printed before. */
+                if (BootPtr->Time[Phase] != TIME_NOT_SET)
+                {
+                    Delta = (BootPtr->Time[Phase] > Previous) ? (BootPtr->Time[Phase] - Previous) : 0;
+                    Serial.printf("  %-18s %6lu ms (+%lu)\r\n", BootLogPhaseName[Phase],
+                        (unsigned long)BootPtr->Time[Phase], (unsigned long)Delta);
+                    Previous += Delta;
+                }
+            }
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ * Store the log in RTC memory so it survives the next reset.
+ */
+void wmcBootLog::Store(void)
+{
+    ESP.rtcUserMemoryWrite(BOOT_LOG_RTC_OFFSET, reinterpret_cast<uint32_t*>(&m_Log), sizeof(m_Log));
+}
@@ -0,0 +1,104 @@
+/**
+ **********************************************************************************************************************
+ * @file  wmc_boot_log.h
+ * @brief Timestamps of the boot phases, kept for the last boots in RTC memory.
+ ***********************************************************************************************************************
+ */
+#ifndef WMC_BOOT_LOG_H
+#define WMC_BOOT_LOG_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * T Y P E D  E F S  /  E N U M
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class wmcBootLog
+{
+public:
+    /**
+     * Boot phases, in order of occurrence.
+     */
+    enum phase
+    {
+        bootStart = 0,   /* Init state entered. */
+        configLoaded,    /* Configuration read from EEPROM. */
+        wifiStart,       /* Wifi connection started. */
+        localInit,       /* Loc library and command line initialized. */
+        wifiScan,        /* Fast connect failed, connect with full scan started. */
+        wifiAssociated,  /* Wifi connected. */
+        udpConnect,      /* UDP connection started. */
+        udpReply,        /* First reply of the control unit. */
+        broadcast,       /* Broadcast flags transmitted. */
+        statusGet,       /* Status requested. */
+        statusReceived,  /* Status received. */
+        locInfoGet,      /* Loc info requested. */
+        locInfoReceived, /* Loc info received. */
+        drivable,        /* Loc can be controlled. */
+        phaseMax
+    };
+
+    static const uint8_t BOOT_LOG_SIZE = 4;          /* Number of boots kept. */
+    static const uint32_t TIME_NOT_SET = 0xFFFFFFFF; /* Phase not reached. */
+
+    /**
+     * Timestamps of one boot in msec after reset.
+     */
+    struct boot
+    {
+        uint32_t Number;
+        uint32_t Time[phaseMax];
+    };
+
+    /**
+     * Constructor.
+     */
+    wmcBootLog();
+
+    /**
+     * Read the log of the previous boots and start a new boot entry.
+     */
+    void Init(void);
+
+    /**
+     * Store the time of a phase, only the first occurrence during a boot is stored.
+     */
+    void Mark(phase Phase);
+
+    /**
+     * Get a boot entry, index 0 is the actual boot. Returns NULL if not present.
+     */
+    const boot* Get(uint8_t Index);
+
+    /**
+     * Print the boot timeline of all kept boots on the serial port.
+     */
+    void Print(void);
+
+private:
+    static const uint32_t BOOT_LOG_MAGIC      = 0x57424C33; /* "WBL3", change when the log layout changes. */
+    static const uint32_t BOOT_LOG_RTC_OFFSET = 32;         /* RTC block, first 128 bytes are used by OTA. */
+
+    /**
+     * Log as stored in RTC memory, which keeps its content over a reset.
+     */
+    struct log
+    {
+        uint32_t Magic;
+        uint32_t Newest;
+        boot Boots[BOOT_LOG_SIZE];
+    };
+
+    void Store(void);
+
+    log m_Log;
+};
+
+#endif
@@ -0,0 +1,237 @@
+/***********************************************************************************************************************
+   @file   wmc_consist.cpp
+   @brief  Consists of locs driven together by the lead loc, each member with its own running direction.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "wmc_consist.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   F O R W A R D  D E C L A R A T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+wmcConsist::wmcConsist()
+{
+    memset(m_Entries, 0, sizeof(m_Entries));
+    memset(&m_Statistics, 0, sizeof(m_Statistics));
+}
+
+/***********************************************************************************************************************
+ */
+bool wmcConsist::MemberAdd(uint16_t Lead, uint16_t Address, bool Flip)
+{
+    bool Result      = false;
+    entry* EntryPtr  = Find(Lead);
+    entry* MemberPtr = MemberOf(Address);
+    uint8_t Index    = 0;
+
+    /* A member can not lead a consist itself and a lead can not be a member. */
+    if ((Lead != 0) && (Address != 0) && (Lead != Address) && (Find(Address) == NULL) && (MemberOf(Lead) == NULL))
+    {
+        if ((MemberPtr != NULL) && (MemberPtr == EntryPtr))
+        {
+            /* Present, update direction. */
+            for (Index = 0; Index < EntryPtr->Members; Index++)
+            {
+                if (EntryPtr->Member[Index].Address == Address)
+                {
+                    EntryPtr->Member[Index].Flip = Flip;
+                }
+            }
+            Result = true;
+        }
+        else if (MemberPtr == NULL)
+        {
+            /* New consist in a free entry. */
+            for (Index = 0; (Index < CONSIST_ENTRIES) && (EntryPtr == NULL); Index++)
+            {
+                if (m_Entries[Index].Lead == 0)
+                {
+                    EntryPtr = &m_Entries[Index];
+                    memset(EntryPtr, 0, sizeof(entry));
+                    EntryPtr->Lead = Lead;
+                }
+            }
+
+            if ((EntryPtr != NULL) && (EntryPtr->Members < CONSIST_MEMBERS_MAX))
+            {
+                EntryPtr->Member[EntryPtr->Members].Address = Address;
+                EntryPtr->Member[EntryPtr->Members].Flip    = Flip;
+                EntryPtr->Members++;
+                Result = true;
+            }
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+void wmcConsist::MemberRemove(uint16_t Lead, uint16_t Address)
+{
+    entry* EntryPtr = Find(Lead);
+    uint8_t Index;
+    bool Found = false;
+
+    if (EntryPtr != NULL)
+    {
+        for (Index = 0; Index < EntryPtr->Members; Index++)
+        {
+            if (EntryPtr->Member[Index].Address == Address)
+            {
+                Found = true;
+            }
+
+            if ((Found == true) && ((Index + 1) < EntryPtr->Members))
+            {
+                EntryPtr->Member[Index] = EntryPtr->Member[Index + 1];
+            }
+        }
+
+        if (Found == true)
+        {
+            EntryPtr->Members--;
+            if (EntryPtr->Members == 0)
+            {
+                EntryPtr->Lead = 0;
+            }
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ */
+void wmcConsist::Remove(uint16_t Lead)
+{
+    entry* EntryPtr = Find(Lead);
+
+    if (EntryPtr != NULL)
+    {
+        memset(EntryPtr, 0, sizeof(entry));
+    }
+}
+
+/***********************************************************************************************************************
+ */
+bool wmcConsist::MemberGet(uint16_t Lead, uint8_t Index, member& Member)
+{
+    bool Result     = false;
+    entry* EntryPtr = Find(Lead);
+
+    if ((EntryPtr != NULL) && (Index < EntryPtr->Members))
+    {
+        Member = EntryPtr->Member[Index];
+        Result = true;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+uint16_t wmcConsist::LeadGet(uint8_t Index)
+{
+    uint16_t Lead = 0;
+
+    if (Index < CONSIST_ENTRIES)
+    {
+        Lead = m_Entries[Index].Lead;
+    }
+
+    return (Lead);
+}
+
+/***********************************************************************************************************************
+ */
+void wmcConsist::FunctionsAllSet(uint16_t Lead, bool FunctionsAll)
+{
+    entry* EntryPtr = Find(Lead);
+
+    if (EntryPtr != NULL)
+    {
+        EntryPtr->FunctionsAll = FunctionsAll;
+    }
+}
+
+/***********************************************************************************************************************
+ */
+bool wmcConsist::FunctionsAll(uint16_t Lead)
+{
+    entry* EntryPtr = Find(Lead);
+
+    return ((EntryPtr != NULL) && (EntryPtr->FunctionsAll == true));
+}
+
+/***********************************************************************************************************************
+ */
+void wmcConsist::DriveCount(uint8_t Members)
+{
+    if (Members > 0)
+    {
+        m_Statistics.Drives++;
+        m_Statistics.Commands += Members;
+    }
+}
+
+/***********************************************************************************************************************
+ */
+void wmcConsist::FunctionCount(uint8_t Members) { m_Statistics.Functions += Members; }
+
+/***********************************************************************************************************************
+ * Find the consist of a lead loc.
+ */
+wmcConsist::entry* wmcConsist::Find(uint16_t Lead)
+{
+    entry* EntryPtr = NULL;
+    uint8_t Index;
+
+    for (Index = 0; (Index < CONSIST_ENTRIES) && (EntryPtr == NULL); Index++)
+    {
+        if ((Lead != 0) && (m_Entries[Index].Lead == Lead))
+        {
+            EntryPtr = &m_Entries[Index];
+        }
+    }
+
+    return (EntryPtr);
+}
+
+/***********************************************************************************************************************
+ * Find the consist a loc is member of.
+ */
+wmcConsist::entry* wmcConsist::MemberOf(uint16_t Address)
+{
+    entry* EntryPtr = NULL;
+    uint8_t Index;
+    uint8_t Member;
+
+    for (Index = 0; (Index < CONSIST_ENTRIES) && (EntryPtr == NULL); Index++)
+    {
+        for (Member = 0; Member < m_Entries[Index].Members; Member++)
+        {
+            if ((m_Entries[Index].Lead != 0) && (m_Entries[Index].Member[Member].Address == Address))
+            {
+                EntryPtr = &m_Entries[Index];
+            }
+        }
+    }
+
+    return (EntryPtr);
+}
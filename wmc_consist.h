@@ -0,0 +1,123 @@
+/**
+ **********************************************************************************************************************
+ * @file  wmc_consist.h
+ * @brief Consists of locs driven together by the lead loc, each member with its own running direction.
+ ***********************************************************************************************************************
+ */
+#ifndef WMC_CONSIST_H
+#define WMC_CONSIST_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * T Y P E D  E F S  /  E N U M
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class wmcConsist
+{
+public:
+    static const uint8_t CONSIST_ENTRIES     = 4; /* Number of consists. */
+    static const uint8_t CONSIST_MEMBERS_MAX = 3; /* Members besides the lead loc. */
+
+    /**
+     * Member of a consist.
+     */
+    struct member
+    {
+        uint16_t Address; /* Address of the member loc. */
+        bool Flip;        /* Member runs in the opposite direction of the lead loc. */
+    };
+
+    /**
+     * Statistics of the consists.
+     */
+    struct statistics
+    {
+        uint32_t Drives;    /* Drive commands of lead locs with members. */
+        uint32_t Commands;  /* Drive commands of members. */
+        uint32_t Functions; /* Function commands of members. */
+    };
+
+    /**
+     * Constructor.
+     */
+    wmcConsist();
+
+    /**
+     * Add a member to the consist of the lead loc, an existing member is updated. Returns false when the consist or
+     * the consist table is full, or the member is already part of a consist with another lead.
+     */
+    bool MemberAdd(uint16_t Lead, uint16_t Address, bool Flip);
+
+    /**
+     * Remove a member from the consist of the lead loc, the consist is removed with its last member.
+     */
+    void MemberRemove(uint16_t Lead, uint16_t Address);
+
+    /**
+     * Remove the consist of the lead loc.
+     */
+    void Remove(uint16_t Lead);
+
+    /**
+     * Get a member of the consist of the lead loc. Returns false when no member with the index is present.
+     */
+    bool MemberGet(uint16_t Lead, uint8_t Index, member& Member);
+
+    /**
+     * Get the lead loc of an entry to store the consists. Returns 0 when the entry is not in use.
+     */
+    uint16_t LeadGet(uint8_t Index);
+
+    /**
+     * Set whether functions of the lead loc are also applied to all members.
+     */
+    void FunctionsAllSet(uint16_t Lead, bool FunctionsAll);
+
+    /**
+     * Check whether functions of the lead loc are also applied to all members.
+     */
+    bool FunctionsAll(uint16_t Lead);
+
+    /**
+     * Count a drive command of a lead loc transmitted to its members.
+     */
+    void DriveCount(uint8_t Members);
+
+    /**
+     * Count a function command of a lead loc transmitted to its members.
+     */
+    void FunctionCount(uint8_t Members);
+
+    /**
+     * Get the statistics.
+     */
+    const statistics& StatisticsGet(void) { return (m_Statistics); }
+
+private:
+    /**
+     * Consist.
+     */
+    struct entry
+    {
+        uint16_t Lead;                      /* Address of lead loc, 0 is unused. */
+        bool FunctionsAll;                  /* Apply functions to all members. */
+        uint8_t Members;                    /* Number of members. */
+        member Member[CONSIST_MEMBERS_MAX]; /* Members. */
+    };
+
+    entry* Find(uint16_t Lead);
+    entry* MemberOf(uint16_t Address);
+
+    entry m_Entries[CONSIST_ENTRIES];
+    statistics m_Statistics;
+};
+
+#endif
@@ -0,0 +1,112 @@
+/***********************************************************************************************************************
+   @file   wmc_eep.cpp
+   @brief  Write back layer on top of the EEPROM with dirty range tracking and batched commit.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "wmc_eep.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   F O R W A R D  D E C L A R A T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+wmcEep::wmcEep()
+{
+    m_DirtyStart    = 1;
+    m_DirtyEnd      = 0;
+    m_LastWriteTime = 0;
+    memset(&m_Statistics, 0, sizeof(m_Statistics));
+}
+
+/***********************************************************************************************************************
+ */
+void wmcEep::Write(int Address, uint8_t Data)
+{
+    if (EEPROM.read(Address) == Data)
+    {
+        m_Statistics.BytesUnchanged++;
+    }
+    else
+    {
+        EEPROM.write(Address, Data);
+        m_Statistics.BytesWritten++;
+        m_LastWriteTime = millis();
+
+        /* Extend dirty range. */
+        if (Dirty() == false)
+        {
+            m_DirtyStart = Address;
+            m_DirtyEnd   = Address;
+        }
+        else if (Address < m_DirtyStart)
+        {
+            m_DirtyStart = Address;
+        }
+        else if (Address > m_DirtyEnd)
+        {
+            m_DirtyEnd = Address;
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ */
+void wmcEep::Write(int Address, const uint8_t* DataPtr, size_t Length)
+{
+    size_t Index;
+
+    for (Index = 0; Index < Length; Index++)
+    {
+        Write(Address + Index, DataPtr[Index]);
+    }
+}
+
+/***********************************************************************************************************************
+ */
+void wmcEep::Commit(void)
+{
+    uint32_t StartTime;
+
+    if (Dirty() == true)
+    {
+        StartTime = micros();
+        EEPROM.commit();
+
+        m_Statistics.CommitTimeLast = micros() - StartTime;
+        if (m_Statistics.CommitTimeLast > m_Statistics.CommitTimeMax)
+        {
+            m_Statistics.CommitTimeMax = m_Statistics.CommitTimeLast;
+        }
+
+        m_Statistics.Commits++;
+        m_Statistics.BytesCommitted += static_cast<uint32_t>(m_DirtyEnd - m_DirtyStart + 1);
+        m_DirtyStart = 1;
+        m_DirtyEnd   = 0;
+    }
+}
+
+/***********************************************************************************************************************
+ */
+void wmcEep::Update(void)
+{
+    if ((Dirty() == true) && ((millis() - m_LastWriteTime) >= EEP_IDLE_COMMIT_TIME))
+    {
+        Commit();
+    }
+}
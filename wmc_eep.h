@@ -0,0 +1,92 @@
+/**
+ **********************************************************************************************************************
+ * @file  wmc_eep.h
+ * @brief Write back layer on top of the EEPROM with dirty range tracking and batched commit.
+ ***********************************************************************************************************************
+ */
+#ifndef WMC_EEP_H
+#define WMC_EEP_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+#include <EEPROM.h>
+
+/***********************************************************************************************************************
+ * T Y P E D  E F S  /  E N U M
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class wmcEep
+{
+public:
+    /**
+     * Statistics of the EEPROM writes.
+     */
+    struct statistics
+    {
+        uint32_t Commits;        /* Number of commits to flash. */
+        uint32_t BytesWritten;   /* Number of changed bytes written. */
+        uint32_t BytesUnchanged; /* Number of bytes not written because the content was equal. */
+        uint32_t BytesCommitted; /* Number of bytes in the dirty ranges of all commits. */
+        uint32_t CommitTimeLast; /* Duration of last commit in usec. */
+        uint32_t CommitTimeMax;  /* Maximum duration of a commit in usec. */
+    };
+
+    /**
+     * Constructor.
+     */
+    wmcEep();
+
+    /**
+     * Write a byte, only changed data marks the EEPROM dirty.
+     */
+    void Write(int Address, uint8_t Data);
+
+    /**
+     * Write a block of data.
+     */
+    void Write(int Address, const uint8_t* DataPtr, size_t Length);
+
+    /**
+     * Write a data type.
+     */
+    template <typename T> void Put(int Address, const T& Data)
+    {
+        Write(Address, reinterpret_cast<const uint8_t*>(&Data), sizeof(T));
+    }
+
+    /**
+     * Commit the dirty data to flash, ends a logical transaction.
+     */
+    void Commit(void);
+
+    /**
+     * Commit the dirty data when no write was done within the idle timeout.
+     */
+    void Update(void);
+
+    /**
+     * Check for data not yet committed.
+     */
+    bool Dirty(void) { return (m_DirtyStart <= m_DirtyEnd); }
+
+    /**
+     * Get the write statistics.
+     */
+    const statistics& StatisticsGet(void) { return (m_Statistics); }
+
+private:
+    static const uint32_t EEP_IDLE_COMMIT_TIME = 2000; /* Time without writes before commit in msec. */
+
+    int m_DirtyStart;
+    int m_DirtyEnd;
+    uint32_t m_LastWriteTime;
+    statistics m_Statistics;
+};
+
+#endif
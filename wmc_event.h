@@ -10,6 +10,8 @@
 /***********************************************************************************************************************
  * I N C L U D E S
  **********************************************************************************************************************/
+#include "Z21Slave.h"
+#include "wmc_timer.h"
 #include <tinyfsm.hpp>
 
 /***********************************************************************************************************************
@@ -114,6 +116,37 @@ struct cliEnterEvent : tinyfsm::Event
 {
 };
 
+/**
+ * Z21 data received event, thrown for each decoded Z21 message.
+ */
+struct z21DataEvent : tinyfsm::Event
+{
+    Z21Slave::dataType Type; /* Type of the received data. */
+};
+
+/**
+ * Power button pressed, thrown on the press instead of the release so a stop is not delayed by the hold time.
+ */
+struct powerButtonEvent : tinyfsm::Event
+{
+    uint32_t PressTime; /* micros() at detection of the press. */
+};
+
+/**
+ * No data received from the control unit for too long, connection lost.
+ */
+struct linkLostEvent : tinyfsm::Event
+{
+};
+
+/**
+ * Timer expired.
+ */
+struct timerEvent : tinyfsm::Event
+{
+    wmcTimer::timer Id; /* Expired timer. */
+};
+
 /**
  * CV programming events from cv module.
  */
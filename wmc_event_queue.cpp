@@ -0,0 +1,170 @@
+/***********************************************************************************************************************
+   @file   wmc_event_queue.cpp
+   @brief  Lock free queue of input events from the pulse switch and button interrupts to the main loop.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "wmc_event_queue.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+
+/* Prevent the compiler and the CPU from moving the data access over the index update. */
+#define WMC_EVENT_QUEUE_BARRIER() __sync_synchronize()
+
+/***********************************************************************************************************************
+   F O R W A R D  D E C L A R A T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+wmcEventQueue::wmcEventQueue()
+{
+    m_Lane.Data         = m_Data;
+    m_Lane.Mask         = EVENT_QUEUE_SIZE - 1;
+    m_Lane.Head         = 0;
+    m_Lane.Tail         = 0;
+    m_LanePriority.Data = m_DataPriority;
+    m_LanePriority.Mask = EVENT_QUEUE_PRIORITY_SIZE - 1;
+    m_LanePriority.Head = 0;
+    m_LanePriority.Tail = 0;
+    memset(&m_Statistics, 0, sizeof(m_Statistics));
+}
+
+/***********************************************************************************************************************
+ */
+bool ICACHE_RAM_ATTR wmcEventQueue::PushPulseSwitch(int8_t Delta, pulseSwitchStatus Status)
+{
+    entry Entry;
+
+    Entry.Type   = pulseSwitch;
+    Entry.Delta  = Delta;
+    Entry.Status = Status;
+    Entry.Button = button_none;
+
+    return (Push(m_Lane, Entry));
+}
+
+/***********************************************************************************************************************
+ */
+bool ICACHE_RAM_ATTR wmcEventQueue::PushButton(pushButtons Button)
+{
+    bool Result;
+    entry Entry;
+
+    Entry.Type   = pushButton;
+    Entry.Delta  = 0;
+    Entry.Status = turn;
+    Entry.Button = Button;
+
+    if (Button == button_power)
+    {
+        Result = Push(m_LanePriority, Entry);
+    }
+    else
+    {
+        Result = Push(m_Lane, Entry);
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+bool ICACHE_RAM_ATTR wmcEventQueue::PushPowerButton(void)
+{
+    entry Entry;
+
+    Entry.Type   = powerButton;
+    Entry.Delta  = 0;
+    Entry.Status = turn;
+    Entry.Button = button_power;
+
+    return (Push(m_LanePriority, Entry));
+}
+
+/***********************************************************************************************************************
+ */
+bool wmcEventQueue::Pop(entry& Entry)
+{
+    bool Result = Pop(m_LanePriority, Entry);
+    uint32_t Latency;
+
+    if (Result == false)
+    {
+        Result = Pop(m_Lane, Entry);
+    }
+
+    if (Result == true)
+    {
+        Latency                  = micros() - Entry.Time;
+        m_Statistics.LatencyLast = Latency;
+        if (Latency > m_Statistics.LatencyMax)
+        {
+            m_Statistics.LatencyMax = Latency;
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Add an event to a lane, when the lane is full the event is dropped so queued events are never overwritten.
+ */
+bool ICACHE_RAM_ATTR wmcEventQueue::Push(lane& Lane, const entry& Entry)
+{
+    bool Result  = false;
+    uint8_t Head = Lane.Head;
+
+    if (static_cast<uint8_t>(Head - Lane.Tail) > Lane.Mask)
+    {
+        m_Statistics.Overflow++;
+    }
+    else
+    {
+        Lane.Data[Head & Lane.Mask]      = Entry;
+        Lane.Data[Head & Lane.Mask].Time = micros();
+        WMC_EVENT_QUEUE_BARRIER();
+        Lane.Head = Head + 1;
+
+        m_Statistics.Queued++;
+        if (&Lane == &m_LanePriority)
+        {
+            m_Statistics.Priority++;
+        }
+        Result = true;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Remove the oldest event of a lane.
+ */
+bool wmcEventQueue::Pop(lane& Lane, entry& Entry)
+{
+    bool Result  = false;
+    uint8_t Tail = Lane.Tail;
+
+    if (Tail != Lane.Head)
+    {
+        WMC_EVENT_QUEUE_BARRIER();
+        Entry = Lane.Data[Tail & Lane.Mask];
+        WMC_EVENT_QUEUE_BARRIER();
+        Lane.Tail = Tail + 1;
+        Result    = true;
+    }
+
+    return (Result);
+}
@@ -0,0 +1,121 @@
+/**
+ **********************************************************************************************************************
+ * @file  wmc_event_queue.h
+ * @brief Lock free queue of input events from the pulse switch and button interrupts to the main loop.
+ ***********************************************************************************************************************
+ */
+#ifndef WMC_EVENT_QUEUE_H
+#define WMC_EVENT_QUEUE_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include "wmc_event.h"
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * T Y P E D  E F S  /  E N U M
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+/**
+ * Single producer / single consumer ring buffers, the producer are the input interrupts which do not nest on the
+ * ESP8266, the consumer is the main loop. Producers in the main loop, like the button sampling, queue with the
+ * interrupts masked. Power events are stored in a separate lane which is always emptied first.
+ */
+class wmcEventQueue
+{
+public:
+    /**
+     * Type of a queued event.
+     */
+    enum type
+    {
+        pulseSwitch = 0,
+        pushButton,
+        powerButton
+    };
+
+    /**
+     * Queued event.
+     */
+    struct entry
+    {
+        type Type;                /* Type of event. */
+        int8_t Delta;             /* Delta of pulse switch. */
+        pulseSwitchStatus Status; /* Status of pulse switch. */
+        pushButtons Button;       /* Pressed button. */
+        uint32_t Time;            /* micros() at queueing. */
+    };
+
+    /**
+     * Statistics of the queue.
+     */
+    struct statistics
+    {
+        uint32_t Queued;      /* Events queued. */
+        uint32_t Priority;    /* Events queued in the priority lane. */
+        uint32_t Overflow;    /* Events dropped because the lane was full. */
+        uint32_t LatencyLast; /* Time between queueing and removing of last event in usec. */
+        uint32_t LatencyMax;  /* Maximum time between queueing and removing in usec. */
+    };
+
+    /**
+     * Constructor.
+     */
+    wmcEventQueue();
+
+    /**
+     * Queue a pulse switch event, interrupt context.
+     */
+    bool PushPulseSwitch(int8_t Delta, pulseSwitchStatus Status);
+
+    /**
+     * Queue a button event, the power button uses the priority lane. Interrupt context.
+     */
+    bool PushButton(pushButtons Button);
+
+    /**
+     * Queue a power button press in the priority lane, interrupt context.
+     */
+    bool PushPowerButton(void);
+
+    /**
+     * Get the oldest event, events in the priority lane first. Main loop context.
+     */
+    bool Pop(entry& Entry);
+
+    /**
+     * Get the statistics.
+     */
+    const statistics& StatisticsGet(void) { return (m_Statistics); }
+
+private:
+    static const uint8_t EVENT_QUEUE_SIZE          = 16; /* Must be a power of two. */
+    static const uint8_t EVENT_QUEUE_PRIORITY_SIZE = 4;  /* Must be a power of two. */
+
+    /**
+     * Ring buffer, head is only written by the producer and tail only by the consumer.
+     */
+    struct lane
+    {
+        entry* Data;
+        uint8_t Mask;
+        volatile uint8_t Head;
+        volatile uint8_t Tail;
+    };
+
+    bool Push(lane& Lane, const entry& Entry);
+    bool Pop(lane& Lane, entry& Entry);
+
+    entry m_Data[EVENT_QUEUE_SIZE];
+    entry m_DataPriority[EVENT_QUEUE_PRIORITY_SIZE];
+    lane m_Lane;
+    lane m_LanePriority;
+    statistics m_Statistics;
+};
+
+#endif
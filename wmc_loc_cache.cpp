@@ -0,0 +1,114 @@
+/***********************************************************************************************************************
+   @file   wmc_loc_cache.cpp
+   @brief  Cache of the last received loc info of each loc address.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "wmc_loc_cache.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   F O R W A R D  D E C L A R A T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+wmcLocCache::wmcLocCache()
+{
+    m_UseCounter = 0;
+    memset(&m_Statistics, 0, sizeof(m_Statistics));
+}
+
+/***********************************************************************************************************************
+ */
+void wmcLocCache::Update(const Z21Slave::locInfo* LocInfoPtr)
+{
+    uint8_t Index  = Find(LocInfoPtr->Address);
+    uint8_t Oldest = 0;
+
+    if (Index == LOC_CACHE_SIZE)
+    {
+        if (m_Statistics.Entries < LOC_CACHE_SIZE)
+        {
+            Index = m_Statistics.Entries;
+            m_Statistics.Entries++;
+        }
+        else
+        {
+            /* Full, replace least recently used entry. */
+            for (Index = 1; Index < LOC_CACHE_SIZE; Index++)
+            {
+                if (m_Entries[Index].LastUsed < m_Entries[Oldest].LastUsed)
+                {
+                    Oldest = Index;
+                }
+            }
+
+            Index = Oldest;
+            m_Statistics.Evictions++;
+        }
+    }
+
+    memcpy(&m_Entries[Index].Info, LocInfoPtr, sizeof(Z21Slave::locInfo));
+    m_UseCounter++;
+    m_Entries[Index].LastUsed = m_UseCounter;
+}
+
+/***********************************************************************************************************************
+ */
+Z21Slave::locInfo* wmcLocCache::Get(uint16_t Address)
+{
+    Z21Slave::locInfo* Result = NULL;
+    uint8_t Index             = Find(Address);
+
+    if (Index < LOC_CACHE_SIZE)
+    {
+        m_UseCounter++;
+        m_Entries[Index].LastUsed = m_UseCounter;
+        m_Statistics.Hits++;
+        Result = &m_Entries[Index].Info;
+    }
+    else
+    {
+        m_Statistics.Misses++;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+const wmcLocCache::statistics& wmcLocCache::StatisticsGet(void) { return (m_Statistics); }
+
+/***********************************************************************************************************************
+ * Find the entry of an address, LOC_CACHE_SIZE when not present.
+ */
+uint8_t wmcLocCache::Find(uint16_t Address)
+{
+    uint8_t Index = 0;
+
+    while ((Index < m_Statistics.Entries) && (m_Entries[Index].Info.Address != Address))
+    {
+        Index++;
+    }
+
+    if (Index == m_Statistics.Entries)
+    {
+        Index = LOC_CACHE_SIZE;
+    }
+
+    return (Index);
+}
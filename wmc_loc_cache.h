@@ -0,0 +1,77 @@
+/**
+ **********************************************************************************************************************
+ * @file  wmc_loc_cache.h
+ * @brief Cache of the last received loc info of each loc address.
+ ***********************************************************************************************************************
+ */
+#ifndef WMC_LOC_CACHE_H
+#define WMC_LOC_CACHE_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include "Z21Slave.h"
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * T Y P E D  E F S  /  E N U M
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class wmcLocCache
+{
+public:
+    /**
+     * Statistics of the cache.
+     */
+    struct statistics
+    {
+        uint32_t Hits;      /* Lookups for which loc info was present. */
+        uint32_t Misses;    /* Lookups for which no loc info was present. */
+        uint32_t Evictions; /* Entries replaced because the cache was full. */
+        uint8_t Entries;    /* Number of used entries. */
+    };
+
+    /**
+     * Constructor.
+     */
+    wmcLocCache();
+
+    /**
+     * Store loc info, replaces the least recently used entry when the address is not present and the cache is full.
+     */
+    void Update(const Z21Slave::locInfo* LocInfoPtr);
+
+    /**
+     * Get the loc info of an address, NULL when not present.
+     */
+    Z21Slave::locInfo* Get(uint16_t Address);
+
+    /**
+     * Get the cache statistics.
+     */
+    const statistics& StatisticsGet(void);
+
+private:
+    static const uint8_t LOC_CACHE_SIZE = 32; /* Number of entries, fixed RAM budget. */
+
+    /**
+     * Cache entry.
+     */
+    struct entry
+    {
+        Z21Slave::locInfo Info; /* Last received loc info. */
+        uint32_t LastUsed;      /* Use counter value of last update or lookup. */
+    };
+
+    uint8_t Find(uint16_t Address);
+
+    entry m_Entries[LOC_CACHE_SIZE];
+    uint32_t m_UseCounter;
+    statistics m_Statistics;
+};
+
+#endif
@@ -0,0 +1,86 @@
+/***********************************************************************************************************************
+   @file   wmc_loc_import.cpp
+   @brief  Staging of loc library data received from the control, kept sorted by address.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "wmc_loc_import.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   F O R W A R D  D E C L A R A T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+wmcLocImport::wmcLocImport() { Clear(); }
+
+/***********************************************************************************************************************
+ */
+void wmcLocImport::Clear(void)
+{
+    m_Count = 0;
+}
+
+/***********************************************************************************************************************
+ */
+bool wmcLocImport::Add(uint16_t Address, const char* NamePtr)
+{
+    bool Result  = true;
+    uint8_t Low  = 0;
+    uint8_t High = m_Count;
+    uint8_t Middle;
+
+    /* Binary search for the position of the address. */
+    while (Low < High)
+    {
+        Middle = Low + ((High - Low) / 2);
+        if (m_Data[Middle].Address < Address)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            High = Middle;
+        }
+    }
+
+    if ((Low < m_Count) && (m_Data[Low].Address == Address))
+    {
+        /* Already staged, only update name. */
+    }
+    else if (m_Count >= LOC_IMPORT_SIZE)
+    {
+        Result = false;
+    }
+    else
+    {
+        memmove(&m_Data[Low + 1], &m_Data[Low], (m_Count - Low) * sizeof(m_Data[0]));
+        m_Data[Low].Address = Address;
+        m_Count++;
+    }
+
+    if (Result == true)
+    {
+        memset(m_Data[Low].Name, '\0', LOC_IMPORT_NAME_SIZE);
+        if (NamePtr != NULL)
+        {
+            strncpy(m_Data[Low].Name, NamePtr, LOC_IMPORT_NAME_SIZE - 1);
+        }
+    }
+
+    return (Result);
+}
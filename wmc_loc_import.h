@@ -0,0 +1,69 @@
+/**
+ **********************************************************************************************************************
+ * @file  wmc_loc_import.h
+ * @brief Staging of loc library data received from the control, kept sorted by address.
+ ***********************************************************************************************************************
+ */
+#ifndef WMC_LOC_IMPORT_H
+#define WMC_LOC_IMPORT_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * T Y P E D  E F S  /  E N U M
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class wmcLocImport
+{
+public:
+    static const uint8_t LOC_IMPORT_NAME_SIZE = 16;
+
+    /**
+     * Staged loc.
+     */
+    struct locData
+    {
+        uint16_t Address;                /* Address of the loc. */
+        char Name[LOC_IMPORT_NAME_SIZE]; /* Name of the loc. */
+    };
+
+    /**
+     * Constructor.
+     */
+    wmcLocImport();
+
+    /**
+     * Remove all staged data.
+     */
+    void Clear(void);
+
+    /**
+     * Stage a loc at its sorted position, a loc already staged is replaced. Returns false when no room is left.
+     */
+    bool Add(uint16_t Address, const char* NamePtr);
+
+    /**
+     * Get staged loc by index, staged locs are sorted by address.
+     */
+    locData* Get(uint8_t Index) { return (&m_Data[Index]); }
+
+    /**
+     * Number of staged locs.
+     */
+    uint8_t Count(void) { return (m_Count); }
+
+private:
+    static const uint8_t LOC_IMPORT_SIZE = 128;
+
+    locData m_Data[LOC_IMPORT_SIZE];
+    uint8_t m_Count;
+};
+
+#endif
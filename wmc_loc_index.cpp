@@ -0,0 +1,139 @@
+/***********************************************************************************************************************
+   @file   wmc_loc_index.cpp
+   @brief  Sorted index of the loc addresses present in the loc library.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "wmc_loc_index.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   F O R W A R D  D E C L A R A T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+wmcLocIndex::wmcLocIndex()
+{
+    m_Count         = 0;
+    m_Valid         = false;
+    m_LibrarySorted = false;
+}
+
+/***********************************************************************************************************************
+ */
+void wmcLocIndex::Build(LocLib& locLib)
+{
+    uint8_t Index            = 0;
+    uint8_t NumberOfLocs     = locLib.GetNumberOfLocs();
+    uint16_t AddressPrevious = 0;
+    LocLibData* LocDataPtr;
+
+    m_Count         = 0;
+    m_Valid         = true;
+    m_LibrarySorted = true;
+
+    for (Index = 0; Index < NumberOfLocs; Index++)
+    {
+        LocDataPtr = locLib.LocGetAllDataByIndex(Index);
+
+        if (LocDataPtr->Addres < AddressPrevious)
+        {
+            m_LibrarySorted = false;
+        }
+        AddressPrevious = LocDataPtr->Addres;
+
+        Insert(LocDataPtr->Addres);
+    }
+}
+
+/***********************************************************************************************************************
+ */
+uint8_t wmcLocIndex::Find(uint16_t Address)
+{
+    uint8_t Position = LowerBound(Address);
+
+    if ((Position >= m_Count) || (m_Address[Position] != Address))
+    {
+        Position = NOT_FOUND;
+    }
+
+    return (Position);
+}
+
+/***********************************************************************************************************************
+ */
+uint8_t wmcLocIndex::Insert(uint16_t Address)
+{
+    uint8_t Position = LowerBound(Address);
+
+    if ((Position < m_Count) && (m_Address[Position] == Address))
+    {
+        /* Already present. */
+    }
+    else if (m_Count >= LOC_INDEX_SIZE)
+    {
+        /* Index can not hold all locs anymore. */
+        Position = NOT_FOUND;
+        m_Valid  = false;
+    }
+    else
+    {
+        memmove(&m_Address[Position + 1], &m_Address[Position], (m_Count - Position) * sizeof(m_Address[0]));
+        m_Address[Position] = Address;
+        m_Count++;
+    }
+
+    return (Position);
+}
+
+/***********************************************************************************************************************
+ */
+void wmcLocIndex::Remove(uint16_t Address)
+{
+    uint8_t Position = Find(Address);
+
+    if (Position != NOT_FOUND)
+    {
+        m_Count--;
+        memmove(&m_Address[Position], &m_Address[Position + 1], (m_Count - Position) * sizeof(m_Address[0]));
+    }
+}
+
+/***********************************************************************************************************************
+ * Get the first position with an address equal or larger than the requested address.
+ */
+uint8_t wmcLocIndex::LowerBound(uint16_t Address)
+{
+    uint8_t Low  = 0;
+    uint8_t High = m_Count;
+    uint8_t Middle;
+
+    while (Low < High)
+    {
+        Middle = Low + ((High - Low) / 2);
+        if (m_Address[Middle] < Address)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            High = Middle;
+        }
+    }
+
+    return (Low);
+}
@@ -0,0 +1,86 @@
+/**
+ **********************************************************************************************************************
+ * @file  wmc_loc_index.h
+ * @brief Sorted index of the loc addresses present in the loc library.
+ ***********************************************************************************************************************
+ */
+#ifndef WMC_LOC_INDEX_H
+#define WMC_LOC_INDEX_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include "Loclib.h"
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * T Y P E D  E F S  /  E N U M
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class wmcLocIndex
+{
+public:
+    static const uint8_t NOT_FOUND = 255;
+
+    /**
+     * Constructor.
+     */
+    wmcLocIndex();
+
+    /**
+     * Build the index from the loc library and check whether the loc library itself is sorted.
+     */
+    void Build(LocLib& locLib);
+
+    /**
+     * Binary search for an address, returns position in the index or NOT_FOUND.
+     */
+    uint8_t Find(uint16_t Address);
+
+    /**
+     * Insert an address at its sorted position, returns the position or NOT_FOUND and invalidates the index when the
+     * index is full.
+     */
+    uint8_t Insert(uint16_t Address);
+
+    /**
+     * Remove an address.
+     */
+    void Remove(uint16_t Address);
+
+    /**
+     * Index valid, false when more locs are present than the index can hold.
+     */
+    bool Valid(void) { return (m_Valid); }
+
+    /**
+     * Loc library is known to be sorted by address.
+     */
+    bool LibrarySorted(void) { return (m_LibrarySorted); }
+
+    /**
+     * Set sort status of the loc library.
+     */
+    void LibrarySortedSet(bool Sorted) { m_LibrarySorted = Sorted; }
+
+    /**
+     * Number of addresses in the index.
+     */
+    uint8_t Count(void) { return (m_Count); }
+
+private:
+    static const uint8_t LOC_INDEX_SIZE = 128;
+
+    uint8_t LowerBound(uint16_t Address);
+
+    uint16_t m_Address[LOC_INDEX_SIZE];
+    uint8_t m_Count;
+    bool m_Valid;
+    bool m_LibrarySorted;
+};
+
+#endif
@@ -0,0 +1,140 @@
+/***********************************************************************************************************************
+   @file   wmc_pulse_accel.cpp
+   @brief  Velocity dependent acceleration of pulse switch turns, so large changes need less turning.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "wmc_pulse_accel.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   F O R W A R D  D E C L A R A T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+
+/* Default profiles, speed with 128 steps in about 32 fast detents, addresses up to 9999 in about 100 fast detents. */
+static const wmcPulseAccel::config wmcPulseAccelDefault[wmcPulseAccel::profileMax] = {
+    { 80, 20, 4 },    /* profileSpeed */
+    { 100, 15, 100 }, /* profileTurnoutAddress */
+    { 100, 15, 100 }, /* profileLocAddress */
+};
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+wmcPulseAccel::wmcPulseAccel()
+{
+    memcpy(m_Config, wmcPulseAccelDefault, sizeof(m_Config));
+    m_Profile   = profileSpeed;
+    m_Direction = 0;
+    m_Time      = 0;
+    m_Interval  = 0;
+    memset(&m_Statistics, 0, sizeof(m_Statistics));
+}
+
+/***********************************************************************************************************************
+ */
+void wmcPulseAccel::ProfileSet(profile Id, const config& Config)
+{
+    if ((Id < profileMax) && (Config.SlowInterval > Config.FastInterval) && (Config.FactorMax > 0))
+    {
+        m_Config[Id] = Config;
+    }
+}
+
+/***********************************************************************************************************************
+ */
+int16_t wmcPulseAccel::Apply(profile Id, int8_t Delta)
+{
+    uint32_t Now = millis();
+    uint32_t Detents;
+    uint32_t Fraction;
+    uint32_t Factor  = 1;
+    int8_t Direction = (Delta > 0) ? 1 : -1;
+    const config* Cfg;
+
+    if ((Delta != 0) && (Id < profileMax))
+    {
+        Cfg     = &m_Config[Id];
+        Detents = (Delta > 0) ? Delta : -Delta;
+
+        /* A turn in another context, the other direction or after a pause starts without acceleration. */
+        if ((Id != m_Profile) || (Direction != m_Direction) || ((Now - m_Time) >= Cfg->SlowInterval))
+        {
+            m_Interval = Cfg->SlowInterval;
+        }
+        else
+        {
+            /* Several detents in one event means faster turning, filter so a single fast detent does not jump. */
+            m_Interval = ((m_Interval * 3) + ((Now - m_Time) / Detents)) / 4;
+        }
+
+        m_Profile   = Id;
+        m_Direction = Direction;
+        m_Time      = Now;
+
+        if (m_Interval <= Cfg->FastInterval)
+        {
+            Factor = Cfg->FactorMax;
+        }
+        else if (m_Interval < Cfg->SlowInterval)
+        {
+            Fraction = ((Cfg->SlowInterval - m_Interval) * PULSE_ACCEL_FRACTION)
+                / (Cfg->SlowInterval - Cfg->FastInterval);
+            Factor = 1 + (((Cfg->FactorMax - 1) * Fraction * Fraction) / (PULSE_ACCEL_FRACTION * PULSE_ACCEL_FRACTION));
+        }
+
+        m_Statistics.Events++;
+        m_Statistics.Detents += Detents;
+        m_Statistics.Steps += Detents * Factor;
+        if (Factor > 1)
+        {
+            m_Statistics.Accelerated++;
+        }
+    }
+
+    return (static_cast<int16_t>(Delta * static_cast<int16_t>(Factor)));
+}
+
+/***********************************************************************************************************************
+ */
+uint16_t wmcPulseAccel::Step(uint16_t Value, int16_t Delta, uint16_t Min, uint16_t Max)
+{
+    int32_t Result = static_cast<int32_t>(Value) + Delta;
+
+    if (Delta > 0)
+    {
+        if (Value >= Max)
+        {
+            Result = Min;
+        }
+        else if (Result > Max)
+        {
+            Result = Max;
+        }
+    }
+    else if (Delta < 0)
+    {
+        if (Value <= Min)
+        {
+            Result = Max;
+        }
+        else if (Result < Min)
+        {
+            Result = Min;
+        }
+    }
+
+    return (static_cast<uint16_t>(Result));
+}
@@ -0,0 +1,96 @@
+/**
+ **********************************************************************************************************************
+ * @file  wmc_pulse_accel.h
+ * @brief Velocity dependent acceleration of pulse switch turns, so large changes need less turning.
+ ***********************************************************************************************************************
+ */
+#ifndef WMC_PULSE_ACCEL_H
+#define WMC_PULSE_ACCEL_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * T Y P E D  E F S  /  E N U M
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class wmcPulseAccel
+{
+public:
+    /**
+     * Context of the pulse switch, each context has its own acceleration profile.
+     */
+    enum profile
+    {
+        profileSpeed = 0,
+        profileTurnoutAddress,
+        profileLocAddress,
+        profileMax
+    };
+
+    /**
+     * Acceleration profile. Turning slower than the slow interval per detent gives one step per detent, turning at
+     * the fast interval or faster gives the maximum factor, in between the factor rises quadratic.
+     */
+    struct config
+    {
+        uint16_t SlowInterval; /* Time between detents without acceleration in msec. */
+        uint16_t FastInterval; /* Time between detents with maximum acceleration in msec. */
+        uint8_t FactorMax;     /* Maximum number of steps per detent. */
+    };
+
+    /**
+     * Statistics of the acceleration.
+     */
+    struct statistics
+    {
+        uint32_t Events;      /* Pulse switch turn events. */
+        uint32_t Detents;     /* Detents turned. */
+        uint32_t Steps;       /* Steps after acceleration, Steps - Detents is the turning saved. */
+        uint32_t Accelerated; /* Events with a factor above one. */
+    };
+
+    /**
+     * Constructor, sets the default profiles.
+     */
+    wmcPulseAccel();
+
+    /**
+     * Change the profile of a context.
+     */
+    void ProfileSet(profile Id, const config& Config);
+
+    /**
+     * Get the accelerated delta of a pulse switch turn.
+     */
+    int16_t Apply(profile Id, int8_t Delta);
+
+    /**
+     * Add a delta to a value within min and max. An accelerated delta stops at the limit, a value already at the
+     * limit wraps around like a single step.
+     */
+    static uint16_t Step(uint16_t Value, int16_t Delta, uint16_t Min, uint16_t Max);
+
+    /**
+     * Get the statistics.
+     */
+    const statistics& StatisticsGet(void) { return (m_Statistics); }
+
+private:
+    static const uint16_t PULSE_ACCEL_FRACTION = 256; /* Fixed point one of the interpolation. */
+
+    config m_Config[profileMax];
+    profile m_Profile;   /* Context of the previous turn. */
+    int8_t m_Direction;  /* Direction of the previous turn. */
+    uint32_t m_Time;     /* millis() of the previous turn. */
+    uint32_t m_Interval; /* Filtered time between detents in msec. */
+    statistics m_Statistics;
+};
+
+#endif
@@ -0,0 +1,329 @@
+/***********************************************************************************************************************
+   @file   wmc_speed_ramp.cpp
+   @brief  Per loc acceleration and braking ramps, the speed is moved in fixed point towards the requested speed.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "wmc_speed_ramp.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   F O R W A R D  D E C L A R A T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+wmcSpeedRamp::wmcSpeedRamp()
+{
+    memset(m_Entries, 0, sizeof(m_Entries));
+    memset(&m_Statistics, 0, sizeof(m_Statistics));
+}
+
+/***********************************************************************************************************************
+ */
+bool wmcSpeedRamp::ConfigSet(uint16_t Address, const config& Config)
+{
+    bool Result     = false;
+    entry* EntryPtr = Find(Address);
+    uint8_t Index;
+
+    if ((Config.Accelerate == 0) && (Config.Brake == 0))
+    {
+        /* No rates, release the entry. */
+        if (EntryPtr != NULL)
+        {
+            EntryPtr->Used    = false;
+            EntryPtr->Active  = false;
+            EntryPtr->Changed = false;
+        }
+        Result = true;
+    }
+    else
+    {
+        for (Index = 0; (Index < SPEED_RAMP_ENTRIES) && (EntryPtr == NULL); Index++)
+        {
+            if (m_Entries[Index].Used == false)
+            {
+                EntryPtr = &m_Entries[Index];
+                memset(EntryPtr, 0, sizeof(entry));
+                EntryPtr->Used            = true;
+                EntryPtr->LocInfo.Address = Address;
+            }
+        }
+
+        if (EntryPtr != NULL)
+        {
+            EntryPtr->Config = Config;
+            Result           = true;
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+void wmcSpeedRamp::ConfigGet(uint16_t Address, config& Config)
+{
+    entry* EntryPtr = Find(Address);
+
+    if (EntryPtr != NULL)
+    {
+        Config = EntryPtr->Config;
+    }
+    else
+    {
+        Config.Accelerate = 0;
+        Config.Brake      = 0;
+    }
+}
+
+/***********************************************************************************************************************
+ */
+bool wmcSpeedRamp::ConfigIndexGet(uint8_t Index, uint16_t& Address, config& Config)
+{
+    bool Result = false;
+
+    if ((Index < SPEED_RAMP_ENTRIES) && (m_Entries[Index].Used == true))
+    {
+        Address = m_Entries[Index].LocInfo.Address;
+        Config  = m_Entries[Index].Config;
+        Result  = true;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+bool wmcSpeedRamp::Target(const Z21Slave::locInfo& LocInfo, const Z21Slave::locInfo* ActualPtr)
+{
+    bool Result     = false;
+    entry* EntryPtr = Find(LocInfo.Address);
+
+    if (EntryPtr != NULL)
+    {
+        if (EntryPtr->Active == false)
+        {
+            /* Start from the actual speed, when unknown the first update transmits the requested speed directly. */
+            if (ActualPtr != NULL)
+            {
+                EntryPtr->Speed     = static_cast<uint32_t>(ActualPtr->Speed) * SPEED_RAMP_ONE;
+                EntryPtr->Direction = ActualPtr->Direction;
+            }
+            else
+            {
+                EntryPtr->Speed     = static_cast<uint32_t>(LocInfo.Speed) * SPEED_RAMP_ONE;
+                EntryPtr->Direction = LocInfo.Direction;
+            }
+
+            EntryPtr->Active   = true;
+            EntryPtr->Changed  = (ActualPtr == NULL);
+            EntryPtr->LastTime = millis();
+            m_Statistics.Ramps++;
+        }
+        else
+        {
+            m_Statistics.Targets++;
+        }
+
+        EntryPtr->LocInfo = LocInfo;
+        Result            = true;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+bool wmcSpeedRamp::Active(uint16_t Address)
+{
+    entry* EntryPtr = Find(Address);
+
+    return ((EntryPtr != NULL) && (EntryPtr->Active == true));
+}
+
+/***********************************************************************************************************************
+ */
+bool wmcSpeedRamp::Active(void)
+{
+    bool Result = false;
+    uint8_t Index;
+
+    for (Index = 0; Index < SPEED_RAMP_ENTRIES; Index++)
+    {
+        if ((m_Entries[Index].Active == true) || (m_Entries[Index].Changed == true))
+        {
+            Result = true;
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+void wmcSpeedRamp::Stop(uint16_t Address)
+{
+    entry* EntryPtr = Find(Address);
+
+    if ((EntryPtr != NULL) && (EntryPtr->Active == true))
+    {
+        EntryPtr->Active  = false;
+        EntryPtr->Changed = false;
+        m_Statistics.Stopped++;
+    }
+}
+
+/***********************************************************************************************************************
+ */
+void wmcSpeedRamp::StopAll(void)
+{
+    uint8_t Index;
+
+    for (Index = 0; Index < SPEED_RAMP_ENTRIES; Index++)
+    {
+        Stop(m_Entries[Index].LocInfo.Address);
+    }
+}
+
+/***********************************************************************************************************************
+ */
+void wmcSpeedRamp::Update(void)
+{
+    uint32_t Now = millis();
+    uint32_t Elapsed;
+    uint32_t Step;
+    uint32_t Goal;
+    uint8_t Index;
+    entry* EntryPtr;
+
+    for (Index = 0; Index < SPEED_RAMP_ENTRIES; Index++)
+    {
+        EntryPtr = &m_Entries[Index];
+        if (EntryPtr->Active == true)
+        {
+            Elapsed            = Now - EntryPtr->LastTime;
+            EntryPtr->LastTime = Now;
+            Step               = EntryPtr->Speed / SPEED_RAMP_ONE;
+
+            if (EntryPtr->Direction != EntryPtr->LocInfo.Direction)
+            {
+                /* Brake to zero before changing direction. */
+                if (Move(EntryPtr, 0, EntryPtr->Config.Brake, Elapsed) == true)
+                {
+                    EntryPtr->Direction = EntryPtr->LocInfo.Direction;
+                    EntryPtr->Changed   = true;
+                }
+            }
+            else
+            {
+                Goal = static_cast<uint32_t>(EntryPtr->LocInfo.Speed) * SPEED_RAMP_ONE;
+                if (Goal >= EntryPtr->Speed)
+                {
+                    Move(EntryPtr, Goal, EntryPtr->Config.Accelerate, Elapsed);
+                }
+                else
+                {
+                    Move(EntryPtr, Goal, EntryPtr->Config.Brake, Elapsed);
+                }
+
+                if (EntryPtr->Speed == Goal)
+                {
+                    EntryPtr->Active = false;
+                }
+            }
+
+            if ((EntryPtr->Speed / SPEED_RAMP_ONE) != Step)
+            {
+                EntryPtr->Changed = true;
+            }
+            else if (EntryPtr->Changed == false)
+            {
+                m_Statistics.Updates++;
+            }
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ */
+bool wmcSpeedRamp::TransmitGet(Z21Slave::locInfo& LocInfo)
+{
+    bool Result = false;
+    uint8_t Index;
+    entry* EntryPtr;
+
+    for (Index = 0; (Index < SPEED_RAMP_ENTRIES) && (Result == false); Index++)
+    {
+        EntryPtr = &m_Entries[Index];
+        if (EntryPtr->Changed == true)
+        {
+            EntryPtr->Changed = false;
+
+            LocInfo           = EntryPtr->LocInfo;
+            LocInfo.Speed     = static_cast<uint8_t>(EntryPtr->Speed / SPEED_RAMP_ONE);
+            LocInfo.Direction = EntryPtr->Direction;
+            m_Statistics.Commands++;
+            Result = true;
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Find the entry of a loc.
+ */
+wmcSpeedRamp::entry* wmcSpeedRamp::Find(uint16_t Address)
+{
+    entry* EntryPtr = NULL;
+    uint8_t Index;
+
+    for (Index = 0; (Index < SPEED_RAMP_ENTRIES) && (EntryPtr == NULL); Index++)
+    {
+        if ((m_Entries[Index].Used == true) && (m_Entries[Index].LocInfo.Address == Address))
+        {
+            EntryPtr = &m_Entries[Index];
+        }
+    }
+
+    return (EntryPtr);
+}
+
+/***********************************************************************************************************************
+ * Move the speed towards the goal with the rate, a rate of zero reaches the goal immediately. Returns true when the
+ * goal is reached.
+ */
+bool wmcSpeedRamp::Move(entry* EntryPtr, uint32_t Goal, uint16_t Rate, uint32_t Elapsed)
+{
+    uint32_t Delta = (static_cast<uint32_t>(Rate) * Elapsed) / 1000;
+
+    if ((Rate == 0) || (Delta >= ((EntryPtr->Speed > Goal) ? (EntryPtr->Speed - Goal) : (Goal - EntryPtr->Speed))))
+    {
+        EntryPtr->Speed = Goal;
+    }
+    else if (EntryPtr->Speed < Goal)
+    {
+        EntryPtr->Speed += Delta;
+    }
+    else
+    {
+        EntryPtr->Speed -= Delta;
+    }
+
+    return (EntryPtr->Speed == Goal);
+}
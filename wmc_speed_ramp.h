@@ -0,0 +1,136 @@
+/**
+ **********************************************************************************************************************
+ * @file  wmc_speed_ramp.h
+ * @brief Per loc acceleration and braking ramps, the speed is moved in fixed point towards the requested speed.
+ ***********************************************************************************************************************
+ */
+#ifndef WMC_SPEED_RAMP_H
+#define WMC_SPEED_RAMP_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include "Z21Slave.h"
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * T Y P E D  E F S  /  E N U M
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class wmcSpeedRamp
+{
+public:
+    static const uint16_t SPEED_RAMP_ONE    = 256; /* Fixed point one speed step. */
+    static const uint8_t SPEED_RAMP_ENTRIES = 8;   /* Number of locs with rates. */
+
+    /**
+     * Ramp rates of a loc in speed steps per second as 8.8 fixed point, 0 changes the speed immediately.
+     */
+    struct config
+    {
+        uint16_t Accelerate; /* Speed increase per second. */
+        uint16_t Brake;      /* Speed decrease per second. */
+    };
+
+    /**
+     * Statistics of the ramps.
+     */
+    struct statistics
+    {
+        uint32_t Ramps;    /* Ramps started. */
+        uint32_t Targets;  /* Requested speeds taken over by a running ramp. */
+        uint32_t Commands; /* Drive commands of ramps. */
+        uint32_t Updates;  /* Ramp updates without a changed speed step, no drive command needed. */
+        uint32_t Stopped;  /* Ramps ended by a stop or power off. */
+    };
+
+    /**
+     * Constructor.
+     */
+    wmcSpeedRamp();
+
+    /**
+     * Set the rates of a loc. Returns false when all entries are in use by other locs.
+     */
+    bool ConfigSet(uint16_t Address, const config& Config);
+
+    /**
+     * Get the rates of a loc, zero rates when the loc has none.
+     */
+    void ConfigGet(uint16_t Address, config& Config);
+
+    /**
+     * Get the loc and rates of an entry to store them. Returns false when the entry is not in use.
+     */
+    bool ConfigIndexGet(uint8_t Index, uint16_t& Address, config& Config);
+
+    /**
+     * Request a speed. When the loc has rates the ramp is started or updated and true is returned, the actual speed
+     * is the start of a new ramp, NULL when unknown. Returns false when the speed must be transmitted directly.
+     */
+    bool Target(const Z21Slave::locInfo& LocInfo, const Z21Slave::locInfo* ActualPtr);
+
+    /**
+     * Check whether a ramp of a loc is running.
+     */
+    bool Active(uint16_t Address);
+
+    /**
+     * Check whether any ramp is running.
+     */
+    bool Active(void);
+
+    /**
+     * End the ramp of a loc, e.g. for a direct stop.
+     */
+    void Stop(uint16_t Address);
+
+    /**
+     * End all ramps, e.g. at track power off.
+     */
+    void StopAll(void);
+
+    /**
+     * Move all running ramps according the time passed since the previous update.
+     */
+    void Update(void);
+
+    /**
+     * Get a drive command for a ramp of which the speed step changed in the last update. Returns false when no drive
+     * command is needed.
+     */
+    bool TransmitGet(Z21Slave::locInfo& LocInfo);
+
+    /**
+     * Get the statistics.
+     */
+    const statistics& StatisticsGet(void) { return (m_Statistics); }
+
+private:
+    /**
+     * Rates and ramp of a loc.
+     */
+    struct entry
+    {
+        bool Used;
+        bool Active;
+        bool Changed;                     /* Speed step changed, drive command needed. */
+        config Config;                    /* Rates of the loc. */
+        Z21Slave::locInfo LocInfo;        /* Requested speed and direction. */
+        Z21Slave::locDirection Direction; /* Actual direction. */
+        uint32_t Speed;                   /* Actual speed as 8.8 fixed point. */
+        uint32_t LastTime;                /* millis() of the previous update. */
+    };
+
+    entry* Find(uint16_t Address);
+    bool Move(entry* EntryPtr, uint32_t Goal, uint16_t Rate, uint32_t Elapsed);
+
+    entry m_Entries[SPEED_RAMP_ENTRIES];
+    statistics m_Statistics;
+};
+
+#endif
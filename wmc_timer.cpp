@@ -0,0 +1,140 @@
+/***********************************************************************************************************************
+   @file   wmc_timer.cpp
+   @brief  Deadline based timers, kept sorted on deadline so only the first timer must be checked.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "wmc_timer.h"
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   F O R W A R D  D E C L A R A T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+wmcTimer::wmcTimer()
+{
+    memset(m_Deadline, 0, sizeof(m_Deadline));
+    memset(m_Order, 0, sizeof(m_Order));
+    m_Armed = 0;
+    memset(&m_Statistics, 0, sizeof(m_Statistics));
+}
+
+/***********************************************************************************************************************
+ */
+void wmcTimer::Start(timer Id, uint32_t Delay)
+{
+    uint8_t Position;
+
+    Remove(Id);
+    m_Deadline[Id] = millis() + Delay;
+
+    /* Insert sorted, deadlines are compared relative to each other to handle the millis() wrap around. */
+    Position = m_Armed;
+    while ((Position > 0) && (static_cast<int32_t>(m_Deadline[m_Order[Position - 1]] - m_Deadline[Id]) > 0))
+    {
+        m_Order[Position] = m_Order[Position - 1];
+        Position--;
+    }
+
+    m_Order[Position] = Id;
+    m_Armed++;
+    m_Statistics.Started++;
+}
+
+/***********************************************************************************************************************
+ */
+void wmcTimer::Stop(timer Id)
+{
+    if (Active(Id) == true)
+    {
+        Remove(Id);
+        m_Statistics.Stopped++;
+    }
+}
+
+/***********************************************************************************************************************
+ */
+bool wmcTimer::Active(timer Id)
+{
+    bool Result = false;
+    uint8_t Index;
+
+    for (Index = 0; Index < m_Armed; Index++)
+    {
+        if (m_Order[Index] == Id)
+        {
+            Result = true;
+            break;
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+bool wmcTimer::Expired(timer& Id)
+{
+    bool Result = false;
+    uint32_t Late;
+
+    if (Due() == true)
+    {
+        Id   = static_cast<timer>(m_Order[0]);
+        Late = millis() - m_Deadline[Id];
+        Remove(Id);
+
+        m_Statistics.Expired++;
+        m_Statistics.LateLast = Late;
+        if (Late > m_Statistics.LateMax)
+        {
+            m_Statistics.LateMax = Late;
+        }
+
+        Result = true;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Remove a timer from the sorted list when armed.
+ */
+void wmcTimer::Remove(timer Id)
+{
+    uint8_t Index;
+    bool Found = false;
+
+    for (Index = 0; Index < m_Armed; Index++)
+    {
+        if (m_Order[Index] == Id)
+        {
+            Found = true;
+        }
+
+        if ((Found == true) && ((Index + 1) < m_Armed))
+        {
+            m_Order[Index] = m_Order[Index + 1];
+        }
+    }
+
+    if (Found == true)
+    {
+        m_Armed--;
+    }
+}
@@ -0,0 +1,97 @@
+/**
+ **********************************************************************************************************************
+ * @file  wmc_timer.h
+ * @brief Deadline based timers, kept sorted on deadline so only the first timer must be checked.
+ ***********************************************************************************************************************
+ */
+#ifndef WMC_TIMER_H
+#define WMC_TIMER_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * T Y P E D  E F S  /  E N U M
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+
+class wmcTimer
+{
+public:
+    /**
+     * Timers, each timer can be armed once.
+     */
+    enum timer
+    {
+        turnoutOff = 0,  /* Switch off the turnout output. */
+        locSelectStable, /* Loc selection by the pulse switch is stable. */
+        locImportCommit, /* No more loc library data received, store the data. */
+        speedRamp,       /* Update the speed ramps. */
+        wifiPoll,        /* Poll the wifi connection status. */
+        locDbTransmit,   /* Transmit the next window of loc library data. */
+        timerMax
+    };
+
+    /**
+     * Statistics of the timers.
+     */
+    struct statistics
+    {
+        uint32_t Started;  /* Timers armed. */
+        uint32_t Expired;  /* Timers expired. */
+        uint32_t Stopped;  /* Armed timers stopped before expiry. */
+        uint32_t LateLast; /* Time between deadline and expiry check of last expired timer in msec. */
+        uint32_t LateMax;  /* Maximum time between deadline and expiry check in msec. */
+    };
+
+    /**
+     * Constructor.
+     */
+    wmcTimer();
+
+    /**
+     * Arm a timer to expire after the delay, an armed timer is restarted.
+     */
+    void Start(timer Id, uint32_t Delay);
+
+    /**
+     * Stop a timer.
+     */
+    void Stop(timer Id);
+
+    /**
+     * Check whether a timer is armed.
+     */
+    bool Active(timer Id);
+
+    /**
+     * Check whether the first deadline passed. Inline, so the 5 msec update can check at the cost of one compare.
+     */
+    bool Due(void) { return ((m_Armed > 0) && (static_cast<int32_t>(millis() - m_Deadline[m_Order[0]]) >= 0)); }
+
+    /**
+     * Get and disarm the first expired timer. Returns false when no timer expired, only the first deadline is
+     * compared.
+     */
+    bool Expired(timer& Id);
+
+    /**
+     * Get the statistics.
+     */
+    const statistics& StatisticsGet(void) { return (m_Statistics); }
+
+private:
+    void Remove(timer Id);
+
+    uint32_t m_Deadline[timerMax]; /* Deadline of each timer. */
+    uint8_t m_Order[timerMax];     /* Armed timers, earliest deadline first. */
+    uint8_t m_Armed;               /* Number of armed timers. */
+    statistics m_Statistics;
+};
+
+#endif